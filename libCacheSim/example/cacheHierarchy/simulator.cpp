@@ -64,7 +64,8 @@ void Simulator::output_mrc(string &algo, vector<uint64_t> cache_sizes,
 
   auto mrc = simulate_at_multi_sizes(reader, cache, cache_sizes.size(),
                                      cache_size_array, nullptr, 0, 0,
-                                     std::thread::hardware_concurrency());
+                                     std::thread::hardware_concurrency(),
+                                     nullptr);
 
   std::ofstream mrc_ofs(mrc_output_path);
   mrc_ofs << "# L2, " << mrc[0].n_req << " req, " << mrc[0].n_req_byte
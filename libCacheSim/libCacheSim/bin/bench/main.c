@@ -0,0 +1,436 @@
+//
+// microbenchmark of the eviction algorithms in cachesim/cache_init.h on
+// synthetic workloads (SYNTHETIC_TRACE) generated in memory, so that no trace
+// is read
+//
+// each (algorithm, workload, cache size) runs in a child process, so that
+// the peak RSS is of one run and a crash does not stop the benchmark, the
+// peak RSS is reported as the growth over the RSS at fork, which excludes the
+// trace and the other memory inherited from the parent, the results are
+// written as JSON, one result per line
+//
+//   zipf     Zipf(alpha) over n_obj objects
+//   uniform  uniform over n_obj objects
+//   scan     the zipf workload with 20% of the requests in sequential scans
+//            of objects that are never requested again
+//   loop     a loop over n_obj objects
+//   mixed    the workload changes every n_req / 10 requests
+//
+// with a baseline (the JSON of a previous run), the MQPS and the metadata
+// per object are compared, a result more than the threshold worse is marked
+// as a regression and the exit code is 1
+//
+// usage: bench [-a algo,algo] [-w zipf,uniform,scan,loop,mixed]
+//              [-c 0.01,0.1] [-n n_obj] [-r n_req] [-z alpha] [-o output]
+//              [-b baseline] [-T 0.1]
+//
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../../include/libCacheSim/cache.h"
+#include "../../include/libCacheSim/reader.h"
+#include "../../include/libCacheSim/request.h"
+#include "../../utils/include/mysys.h"
+#include "../cachesim/cache_init.h"
+
+#define BENCH_BATCH_SIZE 64
+#define BENCH_MAX_RESULT 4096
+#define BENCH_SEED 42
+
+/* the algorithms run by default, the aliases and the algorithms that need
+ * the future (belady) are not included */
+static const char *default_algos[] = {
+    "lru",         "fifo",          "arc",          "lhd",
+    "random",      "randomTwo",     "lfu",          "gdsf",
+    "lfuda",       "twoq",          "slru",         "hyperbolic",
+    "lecar",       "cacheus",       "size",         "lfucpp",
+    "wtinyLFU",    "clock",         "lirs",         "fifomerge",
+    "flashProb",   "sfifo",         "lru-prob",     "s3lru",
+    "s3fifo",      "s3fifod",       "qdlp",         "sieve",
+    "3l",          "AdaptiveClimbII", "AdaptiveClimb",
+    "DynamicAdaptiveClimb", "AdaptiveClimbSharded", "ilru",
+#ifdef ENABLE_GLCACHE
+    "GLCache",
+#endif
+#ifdef ENABLE_LRB
+    "lrb",
+#endif
+};
+
+typedef struct {
+  char algo[64];
+  char workload[16];
+  int64_t cache_size;
+  int64_t n_req;
+  double miss_ratio;
+  double mqps;
+  double md_bytes_per_obj;
+  int64_t peak_rss_kb;
+  bool ok;
+
+  /* from the baseline, mqps is 0 if not in the baseline */
+  double base_mqps;
+  double base_md_bytes_per_obj;
+  bool regression;
+} bench_result_t;
+
+/* the requests of a synthetic trace, generated before the run so that the
+ * benchmark does not measure the generator */
+static obj_id_t *gen_trace(const char *workload, int64_t n_obj, double alpha,
+                           int64_t n_req) {
+  char spec[256];
+  snprintf(spec, sizeof(spec), "%s:n_obj=%ld,n_req=%ld,alpha=%lf,seed=%d",
+           workload, (long)n_obj, (long)n_req, alpha, BENCH_SEED);
+  reader_t *reader = open_trace(spec, SYNTHETIC_TRACE, NULL);
+  request_t *req = new_request();
+  obj_id_t *trace = malloc(sizeof(obj_id_t) * n_req);
+  int64_t i = 0;
+  while (i < n_req && read_one_req(reader, req) == 0) {
+    trace[i++] = req->obj_id;
+  }
+  free_request(req);
+  close_reader(reader);
+  return trace;
+}
+
+/* the bytes allocated by malloc, -1 if unknown */
+static int64_t heap_bytes(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  struct mallinfo2 mi = mallinfo2();
+  return (int64_t)(mi.uordblks + mi.hblkhd);
+#else
+  return -1;
+#endif
+}
+
+/* run one benchmark, called in the child process */
+static void run_one(bench_result_t *res, const obj_id_t *trace) {
+  cache_t *cache =
+      create_cache(NULL, res->algo, res->cache_size, NULL, false);
+  /* the memory allocated at init (e.g., the hashtables) does not depend on
+   * the number of objects, so it is not counted as metadata */
+  int64_t heap_before = heap_bytes();
+
+  request_t *reqs = malloc(sizeof(request_t) * BENCH_BATCH_SIZE);
+  for (int i = 0; i < BENCH_BATCH_SIZE; i++) {
+    memset(&reqs[i], 0, sizeof(request_t));
+    reqs[i].obj_size = 1;
+    reqs[i].valid = true;
+  }
+  bool hits[BENCH_BATCH_SIZE];
+
+  int64_t n_miss = 0;
+  double start_time = gettime();
+  for (int64_t i = 0; i < res->n_req; i += BENCH_BATCH_SIZE) {
+    int n = (int)MIN(BENCH_BATCH_SIZE, res->n_req - i);
+    for (int j = 0; j < n; j++) {
+      reqs[j].obj_id = trace[i + j];
+      reqs[j].clock_time = i + j;
+    }
+    cache->get_batch(cache, reqs, n, hits);
+    for (int j = 0; j < n; j++) n_miss += !hits[j];
+  }
+  double runtime = gettime() - start_time;
+
+  res->miss_ratio = (double)n_miss / (double)res->n_req;
+  res->mqps = (double)res->n_req / 1000000.0 / runtime;
+
+  int64_t n_obj = cache->get_n_obj(cache);
+  int64_t heap_after = heap_bytes();
+  if (heap_before >= 0 && n_obj > 0) {
+    res->md_bytes_per_obj =
+        (double)(heap_after - heap_before) / (double)n_obj;
+  } else {
+    res->md_bytes_per_obj = -1;
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  res->peak_rss_kb = usage.ru_maxrss;
+  res->ok = true;
+
+  free(reqs);
+  cache->cache_free(cache);
+}
+
+/* run one benchmark in a child process so that the peak RSS is of this run
+ * and a crash only fails this run */
+static void run_in_child(bench_result_t *res, const obj_id_t *trace) {
+  int fd[2];
+  if (pipe(fd) != 0) {
+    perror("pipe");
+    exit(1);
+  }
+  fflush(stdout);
+  fflush(stderr);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    exit(1);
+  }
+  if (pid == 0) {
+    close(fd[0]);
+    /* the child starts with the pages of the parent, e.g., the trace */
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    int64_t fork_rss_kb = usage.ru_maxrss;
+    run_one(res, trace);
+    res->peak_rss_kb = MAX(res->peak_rss_kb - fork_rss_kb, 0);
+    ssize_t n = write(fd[1], res, sizeof(bench_result_t));
+    close(fd[1]);
+    _exit(n == sizeof(bench_result_t) ? 0 : 1);
+  }
+
+  close(fd[1]);
+  bench_result_t child_res;
+  ssize_t n = read(fd[0], &child_res, sizeof(bench_result_t));
+  close(fd[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  if (n == sizeof(bench_result_t) && WIFEXITED(status) &&
+      WEXITSTATUS(status) == 0) {
+    *res = child_res;
+  } else {
+    fprintf(stderr, "%s %s cache size %ld failed\n", res->algo, res->workload,
+            (long)res->cache_size);
+    res->ok = false;
+  }
+}
+
+/* the string value of key in a JSON line, false if not found */
+static bool json_get_str(const char *line, const char *key, char *value,
+                         size_t len) {
+  char pattern[64];
+  snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+  const char *p = strstr(line, pattern);
+  if (p == NULL) return false;
+  p += strlen(pattern);
+  const char *end = strchr(p, '"');
+  if (end == NULL || (size_t)(end - p) >= len) return false;
+  memcpy(value, p, end - p);
+  value[end - p] = '\0';
+  return true;
+}
+
+static double json_get_num(const char *line, const char *key) {
+  char pattern[64];
+  snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+  const char *p = strstr(line, pattern);
+  if (p == NULL) return 0;
+  return strtod(p + strlen(pattern), NULL);
+}
+
+/* fill the baseline of each result, and mark the regressions */
+static int compare_baseline(const char *baseline_path, bench_result_t *results,
+                            int n_result, double threshold) {
+  FILE *ifile = fopen(baseline_path, "r");
+  if (ifile == NULL) {
+    perror(baseline_path);
+    exit(1);
+  }
+
+  char line[1024], algo[64], workload[16];
+  while (fgets(line, sizeof(line), ifile) != NULL) {
+    if (!json_get_str(line, "algo", algo, sizeof(algo)) ||
+        !json_get_str(line, "workload", workload, sizeof(workload))) {
+      continue;
+    }
+    int64_t cache_size = (int64_t)json_get_num(line, "cache_size");
+    for (int i = 0; i < n_result; i++) {
+      if (strcmp(results[i].algo, algo) == 0 &&
+          strcmp(results[i].workload, workload) == 0 &&
+          results[i].cache_size == cache_size) {
+        results[i].base_mqps = json_get_num(line, "mqps");
+        results[i].base_md_bytes_per_obj =
+            json_get_num(line, "md_bytes_per_obj");
+      }
+    }
+  }
+  fclose(ifile);
+
+  int n_regression = 0;
+  for (int i = 0; i < n_result; i++) {
+    bench_result_t *res = &results[i];
+    if (!res->ok || res->base_mqps <= 0) continue;
+    if (res->mqps < res->base_mqps * (1 - threshold) ||
+        (res->base_md_bytes_per_obj > 0 &&
+         res->md_bytes_per_obj > res->base_md_bytes_per_obj * (1 + threshold))) {
+      res->regression = true;
+      n_regression++;
+      fprintf(stderr,
+              "regression: %s %s cache size %ld, %.2lf MQPS (baseline %.2lf), "
+              "%.1lf bytes/obj (baseline %.1lf)\n",
+              res->algo, res->workload, (long)res->cache_size, res->mqps,
+              res->base_mqps, res->md_bytes_per_obj,
+              res->base_md_bytes_per_obj);
+    }
+  }
+  return n_regression;
+}
+
+static void write_json(FILE *ofile, const bench_result_t *results,
+                       int n_result, int64_t n_obj, int64_t n_req,
+                       double alpha, bool has_baseline) {
+  fprintf(ofile,
+          "{\n\"n_obj\": %ld, \"n_req\": %ld, \"alpha\": %.2lf,\n"
+          "\"results\": [\n",
+          (long)n_obj, (long)n_req, alpha);
+  for (int i = 0; i < n_result; i++) {
+    const bench_result_t *res = &results[i];
+    fprintf(ofile,
+            "{\"algo\": \"%s\", \"workload\": \"%s\", \"cache_size\": %ld, "
+            "\"ok\": %s",
+            res->algo, res->workload, (long)res->cache_size,
+            res->ok ? "true" : "false");
+    if (res->ok) {
+      fprintf(ofile,
+              ", \"miss_ratio\": %.6lf, \"mqps\": %.4lf, "
+              "\"md_bytes_per_obj\": %.2lf, \"peak_rss_kb\": %ld",
+              res->miss_ratio, res->mqps, res->md_bytes_per_obj,
+              (long)res->peak_rss_kb);
+    }
+    if (has_baseline && res->base_mqps > 0) {
+      fprintf(ofile,
+              ", \"base_mqps\": %.4lf, \"base_md_bytes_per_obj\": %.2lf, "
+              "\"regression\": %s",
+              res->base_mqps, res->base_md_bytes_per_obj,
+              res->regression ? "true" : "false");
+    }
+    fprintf(ofile, "}%s\n", i == n_result - 1 ? "" : ",");
+  }
+  fprintf(ofile, "]\n}\n");
+}
+
+/* split a comma-separated list in place, return the number of items */
+static int split_list(char *str, char **items, int max_items) {
+  int n = 0;
+  char *item;
+  while ((item = strsep(&str, ",")) != NULL && n < max_items) {
+    if (item[0] != '\0') items[n++] = item;
+  }
+  return n;
+}
+
+int main(int argc, char *argv[]) {
+  int64_t n_obj = 1000000;
+  int64_t n_req = 10000000;
+  double alpha = 1.0;
+  double threshold = 0.1;
+  char *algo_list = NULL;
+  char workload_list[256] = "zipf,scan,loop";
+  char size_list[256] = "0.01,0.1";
+  const char *output_path = NULL;
+  const char *baseline_path = NULL;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "a:w:c:n:r:z:o:b:T:")) != -1) {
+    switch (opt) {
+      case 'a':
+        algo_list = optarg;
+        break;
+      case 'w':
+        snprintf(workload_list, sizeof(workload_list), "%s", optarg);
+        break;
+      case 'c':
+        snprintf(size_list, sizeof(size_list), "%s", optarg);
+        break;
+      case 'n':
+        n_obj = atol(optarg);
+        break;
+      case 'r':
+        n_req = atol(optarg);
+        break;
+      case 'z':
+        alpha = strtod(optarg, NULL);
+        break;
+      case 'o':
+        output_path = optarg;
+        break;
+      case 'b':
+        baseline_path = optarg;
+        break;
+      case 'T':
+        threshold = strtod(optarg, NULL);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-a algo,algo] [-w zipf,uniform,scan,loop,mixed] "
+                "[-c 0.01,0.1] [-n n_obj] [-r n_req] [-z alpha] [-o output] "
+                "[-b baseline] [-T threshold]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+
+  const char *algos[256];
+  int n_algo = 0;
+  if (algo_list != NULL) {
+    n_algo = split_list(algo_list, (char **)algos, 256);
+  } else {
+    n_algo = sizeof(default_algos) / sizeof(default_algos[0]);
+    memcpy(algos, default_algos, sizeof(default_algos));
+  }
+  char *workloads[8];
+  int n_workload = split_list(workload_list, workloads, 8);
+  char *size_strs[32];
+  int n_size = split_list(size_list, size_strs, 32);
+
+  bench_result_t *results = calloc(BENCH_MAX_RESULT, sizeof(bench_result_t));
+  int n_result = 0;
+  for (int w = 0; w < n_workload; w++) {
+    obj_id_t *trace = gen_trace(workloads[w], n_obj, alpha, n_req);
+    for (int s = 0; s < n_size; s++) {
+      /* a size below 1 is a fraction of the objects */
+      double size = strtod(size_strs[s], NULL);
+      int64_t cache_size = size < 1 ? (int64_t)(size * n_obj) : (int64_t)size;
+      for (int a = 0; a < n_algo && n_result < BENCH_MAX_RESULT; a++) {
+        bench_result_t *res = &results[n_result++];
+        snprintf(res->algo, sizeof(res->algo), "%s", algos[a]);
+        snprintf(res->workload, sizeof(res->workload), "%s", workloads[w]);
+        res->cache_size = cache_size;
+        res->n_req = n_req;
+        run_in_child(res, trace);
+        if (res->ok) {
+          fprintf(stderr, "%-24s %s %10ld: miss ratio %.4lf, %8.2lf MQPS, "
+                  "%6.1lf bytes/obj, peak RSS %ld KiB\n",
+                  res->algo, res->workload, (long)res->cache_size,
+                  res->miss_ratio, res->mqps, res->md_bytes_per_obj,
+                  (long)res->peak_rss_kb);
+        }
+      }
+    }
+    free(trace);
+  }
+
+  int n_regression = 0;
+  if (baseline_path != NULL) {
+    n_regression =
+        compare_baseline(baseline_path, results, n_result, threshold);
+  }
+
+  FILE *ofile = output_path == NULL ? stdout : fopen(output_path, "w");
+  if (ofile == NULL) {
+    perror(output_path);
+    return 1;
+  }
+  write_json(ofile, results, n_result, n_obj, n_req, alpha,
+             baseline_path != NULL);
+  if (ofile != stdout) fclose(ofile);
+
+  free(results);
+  if (n_regression > 0) {
+    fprintf(stderr, "%d regressions above %.0lf%%\n", n_regression,
+            threshold * 100);
+    return 1;
+  }
+  return 0;
+}
@@ -167,6 +167,8 @@ static inline cache_t *create_cache(const char *trace_path,
     cache = AdaptiveClimb_init(cc_params, eviction_params);
   } else if (strcasecmp(eviction_algo, "DynamicAdaptiveClimb") == 0) {
     cache = DynamicAdaptiveClimb_init(cc_params, eviction_params);
+  } else if (strcasecmp(eviction_algo, "AdaptiveClimbSharded") == 0) {
+    cache = AdaptiveClimbSharded_init(cc_params, eviction_params);
   } else if (strcasecmp(eviction_algo, "ilru") == 0) {
     cache = iLRU_init(cc_params, eviction_params);
   } else {
@@ -7,6 +7,7 @@
 #include "../../include/libCacheSim/const.h"
 #include "../../include/libCacheSim/dist.h"
 #include "../../include/libCacheSim/prefetchAlgo.h"
+#include "../../include/libCacheSim/simulator.h"
 #include "../../utils/include/mystr.h"
 #include "../../utils/include/mysys.h"
 #include "../cli_reader_utils.h"
@@ -45,6 +46,14 @@ enum argp_option_short {
 
   OPTION_PREFETCH_ALGO = 'p',
   OPTION_PREFETCH_PARAMS = 0x109,
+  OPTION_SHARED_DECODE = 0x10a,
+  OPTION_COST_MODEL = 0x10b,
+  OPTION_PIN_THREADS = 0x10c,
+  OPTION_NUMA = 0x10d,
+  OPTION_INTERVAL_OUTPUT = 0x10e,
+  OPTION_ZSTD_THREADS = 0x10f,
+  OPTION_CHECKPOINT_DIR = 0x110,
+  OPTION_CHECKPOINT_N_REQ = 0x111,
   OPTION_DUMP_CACHE_OBJ_IDS = 0x200,
 };
 
@@ -62,6 +71,10 @@ static struct argp_option options[] = {
      2},
     {"sample-ratio", OPTION_SAMPLE_RATIO, "1", 0,
      "Sample ratio, 1 means no sampling, 0.01 means sample 1% of objects", 2},
+    {"zstd-threads", OPTION_ZSTD_THREADS, "0", 0,
+     "Number of threads that decompress a zstd trace with multiple frames, "
+     "each reader has its own threads, best with --shared-decode",
+     2},
 
     {NULL, 0, NULL, 0, "cache related parameters:", 0},
     {"eviction-params", OPTION_EVICTION_PARAMS, "\"n-seg=4\"", 0,
@@ -82,6 +95,26 @@ static struct argp_option options[] = {
     {"output", OPTION_OUTPUT_PATH, "output", 0, "Output path", 6},
     {"num-thread", OPTION_NUM_THREAD, "16", 0,
      "Number of threads if running when using default cache sizes", 6},
+    {"shared-decode", OPTION_SHARED_DECODE, "false", 0,
+     "decode the trace once and share it among all caches", 6},
+    {"cost-model", OPTION_COST_MODEL, "FILENAME", 0,
+     "file of the per-algorithm throughput learned from previous runs, used "
+     "to start the slowest caches first",
+     6},
+    {"pin-threads", OPTION_PIN_THREADS, "false", 0,
+     "pin each simulation thread to one core", 6},
+    {"numa", OPTION_NUMA, "false", 0,
+     "pin the simulation threads and spread them over the NUMA nodes", 6},
+    {"interval-output", OPTION_INTERVAL_OUTPUT, "FILENAME", 0,
+     "write the per-interval (report-interval) stat of every cache to one "
+     "file, CSV if it ends with .csv, otherwise binary",
+     6},
+    {"checkpoint-dir", OPTION_CHECKPOINT_DIR, "DIR", 0,
+     "checkpoint each simulation to DIR, running the same command again "
+     "resumes the simulations from their checkpoints",
+     6},
+    {"checkpoint-n-req", OPTION_CHECKPOINT_N_REQ, "100000000", 0,
+     "the number of requests between two checkpoints", 6},
 
     {0, 0, 0, 0, "Other less common options:"},
     {"report-interval", OPTION_REPORT_INTERVAL, "3600", 0,
@@ -165,6 +198,32 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     case OPTION_WARMUP_SEC:
       arguments->warmup_sec = atoi(arg);
       break;
+    case OPTION_SHARED_DECODE:
+      arguments->shared_decode = is_true(arg) ? true : false;
+      break;
+    case OPTION_COST_MODEL:
+      arguments->cost_model_path = arg;
+      break;
+    case OPTION_CHECKPOINT_DIR:
+      arguments->checkpoint_dir = arg;
+      break;
+    case OPTION_CHECKPOINT_N_REQ:
+      arguments->checkpoint_n_req = atoll(arg);
+      break;
+    case OPTION_PIN_THREADS:
+      /* --numa also pins the threads */
+      if (is_true(arg) && arguments->thread_placement == SIM_THREAD_FLOAT)
+        arguments->thread_placement = SIM_THREAD_PIN;
+      break;
+    case OPTION_NUMA:
+      if (is_true(arg)) arguments->thread_placement = SIM_THREAD_NUMA;
+      break;
+    case OPTION_INTERVAL_OUTPUT:
+      arguments->interval_output = arg;
+      break;
+    case OPTION_ZSTD_THREADS:
+      arguments->n_zstd_thread = atoi(arg);
+      break;
     case OPTION_DUMP_CACHE_OBJ_IDS:
       if (arg) {
         strncpy(arguments->dump_cache_obj_ids, arg, 255);
@@ -204,7 +263,7 @@ static char doc[] =
     "example: ./cachesim /trace/path csv LRU 100MB\n\n"
     "trace can be zstd compressed\n"
     "cache_size is in byte, but also support KB/MB/GB\n"
-    "supported trace_type: txt/csv/twr/vscsi/oracleGeneralBin\n"
+    "supported trace_type: txt/csv/twr/vscsi/oracleGeneralBin/columnar/synthetic\n"
     "supported eviction_algo: LRU/LFU/FIFO/ARC/LeCaR/Cacheus\n";
 
 /**
@@ -227,6 +286,12 @@ static void init_arg(struct arguments *args) {
   args->use_ttl = false;
   args->ignore_obj_size = false;
   args->consider_obj_metadata = false;
+  args->shared_decode = false;
+  args->interval_output = NULL;
+  args->n_zstd_thread = 0;
+  args->cost_model_path = NULL;
+  args->checkpoint_dir = NULL;
+  args->checkpoint_n_req = 100000000;
   args->report_interval = 3600 * 24;
   args->n_thread = n_cores();
   args->warmup_sec = -1;
@@ -321,6 +386,8 @@ void parse_cmd(int argc, char *argv[], struct arguments *args) {
     reader_init_params.ignore_obj_size = true;
   }
 
+  /* the simulator clones the reader, so this applies to the clones too */
+  set_zstd_reader_n_thread(args->n_zstd_thread);
   args->reader =
       setup_reader(args->trace_path, args->trace_type, &reader_init_params);
 
@@ -540,6 +607,10 @@ void print_parsed_args(struct arguments *args) {
   if (args->use_ttl)
     n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1, ", use ttl");
 
+  if (args->n_zstd_thread > 0)
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
+                  ", %d zstd decoder threads", args->n_zstd_thread);
+
   if (args->ignore_obj_size)
     n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
                   ", ignore object size");
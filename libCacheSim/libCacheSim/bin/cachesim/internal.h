@@ -7,6 +7,7 @@
 #include "../../include/libCacheSim/enum.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 #include "../../include/libCacheSim/reader.h"
+#include "../../include/libCacheSim/simulator.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,20 @@ struct arguments {
   bool ignore_obj_size;
   bool consider_obj_metadata;
   bool use_ttl;
+  /* decode the trace once for all caches */
+  bool shared_decode;
+  /* the file of the per-interval stat of every cache, NULL if not written */
+  char *interval_output;
+  /* the decoder threads of a zstd trace, see set_zstd_reader_n_thread */
+  int n_zstd_thread;
+  /* the cost model used to order the simulations, NULL if not used */
+  char *cost_model_path;
+  /* checkpoint each simulation every checkpoint_n_req requests to a file in
+   * checkpoint_dir, NULL if not checkpointed */
+  char *checkpoint_dir;
+  int64_t checkpoint_n_req;
+  /* --pin-threads and --numa */
+  sim_thread_placement_e thread_placement;
 
   /* arguments generated */
   reader_t *reader;
@@ -47,9 +47,25 @@ int main(int argc, char **argv) {
   //     args.reader, args.cache, args.n_cache_size, args.cache_sizes, NULL, 0,
   //     args.warmup_sec, args.n_thread);
 
-  cache_stat_t *result = simulate_with_multi_caches(
-      args.reader, args.caches, args.n_cache_size * args.n_eviction_algo, NULL,
-      0, args.warmup_sec, args.n_thread, true);
+  sim_params_t sim_params = {.thread_placement = args.thread_placement,
+                             .interval_sec = args.report_interval,
+                             .interval_output_path = args.interval_output,
+                             .cost_model_path = args.cost_model_path,
+                             .checkpoint_n_req = args.checkpoint_n_req,
+                             .checkpoint_dir = args.checkpoint_dir};
+
+  if (args.checkpoint_dir != NULL) create_dir(args.checkpoint_dir);
+
+  cache_stat_t *result;
+  if (args.shared_decode) {
+    result = simulate_with_multi_caches_shared_decode(
+        args.reader, args.caches, args.n_cache_size * args.n_eviction_algo,
+        NULL, 0, args.warmup_sec, args.n_thread, true, &sim_params);
+  } else {
+    result = simulate_with_multi_caches(
+        args.reader, args.caches, args.n_cache_size * args.n_eviction_algo,
+        NULL, 0, args.warmup_sec, args.n_thread, true, &sim_params);
+  }
 
   char output_str[1024];
   char output_filename[128];
@@ -1,3 +1,4 @@
+#include "../../dataStructure/slidingWindow.h"
 #include "../../include/libCacheSim/cache.h"
 #include "../../include/libCacheSim/reader.h"
 #include "../../utils/include/mymath.h"
@@ -8,6 +9,13 @@
 extern "C" {
 #endif
 
+/* the number of most recent requests used for the recent miss ratio */
+#define RECENT_WINDOW_SIZE (1 << 20)
+/* the number of requests passed to cache->get_batch at a time */
+#define SIM_BATCH_SIZE 64
+/* the number of requests decoded by read_n_req at a time */
+#define SIM_DECODE_BATCH_SIZE 512
+
 void simulate(reader_t *reader, cache_t *cache, int report_interval,
               int warmup_sec, char *ofilepath) {
   /* random seed */
@@ -18,17 +26,24 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval,
   uint64_t req_cnt = 0, miss_cnt = 0;
   uint64_t last_req_cnt = 0, last_miss_cnt = 0;
   uint64_t req_byte = 0, miss_byte = 0;
+  sliding_window_t *recent_hits = sliding_window_create(RECENT_WINDOW_SIZE);
+  /* NULL if the trace has fields that are not in the batch */
+  req_batch_t *decode_batch = reader_batch_has_all_fields(reader)
+                                  ? new_req_batch(SIM_DECODE_BATCH_SIZE)
+                                  : NULL;
 
-  read_one_req(reader, req);
+  read_one_req_from_batch(reader, decode_batch, req);
   uint64_t start_ts = (uint64_t)req->clock_time;
   uint64_t last_report_ts = warmup_sec;
 
   double start_time = -1;
+  request_t *reqs = my_malloc_n(request_t, SIM_BATCH_SIZE);
+  bool hits[SIM_BATCH_SIZE];
   while (req->valid) {
     req->clock_time -= start_ts;
     if (req->clock_time <= warmup_sec) {
       cache->get(cache, req);
-      read_one_req(reader, req);
+      read_one_req_from_batch(reader, decode_batch, req);
       continue;
     } else {
       if (start_time < 0) {
@@ -36,32 +51,51 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval,
       }
     }
 
-    req_cnt++;
-    req_byte += req->obj_size;
-    if (cache->get(cache, req) == false) {
-      miss_cnt++;
-      miss_byte += req->obj_size;
-      cache->insert(cache, req);
-    }
-    if (req->clock_time - last_report_ts >= report_interval &&
-        req->clock_time != 0) {
-      INFO(
-          "%s %s %.2lf hour: %lu requests, miss ratio %.4lf, interval miss "
-          "ratio "
-          "%.4lf\n",
-          mybasename(reader->trace_path), cache->cache_name,
-          (double)req->clock_time / 3600, (unsigned long)req_cnt,
-          (double)miss_cnt / req_cnt,
-          (double)(miss_cnt - last_miss_cnt) / (req_cnt - last_req_cnt));
-      last_miss_cnt = miss_cnt;
-      last_req_cnt = req_cnt;
-      last_report_ts = (int64_t)req->clock_time;
+    /* after the warmup, requests are passed to the cache in batches so that
+     * get_batch can prefetch the hashtable for the requests ahead */
+    int n = 0;
+    copy_request(&reqs[n++], req);
+    read_one_req_from_batch(reader, decode_batch, req);
+    while (req->valid && n < SIM_BATCH_SIZE) {
+      req->clock_time -= start_ts;
+      copy_request(&reqs[n++], req);
+      read_one_req_from_batch(reader, decode_batch, req);
     }
+    cache->get_batch(cache, reqs, n, hits);
 
-    read_one_req(reader, req);
+    for (int i = 0; i < n; i++) {
+      const request_t *r = &reqs[i];
+      req_cnt++;
+      req_byte += r->obj_size;
+      if (!hits[i]) {
+        miss_cnt++;
+        miss_byte += r->obj_size;
+      }
+      sliding_window_add(recent_hits, hits[i]);
+      if (r->clock_time - last_report_ts >= report_interval &&
+          r->clock_time != 0) {
+        INFO(
+            "%s %s %.2lf hour: %lu requests, miss ratio %.4lf, interval miss "
+            "ratio "
+            "%.4lf, miss ratio of the last %ld requests %.4lf\n",
+            mybasename(reader->trace_path), cache->cache_name,
+            (double)r->clock_time / 3600, (unsigned long)req_cnt,
+            (double)miss_cnt / req_cnt,
+            (double)(miss_cnt - last_miss_cnt) / (req_cnt - last_req_cnt),
+            (long)recent_hits->n_recorded,
+            1.0 - (double)sliding_window_n_hit(recent_hits) /
+                      recent_hits->n_recorded);
+        last_miss_cnt = miss_cnt;
+        last_req_cnt = req_cnt;
+        last_report_ts = (int64_t)r->clock_time;
+      }
+    }
   }
 
   double runtime = gettime() - start_time;
+  sliding_window_free(recent_hits);
+  my_free(sizeof(request_t) * SIM_BATCH_SIZE, reqs);
+  if (decode_batch != NULL) free_req_batch(decode_batch);
 
   char output_str[1024];
   char size_str[8];
@@ -86,6 +120,10 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval,
   fprintf(output_file, "%s\n", output_str);
   fclose(output_file);
 
+  if (cache->op_latency != NULL) {
+    op_latency_print(cache->op_latency, cache->cache_name, stdout);
+  }
+
 #if defined(TRACK_EVICTION_V_AGE)
   while (cache->get_occupied_byte(cache) > 0) {
     cache->evict(cache, req);
@@ -36,6 +36,8 @@ trace_type_e trace_type_str_to_enum(const char *trace_type_str,
   } else if (strcasecmp(trace_type_str, "lcs") == 0) {
     // libCacheSim trace
     return LCS_TRACE;
+  } else if (strcasecmp(trace_type_str, "columnar") == 0) {
+    return COLUMNAR_TRACE;
   } else if (strcasecmp(trace_type_str, "twr") == 0) {
     return TWR_TRACE;
   } else if (strcasecmp(trace_type_str, "twrNS") == 0) {
@@ -61,6 +63,8 @@ trace_type_e trace_type_str_to_enum(const char *trace_type_str,
     return ORACLE_SYS_TWRNS_TRACE;
   } else if (strcasecmp(trace_type_str, "valpinTrace") == 0) {
     return VALPIN_TRACE;
+  } else if (strcasecmp(trace_type_str, "synthetic") == 0) {
+    return SYNTHETIC_TRACE;
   } else {
     ERROR("unsupported trace type: %s\n", trace_type_str);
   }
@@ -138,6 +142,8 @@ void parse_reader_params(const char *reader_params_str,
         ERROR("param parsing error, find string \"%s\" after number\n", end);
     } else if (strcasecmp(key, "obj-id-is-num") == 0) {
       params->obj_id_is_num = is_true(value);
+    } else if (strcasecmp(key, "audit-str-obj-id") == 0) {
+      params->audit_str_obj_id = is_true(value);
     } else if (strcasecmp(key, "header") == 0 ||
                strcasecmp(key, "has-header") == 0) {
       params->has_header = is_true(value);
@@ -186,12 +192,16 @@ void parse_reader_params(const char *reader_params_str,
 trace_type_e detect_trace_type(const char *trace_path) {
   trace_type_e trace_type = UNKNOWN_TRACE;
 
-  if (strcasestr(trace_path, "oracleGeneralBin") != NULL ||
-      strcasestr(trace_path, "oracleGeneral.bin") != NULL ||
-      strcasestr(trace_path, "bin.oracleGeneral") != NULL ||
-      strcasestr(trace_path, "oracleGeneral.zst") != NULL ||
-      strcasestr(trace_path, "oracleGeneral.") != NULL ||
-      strcasecmp(trace_path + strlen(trace_path) - 13, "oracleGeneral") == 0) {
+  if (strcasestr(trace_path, ".columnar") != NULL) {
+    /* checked first because traceConv names it <trace>.columnar */
+    trace_type = COLUMNAR_TRACE;
+  } else if (strcasestr(trace_path, "oracleGeneralBin") != NULL ||
+             strcasestr(trace_path, "oracleGeneral.bin") != NULL ||
+             strcasestr(trace_path, "bin.oracleGeneral") != NULL ||
+             strcasestr(trace_path, "oracleGeneral.zst") != NULL ||
+             strcasestr(trace_path, "oracleGeneral.") != NULL ||
+             strcasecmp(trace_path + strlen(trace_path) - 13,
+                        "oracleGeneral") == 0) {
     trace_type = ORACLE_GENERAL_TRACE;
   } else if (strcasestr(trace_path, ".vscsi") != NULL) {
     trace_type = VSCSI_TRACE;
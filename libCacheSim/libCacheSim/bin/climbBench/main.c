@@ -0,0 +1,175 @@
+//
+// throughput benchmark of AdaptiveClimbSharded, the thread-safe
+// AdaptiveClimb, on a Zipf workload
+//
+// every thread count (1, 2, 4, ... up to -t) uses a new cache that is first
+// warmed up with the whole request sequence, then all threads issue -r
+// requests each to the same cache
+//
+// usage: climbBench [-n n_obj] [-a alpha] [-c cache_size] [-s n_shard]
+//                   [-t max_threads] [-r n_req_per_thread] [-e params]
+//
+
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/libCacheSim/cache.h"
+#include "../../include/libCacheSim/evictionAlgo.h"
+#include "../../include/libCacheSim/reader.h"
+#include "../../include/libCacheSim/request.h"
+#include "../../utils/include/mysys.h"
+
+#define N_TRACE_REQ (8 * 1000 * 1000)
+#define BENCH_SEED 42
+
+typedef struct {
+  cache_t *cache;
+  const obj_id_t *trace;
+  int64_t n_trace_req;
+  int64_t n_req;
+  int64_t start;
+  pthread_barrier_t *barrier;
+} worker_arg_t;
+
+/* the requests of a Zipf(alpha) synthetic trace (SYNTHETIC_TRACE) over
+ * n_obj objects, generated before the run so that the benchmark does not
+ * measure the generator */
+static obj_id_t *gen_zipf_trace(int64_t n_obj, double alpha, int64_t n_req) {
+  char spec[256];
+  snprintf(spec, sizeof(spec), "zipf:n_obj=%ld,n_req=%ld,alpha=%lf,seed=%d",
+           (long)n_obj, (long)n_req, alpha, BENCH_SEED);
+  reader_t *reader = open_trace(spec, SYNTHETIC_TRACE, NULL);
+  request_t *req = new_request();
+  obj_id_t *trace = malloc(sizeof(obj_id_t) * n_req);
+  int64_t i = 0;
+  while (i < n_req && read_one_req(reader, req) == 0) {
+    trace[i++] = req->obj_id;
+  }
+  if (i < n_req) {
+    ERROR("the synthetic trace has %ld requests, expect %ld\n", (long)i,
+          (long)n_req);
+  }
+  free_request(req);
+  close_reader(reader);
+  return trace;
+}
+
+static void *worker(void *arg) {
+  worker_arg_t *warg = (worker_arg_t *)arg;
+  request_t *req = new_request();
+  req->obj_size = 1;
+
+  pthread_barrier_wait(warg->barrier);
+  int64_t pos = warg->start;
+  for (int64_t i = 0; i < warg->n_req; i++) {
+    req->obj_id = warg->trace[pos];
+    warg->cache->get(warg->cache, req);
+    if (++pos == warg->n_trace_req) pos = 0;
+  }
+
+  free_request(req);
+  return NULL;
+}
+
+static double run(cache_t *cache, const obj_id_t *trace, int n_thread,
+                  int64_t n_req_per_thread) {
+  pthread_t *tids = malloc(sizeof(pthread_t) * n_thread);
+  worker_arg_t *args = malloc(sizeof(worker_arg_t) * n_thread);
+  pthread_barrier_t barrier;
+  pthread_barrier_init(&barrier, NULL, n_thread + 1);
+
+  for (int i = 0; i < n_thread; i++) {
+    args[i] = (worker_arg_t){.cache = cache,
+                             .trace = trace,
+                             .n_trace_req = N_TRACE_REQ,
+                             .n_req = n_req_per_thread,
+                             .start = (N_TRACE_REQ / n_thread) * i,
+                             .barrier = &barrier};
+    pthread_create(&tids[i], NULL, worker, &args[i]);
+  }
+
+  pthread_barrier_wait(&barrier);
+  double start_time = gettime();
+  for (int i = 0; i < n_thread; i++) {
+    pthread_join(tids[i], NULL);
+  }
+  double runtime = gettime() - start_time;
+
+  pthread_barrier_destroy(&barrier);
+  free(args);
+  free(tids);
+
+  return (double)n_req_per_thread * n_thread / 1000000.0 / runtime;
+}
+
+int main(int argc, char *argv[]) {
+  int64_t n_obj = 1000000;
+  double alpha = 1.0;
+  int64_t cache_size = 100000;
+  int n_shard = 64;
+  int max_thread = 64;
+  int64_t n_req_per_thread = 4000000;
+  const char *extra_params = NULL;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:a:c:s:t:r:e:")) != -1) {
+    switch (opt) {
+      case 'n':
+        n_obj = atol(optarg);
+        break;
+      case 'a':
+        alpha = strtod(optarg, NULL);
+        break;
+      case 'c':
+        cache_size = atol(optarg);
+        break;
+      case 's':
+        n_shard = atoi(optarg);
+        break;
+      case 't':
+        max_thread = atoi(optarg);
+        break;
+      case 'r':
+        n_req_per_thread = atol(optarg);
+        break;
+      case 'e':
+        extra_params = optarg;
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-n n_obj] [-a alpha] [-c cache_size] [-s n_shard] "
+                "[-t max_threads] [-r n_req_per_thread] [-e params]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+
+  char params[CACHE_INIT_PARAMS_LEN];
+  snprintf(params, sizeof(params), "n-shard=%d%s%s", n_shard,
+           extra_params == NULL ? "" : ",",
+           extra_params == NULL ? "" : extra_params);
+
+  obj_id_t *trace = gen_zipf_trace(n_obj, alpha, N_TRACE_REQ);
+
+  common_cache_params_t cc_params = default_common_cache_params();
+  cc_params.cache_size = cache_size;
+
+  printf("# %ld objects, zipf alpha %.2lf, cache size %ld, %s\n", (long)n_obj,
+         alpha, (long)cache_size, params);
+  printf("# threads, MQPS, hit ratio (including warmup)\n");
+  for (int n_thread = 1; n_thread <= max_thread; n_thread *= 2) {
+    cache_t *cache = AdaptiveClimbSharded_init(cc_params, params);
+    run(cache, trace, 1, N_TRACE_REQ);
+    double mqps = run(cache, trace, n_thread, n_req_per_thread);
+    printf("%d, %.2lf, %.4lf\n", n_thread, mqps,
+           AdaptiveClimbSharded_get_hit_ratio(cache));
+    fflush(stdout);
+    cache->cache_free(cache);
+  }
+
+  free(trace);
+  return 0;
+}
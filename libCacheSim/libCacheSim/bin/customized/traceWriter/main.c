@@ -53,7 +53,7 @@ void fix_msr_oracleGeneral_trace(char *trace_path) {
 void fix_msr_oracleGeneralOpNS_trace(char *trace_path) {
   reader_t *reader =
       setup_reader(trace_path, ORACLE_GENERALOPNS_TRACE, NULL);
-  request_t *req = new_request();
+  request_t *req = new_request_with_info();
 
   char ofilepath[256];
   sprintf(ofilepath, "%s.new", trace_path);
@@ -71,7 +71,7 @@ void fix_msr_oracleGeneralOpNS_trace(char *trace_path) {
     // }
 
     uint8_t op = req->op;
-    uint16_t ns = req->ns;
+    uint16_t ns = req->info->ns;
 
     fwrite(&req->clock_time, 4, 1, ofile);
     fwrite(&req->obj_id, 8, 1, ofile);
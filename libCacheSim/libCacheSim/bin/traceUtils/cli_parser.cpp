@@ -23,10 +23,12 @@ enum argp_option_short {
   OPTION_OUTPUT_PATH = 'o',
   OPTION_SAMPLE_RATIO = 's',
   OPTION_IGNORE_OBJ_SIZE = 0x101,
+  OPTION_ZSTD_THREADS = 0x105,
 
   // trace conv
   OPTION_OUTPUT_TXT = 0x102,
   OPTION_REMOVE_SIZE_CHANGE = 0x103,
+  OPTION_OUTPUT_FORMAT = 0x104,
 
   // trace print
   OPTION_NUM_REQ = 'n',
@@ -54,6 +56,8 @@ static struct argp_option options[] = {
      "Sample ratio, 1 means no sampling, 0.01 means sample 1% of objects", 2},
     {"ignore-obj-size", OPTION_IGNORE_OBJ_SIZE, "false", 0,
      "specify to ignore the object size from the trace", 2},
+    {"zstd-threads", OPTION_ZSTD_THREADS, "0", 0,
+     "Number of threads that decompress a zstd trace with multiple frames", 2},
 
     {0, 0, 0, 0, "traceConv options:"},
     {"output-txt", OPTION_OUTPUT_TXT, "false", 0,
@@ -62,6 +66,8 @@ static struct argp_option options[] = {
      "whether remove object size change, if true, objects with changed size "
      "are updated to the old size",
      4},
+    {"output-format", OPTION_OUTPUT_FORMAT, "oracleGeneral", 0,
+     "output trace format, oracleGeneral, lcs or columnar (compressed)", 4},
 
     {0, 0, 0, 0, "tracePrint options:"},
     {"num-req", OPTION_NUM_REQ, "-1", 0,
@@ -99,6 +105,9 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     case OPTION_OUTPUT_PATH:
       strncpy(arguments->ofilepath, arg, OFILEPATH_LEN - 1);
       break;
+    case OPTION_ZSTD_THREADS:
+      arguments->n_zstd_thread = atoi(arg);
+      break;
     case OPTION_SAMPLE_RATIO:
       arguments->sample_ratio = atof(arg);
       if (arguments->sample_ratio < 0 || arguments->sample_ratio > 1) {
@@ -111,6 +120,9 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     case OPTION_OUTPUT_TXT:
       arguments->output_txt = is_true(arg) ? true : false;
       break;
+    case OPTION_OUTPUT_FORMAT:
+      arguments->output_format = arg;
+      break;
     case OPTION_NUM_REQ:
       arguments->n_req = atoll(arg);
       break;
@@ -168,6 +180,8 @@ static char doc[] =
     "example usage: ./traceConv /trace/path csv -o "
     "/path/new_trace.oracleGeneral -t "
     "\"obj-id-col=5,time-col=2,obj-size-col=4\"\n\n"
+    "example usage: ./traceConv /trace/path oracleGeneral "
+    "--output-format columnar\n\n"
     "example usage: ./traceFilter /trace/path lcs -o /path/new_trace.lcs "
     "--filter fifo --filter-size 0.1\n\n";
 
@@ -184,8 +198,10 @@ static void init_arg(struct arguments *args) {
   args->trace_type_str = NULL;
   args->trace_type_params = NULL;
   args->ignore_obj_size = false;
+  args->n_zstd_thread = 0;
   args->sample_ratio = 1.0;
   memset(args->ofilepath, 0, OFILEPATH_LEN);
+  args->output_format = (char *)"oracleGeneral";
   args->output_txt = false;
   args->remove_size_change = false;
   args->cache_name = NULL;
@@ -214,6 +230,10 @@ static void print_parsed_arg(struct arguments *args) {
     n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
                   ", num requests to process: %ld", (long)args->n_req);
 
+  if (strcasecmp(args->output_format, "oracleGeneral") != 0)
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
+                  ", output format: %s", args->output_format);
+
   if (args->output_txt)
     n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
                   ", output txt trace: true");
@@ -226,6 +246,10 @@ static void print_parsed_arg(struct arguments *args) {
     n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
                   ", ignore object size");
 
+  if (args->n_zstd_thread > 0)
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
+                  ", %d zstd decoder threads", args->n_zstd_thread);
+
   snprintf(output_str + n, OUTPUT_STR_LEN - n - 1, "\n");
 
   INFO("%s", output_str);
@@ -250,6 +274,7 @@ void parse_cmd(int argc, char *argv[], struct arguments *args) {
   args->trace_type_str = args->args[1];
   assert(N_ARGS == 2);
 
+  set_zstd_reader_n_thread(args->n_zstd_thread);
   args->reader = create_reader(args->trace_type_str, args->trace_path,
                                args->trace_type_params, args->n_req,
                                args->ignore_obj_size, 0);
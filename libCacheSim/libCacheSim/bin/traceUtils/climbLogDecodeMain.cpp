@@ -0,0 +1,69 @@
+//
+// convert the binary controller event log written by AdaptiveClimb and
+// DynamicAdaptiveClimb (event-log=<path>) to csv
+//
+// usage: climbLogDecode <event log> [output csv]
+// the csv is written to stdout if the output is not given
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/libCacheSim/evictionAlgo/climbEventLog.h"
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s <event log> [output csv]\n", argv[0]);
+    return 1;
+  }
+
+  FILE *ifile = fopen(argv[1], "rb");
+  if (ifile == NULL) {
+    fprintf(stderr, "cannot open %s\n", argv[1]);
+    return 1;
+  }
+
+  climb_event_log_header_t header;
+  if (fread(&header, sizeof(header), 1, ifile) != 1 ||
+      header.magic != CLIMB_EVENT_LOG_MAGIC) {
+    fprintf(stderr, "%s is not a climb event log\n", argv[1]);
+    return 1;
+  }
+  if (header.version != CLIMB_EVENT_LOG_VERSION ||
+      header.event_size != sizeof(climb_event_t)) {
+    fprintf(stderr, "%s has version %u event size %u, expect %u %zu\n",
+            argv[1], header.version, header.event_size,
+            CLIMB_EVENT_LOG_VERSION, sizeof(climb_event_t));
+    return 1;
+  }
+
+  FILE *ofile = stdout;
+  if (argc == 3) {
+    ofile = fopen(argv[2], "w");
+    if (ofile == NULL) {
+      fprintf(stderr, "cannot open %s\n", argv[2]);
+      return 1;
+    }
+  }
+
+  fprintf(ofile,
+          "n_req,miss_ratio,ema_miss_ratio,K,jump,fallback_counter,"
+          "in_fallback\n");
+
+  climb_event_t events[4096];
+  size_t n;
+  while ((n = fread(events, sizeof(climb_event_t), 4096, ifile)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      const climb_event_t *e = &events[i];
+      fprintf(ofile, "%ld,%.6lf,%.6lf,%d,%d,%d,%d\n", (long)e->n_req,
+              e->miss_ratio, e->ema_miss_ratio, e->K, e->jump,
+              e->fallback_counter, e->in_fallback);
+    }
+  }
+
+  fclose(ifile);
+  if (ofile != stdout) fclose(ofile);
+
+  return 0;
+}
@@ -22,8 +22,11 @@ struct arguments {
   char *trace_type_params;
   double sample_ratio;
   bool ignore_obj_size;
+  /* the decoder threads of a zstd trace, see set_zstd_reader_n_thread */
+  int n_zstd_thread;
 
   /* trace conv */
+  char *output_format;
   bool output_txt;
   /* some objects may change size during the trace, this keeps the size as the
    * last size in the trace */
@@ -53,6 +56,16 @@ void free_arg(struct arguments *args);
 
 namespace traceConv {
 
+/* the layout of the converted trace, all of them have the oracleGeneral
+ * fields */
+typedef enum {
+  OUTPUT_ORACLE_GENERAL,
+  /* oracleGeneral with the lcs header */
+  OUTPUT_LCS,
+  /* compressed in blocks of columns, see generalReader/columnar.h */
+  OUTPUT_COLUMNAR,
+} output_format_e;
+
 /**
  * @brief convert the trace to oracleGeneral format
  *
@@ -62,10 +75,11 @@ namespace traceConv {
  * @param sample_ratio
  * @param output_txt    whether also output a txt trace
  * @param remove_size_change whether remove object size change during traceConv
- * @param use_lcs_format whether use lcs format
+ * @param output_format oracleGeneral, lcs or columnar
  */
 void convert_to_oracleGeneral(reader_t *reader, std::string ofilepath,
                               int sample_ratio, bool output_txt,
-                              bool remove_size_change, bool use_lcs_format);
+                              bool remove_size_change,
+                              output_format_e output_format);
 
 }  // namespace traceConv
@@ -9,7 +9,9 @@
 
 #include "../../include/libCacheSim/logging.h"
 #include "../../include/libCacheSim/reader.h"
+#include "../../traceReader/generalReader/columnar.h"
 #include "../../traceReader/generalReader/lcs.h"
+#include "internal.hpp"
 
 namespace traceConv {
 typedef struct oracleGeneral_req {
@@ -34,7 +36,7 @@ struct trace_stat {
 
 static void _reverse_file(std::string ofilepath, struct trace_stat stat,
                           bool output_txt, bool remove_size_change,
-                          bool use_lcs_format);
+                          output_format_e output_format);
 
 /**
  * @brief Convert a trace to oracleGeneral format, which is a binary format
@@ -47,10 +49,12 @@ static void _reverse_file(std::string ofilepath, struct trace_stat stat,
  * @param sample_ratio
  * @param output_txt
  * @param remove_size_change
+ * @param output_format
  */
 void convert_to_oracleGeneral(reader_t *reader, std::string ofilepath,
                               int sample_ratio, bool output_txt,
-                              bool remove_size_change, bool use_lcs_format) {
+                              bool remove_size_change,
+                              output_format_e output_format) {
   request_t *req = new_request();
   std::ofstream ofile_temp(ofilepath + ".reverse",
                            std::ios::out | std::ios::binary | std::ios::trunc);
@@ -128,7 +132,7 @@ void convert_to_oracleGeneral(reader_t *reader, std::string ofilepath,
   stat.n_obj_byte = unique_bytes;
 
   _reverse_file(ofilepath, stat, output_txt, remove_size_change,
-                use_lcs_format);
+                output_format);
 }
 
 static void *_setup_mmap(const std::string &file_path, size_t *size) {
@@ -172,16 +176,22 @@ static void *_setup_mmap(const std::string &file_path, size_t *size) {
 
 static void _reverse_file(std::string ofilepath, struct trace_stat stat,
                           bool output_txt, bool remove_size_change,
-                          bool use_lcs_format) {
+                          output_format_e output_format) {
   int64_t n_req = 0;
   size_t file_size;
   char *mapped_file =
       reinterpret_cast<char *>(_setup_mmap(ofilepath + ".reverse", &file_size));
   size_t pos = file_size;
 
-  std::ofstream ofile(ofilepath,
-                      std::ios::out | std::ios::binary | std::ios::trunc);
-  if (use_lcs_format) {
+  std::ofstream ofile;
+  columnar_writer_t *columnar_writer = nullptr;
+  if (output_format == OUTPUT_COLUMNAR) {
+    columnar_writer = open_columnar_writer(ofilepath.c_str(), 0);
+  } else {
+    ofile.open(ofilepath, std::ios::out | std::ios::binary | std::ios::trunc);
+  }
+
+  if (output_format == OUTPUT_LCS) {
     lcs_trace_header_t lcs_header;
     lcs_header.start_magic = LCS_TRACE_START_MAGIC;
     lcs_header.end_magic = LCS_TRACE_END_MAGIC;
@@ -231,7 +241,12 @@ static void _reverse_file(std::string ofilepath, struct trace_stat stat,
       }
     }
 
-    ofile.write(reinterpret_cast<char *>(&og_req), req_entry_size);
+    if (columnar_writer != nullptr) {
+      columnar_writer_append(columnar_writer, og_req.clock_time, og_req.obj_id,
+                             og_req.obj_size, og_req.next_access_vtime);
+    } else {
+      ofile.write(reinterpret_cast<char *>(&og_req), req_entry_size);
+    }
     if (output_txt) {
       ofile_txt << og_req.clock_time << "," << og_req.obj_id << ","
                 << og_req.obj_size << "," << og_req.next_access_vtime << "\n";
@@ -243,7 +258,16 @@ static void _reverse_file(std::string ofilepath, struct trace_stat stat,
   }
 
   munmap(mapped_file, file_size);
-  ofile.close();
+  if (columnar_writer != nullptr) {
+    uint64_t trace_size =
+        close_columnar_writer(columnar_writer, stat.n_obj, stat.n_req_byte,
+                              stat.n_obj_byte);
+    INFO("columnar trace %.2lf MB, %.2lf bytes per request (%.2lfx smaller)\n",
+         (double)trace_size / MiB, (double)trace_size / (double)n_req,
+         (double)(n_req * req_entry_size) / (double)trace_size);
+  } else {
+    ofile.close();
+  }
   if (output_txt) ofile_txt.close();
 
   assert(n_req == stat.n_req);
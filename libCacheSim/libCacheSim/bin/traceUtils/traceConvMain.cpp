@@ -3,8 +3,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 
+#include "../../include/libCacheSim/logging.h"
 #include "../../include/libCacheSim/reader.h"
 #include "internal.hpp"
 
@@ -30,13 +32,33 @@ int main(int argc, char *argv[]) {
   struct arguments args;
 
   cli::parse_cmd(argc, argv, &args);
+
+  traceConv::output_format_e output_format;
+  const char *suffix;
+  if (strcasecmp(args.output_format, "oracleGeneral") == 0) {
+    output_format = traceConv::OUTPUT_ORACLE_GENERAL;
+    suffix = "oracleGeneral";
+  } else if (strcasecmp(args.output_format, "lcs") == 0) {
+    output_format = traceConv::OUTPUT_LCS;
+    suffix = "lcs";
+  } else if (strcasecmp(args.output_format, "columnar") == 0) {
+    output_format = traceConv::OUTPUT_COLUMNAR;
+    suffix = "columnar";
+  } else {
+    ERROR(
+        "unknown output format %s, supported: oracleGeneral, lcs, "
+        "columnar\n",
+        args.output_format);
+    abort();
+  }
+
   if (strlen(args.ofilepath) == 0) {
-    snprintf(args.ofilepath, OFILEPATH_LEN, "%s.oracleGeneral", args.trace_path);
+    snprintf(args.ofilepath, OFILEPATH_LEN, "%s.%s", args.trace_path, suffix);
   }
 
   traceConv::convert_to_oracleGeneral(args.reader, args.ofilepath,
                                       args.sample_ratio, args.output_txt,
-                                      args.remove_size_change, false);
+                                      args.remove_size_change, output_format);
 }
 
 
@@ -2,6 +2,7 @@
 // Created by Juncheng Yang on 6/20/20.
 //
 
+#include "../dataStructure/hash/hash.h"
 #include "../dataStructure/hashtable/hashtable.h"
 #include "../include/libCacheSim/cache.h"
 #include "../include/libCacheSim/prefetchAlgo.h"
@@ -41,6 +42,13 @@ cache_t *cache_struct_init(const char *const cache_name,
   cache->to_evict_candidate = NULL;
   cache->to_evict_candidate_gen_vtime = -1;
 
+#if defined(TRACK_OP_LATENCY)
+  cache->op_latency = op_latency_create();
+#else
+  cache->op_latency = NULL;
+#endif
+
+  cache->get_batch = cache_get_batch_default;
   cache->can_insert = cache_can_insert_default;
   cache->get_occupied_byte = cache_get_occupied_byte_default;
   cache->get_n_obj = cache_get_n_obj_default;
@@ -70,6 +78,7 @@ cache_t *cache_struct_init(const char *const cache_name,
  * @param cache
  */
 void cache_struct_free(cache_t *cache) {
+  if (cache->op_latency != NULL) op_latency_free(cache->op_latency);
   free_hashtable(cache->hashtable);
   if (cache->admissioner != NULL) cache->admissioner->free(cache->admissioner);
   if (cache->prefetcher != NULL) cache->prefetcher->free(cache->prefetcher);
@@ -190,7 +199,7 @@ cache_obj_t *cache_find_base(cache_t *cache, const request_t *req,
         cache->remove(cache, cache_obj->obj_id);
       }
 
-      cache_obj = NULL;
+      return NULL;
     }
 #endif
 
@@ -229,21 +238,36 @@ bool cache_get_base(cache_t *cache, const request_t *req) {
           cache->cache_name, cache->n_req, req->obj_id, req->obj_size,
           cache->get_occupied_byte(cache), cache->cache_size);
 
-  cache_obj_t *obj = cache->find(cache, req, true);
+  /* the ops are timed when the request is sampled, see opLatency.h */
+  bool sampled = OP_LATENCY_SAMPLE(cache);
+  cache_obj_t *obj;
+  OP_LATENCY_TIME(cache, sampled, CACHE_OP_FIND,
+                  obj = cache->find(cache, req, true));
   bool hit = (obj != NULL);
 
+  bool can_insert = true;
+  if (!hit) {
+    OP_LATENCY_TIME(cache, sampled, CACHE_OP_CAN_INSERT,
+                    can_insert = cache->can_insert(cache, req));
+  }
+
   if (hit) {
     VVERBOSE("req %ld, obj %ld --- cache hit\n", cache->n_req, req->obj_id);
-  } else if (!cache->can_insert(cache, req)) {
+  } else if (!can_insert) {
     VVERBOSE("req %ld, obj %ld --- cache miss cannot insert\n", cache->n_req,
              req->obj_id);
   } else {
+    int64_t n_evict = 0;
     while (cache->get_occupied_byte(cache) + req->obj_size +
                cache->obj_md_size >
            cache->cache_size) {
-      cache->evict(cache, req);
+      OP_LATENCY_TIME(cache, sampled, CACHE_OP_EVICT,
+                      cache->evict(cache, req));
+      n_evict += 1;
     }
-    cache->insert(cache, req);
+    cache->n_evict += n_evict;
+    OP_LATENCY_EVICT_ITER(cache, sampled, n_evict);
+    OP_LATENCY_TIME(cache, sampled, CACHE_OP_INSERT, cache->insert(cache, req));
   }
 
   if (cache->prefetcher && cache->prefetcher->prefetch) {
@@ -253,6 +277,45 @@ bool cache_get_base(cache_t *cache, const request_t *req) {
   return hit;
 }
 
+void cache_get_batch_default(cache_t *cache, request_t *reqs, int n,
+                             bool *hits) {
+  for (int i = 0; i < n; i++) {
+    hits[i] = cache->get(cache, &reqs[i]);
+  }
+}
+
+/* the bucket slot is prefetched 2 * distance requests ahead, and the first
+ * object in the bucket distance requests ahead, when the slot is in cache */
+#define GET_BATCH_PREFETCH_DISTANCE 8
+
+/* the hash of the request, computed when the bucket is prefetched and
+ * reused when the object is prefetched */
+static inline uint64_t _req_hv(request_t *req) {
+  if (req->hv == 0) req->hv = get_hash_value_int_64(&req->obj_id);
+  return req->hv;
+}
+
+void cache_get_batch_prefetch(cache_t *cache, request_t *reqs, int n,
+                              bool *hits, cache_get_func_ptr get) {
+  const int d = GET_BATCH_PREFETCH_DISTANCE;
+  for (int i = 0; i < n && i < 2 * d; i++) {
+    hashtable_prefetch_bucket(cache->hashtable, _req_hv(&reqs[i]));
+  }
+  for (int i = 0; i < n && i < d; i++) {
+    hashtable_prefetch_obj(cache->hashtable, reqs[i].hv);
+  }
+
+  for (int i = 0; i < n; i++) {
+    if (i + 2 * d < n) {
+      hashtable_prefetch_bucket(cache->hashtable, _req_hv(&reqs[i + 2 * d]));
+    }
+    if (i + d < n) {
+      hashtable_prefetch_obj(cache->hashtable, reqs[i + d].hv);
+    }
+    hits[i] = get(cache, &reqs[i]);
+  }
+}
+
 /**
  * @brief this function is called by all caches to
  * insert an object into the cache, update the hash table and cache metadata
@@ -0,0 +1,340 @@
+//
+//  cacheSnapshot.c
+//  libCacheSim
+//
+//  the snapshot file is
+//    magic, version, whether the reader position is saved,
+//    [reader position],
+//    cache name, cache size, n_req, n_obj, occupied bytes,
+//    the state written by cache->snapshot
+//
+//  all integers are written in the native byte order, a snapshot is meant
+//  to be restored on the same kind of machine it was taken on
+//
+
+#include "../include/libCacheSim/cacheSnapshot.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../dataStructure/hashtable/hashtable.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* one object in a queue, followed by md_size bytes of metadata */
+typedef struct {
+  obj_id_t obj_id;
+  int64_t obj_size;
+  int32_t freq;
+  int32_t misc_freq;
+  uint32_t exp_time;
+  int64_t insert_time;
+} __attribute__((packed)) snapshot_obj_t;
+
+/* the length of the algorithm name, i.e., the cache name up to the first
+ * '-', the rest are the parameters */
+static size_t _algo_name_len(const char *cache_name) {
+  return strcspn(cache_name, "-");
+}
+
+bool snapshot_write_queue(FILE *ofile, const cache_obj_t *head,
+                          size_t md_size) {
+  int64_t n_obj = 0;
+  for (const cache_obj_t *obj = head; obj != NULL; obj = obj->queue.next) {
+    n_obj++;
+  }
+  if (!snapshot_write(ofile, &n_obj, sizeof(n_obj))) return false;
+
+  snapshot_obj_t rec;
+  for (const cache_obj_t *obj = head; obj != NULL; obj = obj->queue.next) {
+    rec.obj_id = obj->obj_id;
+    rec.obj_size = obj->obj_size;
+    rec.freq = obj->freq;
+    rec.misc_freq = obj->misc.freq;
+#ifdef SUPPORT_TTL
+    rec.exp_time = obj->exp_time;
+#else
+    rec.exp_time = 0;
+#endif
+    rec.insert_time = obj->insert_time;
+    if (!snapshot_write(ofile, &rec, sizeof(rec))) return false;
+    /* lfu is the first member of the metadata union */
+    if (md_size > 0 && !snapshot_write(ofile, &obj->lfu, md_size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool snapshot_read_queue(cache_t *cache, FILE *ifile, cache_obj_t **head,
+                         cache_obj_t **tail, size_t md_size) {
+  int64_t n_obj;
+  if (!snapshot_read(ifile, &n_obj, sizeof(n_obj)) || n_obj < 0) return false;
+
+  request_t *req = new_request();
+  snapshot_obj_t rec;
+  bool ok = true;
+  for (int64_t i = 0; i < n_obj; i++) {
+    if (!snapshot_read(ifile, &rec, sizeof(rec))) {
+      ok = false;
+      break;
+    }
+    req->obj_id = rec.obj_id;
+    req->obj_size = rec.obj_size;
+    req->ttl = 0;
+    if (hashtable_find_obj_id(cache->hashtable, rec.obj_id) != NULL) {
+      WARN("obj %ld appears twice in the snapshot\n", (long)rec.obj_id);
+      ok = false;
+      break;
+    }
+    cache_obj_t *obj = cache_insert_base(cache, req);
+    if (obj == NULL) {
+      WARN("cannot insert obj %ld\n", (long)rec.obj_id);
+      ok = false;
+      break;
+    }
+    obj->freq = rec.freq;
+    obj->misc.freq = rec.misc_freq;
+#ifdef SUPPORT_TTL
+    obj->exp_time = rec.exp_time;
+#endif
+    obj->insert_time = rec.insert_time;
+    if (md_size > 0 && !snapshot_read(ifile, &obj->lfu, md_size)) {
+      ok = false;
+    }
+    append_obj_to_tail(head, tail, obj);
+    if (!ok) break;
+  }
+  free_request(req);
+  return ok;
+}
+
+int64_t snapshot_obj_pos(const cache_obj_t *head, const cache_obj_t *obj) {
+  if (obj == NULL) return -1;
+  int64_t pos = 0;
+  for (const cache_obj_t *o = head; o != NULL; o = o->queue.next, pos++) {
+    if (o == obj) return pos;
+  }
+  return -1;
+}
+
+cache_obj_t *snapshot_obj_at_pos(cache_obj_t *head, int64_t pos) {
+  if (pos < 0) return NULL;
+  cache_obj_t *obj = head;
+  while (obj != NULL && pos-- > 0) obj = obj->queue.next;
+  return obj;
+}
+
+bool cache_snapshot_write(const cache_t *cache, FILE *ofile) {
+  if (cache->snapshot == NULL) {
+    WARN("%s does not support snapshot\n", cache->cache_name);
+    return false;
+  }
+
+  int64_t n_obj = cache->get_n_obj(cache);
+  int64_t occupied_byte = cache->get_occupied_byte(cache);
+  bool ok = snapshot_write(ofile, cache->cache_name, CACHE_NAME_ARRAY_LEN) &&
+            snapshot_write(ofile, &cache->cache_size, sizeof(int64_t)) &&
+            snapshot_write(ofile, &cache->n_req, sizeof(int64_t)) &&
+            snapshot_write(ofile, &n_obj, sizeof(int64_t)) &&
+            snapshot_write(ofile, &occupied_byte, sizeof(int64_t));
+
+  return ok && cache->snapshot(cache, ofile);
+}
+
+bool cache_snapshot_read(cache_t *cache, FILE *ifile) {
+  if (cache->restore == NULL) {
+    WARN("%s does not support restore\n", cache->cache_name);
+    return false;
+  }
+  if (cache->get_n_obj(cache) != 0) {
+    WARN("%s must be empty before restore\n", cache->cache_name);
+    return false;
+  }
+
+  char cache_name[CACHE_NAME_ARRAY_LEN];
+  int64_t cache_size, n_req, n_obj, occupied_byte;
+  if (!snapshot_read(ifile, cache_name, CACHE_NAME_ARRAY_LEN) ||
+      !snapshot_read(ifile, &cache_size, sizeof(int64_t)) ||
+      !snapshot_read(ifile, &n_req, sizeof(int64_t)) ||
+      !snapshot_read(ifile, &n_obj, sizeof(int64_t)) ||
+      !snapshot_read(ifile, &occupied_byte, sizeof(int64_t))) {
+    WARN("truncated snapshot\n");
+    return false;
+  }
+  cache_name[CACHE_NAME_ARRAY_LEN - 1] = '\0';
+
+  size_t len = _algo_name_len(cache_name);
+  if (len != _algo_name_len(cache->cache_name) ||
+      strncmp(cache_name, cache->cache_name, len) != 0) {
+    WARN("cannot restore a %s snapshot into %s\n", cache_name,
+          cache->cache_name);
+    return false;
+  }
+  if (strcmp(cache_name, cache->cache_name) != 0 ||
+      cache_size != cache->cache_size) {
+    INFO("restore %s (size %ld) into %s (size %ld)\n", cache_name,
+         (long)cache_size, cache->cache_name, (long)cache->cache_size);
+  }
+
+  cache->n_req = n_req;
+  if (!cache->restore(cache, ifile)) {
+    WARN("cannot restore %s, the snapshot is truncated or corrupted\n",
+          cache->cache_name);
+    return false;
+  }
+  if (cache->get_n_obj(cache) != n_obj) {
+    WARN("%s restored %ld objects, the snapshot has %ld\n", cache->cache_name,
+          (long)cache->get_n_obj(cache), (long)n_obj);
+    return false;
+  }
+  return true;
+}
+
+bool cache_snapshot_to_buf(const cache_t *cache, char **buf, size_t *size) {
+  *buf = NULL;
+  *size = 0;
+  FILE *ofile = open_memstream(buf, size);
+  if (ofile == NULL) {
+    WARN("cannot open memory stream %s\n", strerror(errno));
+    return false;
+  }
+  bool ok = cache_snapshot_write(cache, ofile);
+  if (fclose(ofile) != 0) ok = false;
+  if (!ok) {
+    free(*buf);
+    *buf = NULL;
+    *size = 0;
+  }
+  return ok;
+}
+
+bool cache_snapshot_from_buf(cache_t *cache, const char *buf, size_t size) {
+  /* the stream is read-only, so the buffer is not modified */
+  FILE *ifile = fmemopen((void *)buf, size, "rb");
+  if (ifile == NULL) {
+    WARN("cannot open memory stream %s\n", strerror(errno));
+    return false;
+  }
+  bool ok = cache_snapshot_read(cache, ifile);
+  fclose(ifile);
+  return ok;
+}
+
+bool cache_copy_state(const cache_t *src, cache_t *dst) {
+  char *buf;
+  size_t size;
+  if (!cache_snapshot_to_buf(src, &buf, &size)) return false;
+  bool ok = cache_snapshot_from_buf(dst, buf, size);
+  free(buf);
+  return ok;
+}
+
+cache_t *clone_cache_with_state(const cache_t *cache) {
+  if (cache->snapshot == NULL || cache->restore == NULL) {
+    WARN("%s does not support snapshot, cannot clone its state\n",
+         cache->cache_name);
+    return NULL;
+  }
+  cache_t *new_cache = clone_cache(cache);
+  if (!cache_copy_state(cache, new_cache)) {
+    new_cache->cache_free(new_cache);
+    return NULL;
+  }
+  return new_cache;
+}
+
+bool cache_snapshot_save(const cache_t *cache, const reader_t *reader,
+                         const char *path) {
+  /* write to a temporary file and rename, so that a crash while writing
+   * does not destroy the previous snapshot */
+  char tmp_path[1024];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  FILE *ofile = fopen(tmp_path, "wb");
+  if (ofile == NULL) {
+    WARN("cannot open %s %s\n", tmp_path, strerror(errno));
+    return false;
+  }
+
+  uint32_t version = CACHE_SNAPSHOT_VERSION;
+  uint32_t has_reader = reader != NULL;
+  bool ok = snapshot_write(ofile, CACHE_SNAPSHOT_MAGIC,
+                           sizeof(CACHE_SNAPSHOT_MAGIC)) &&
+            snapshot_write(ofile, &version, sizeof(version)) &&
+            snapshot_write(ofile, &has_reader, sizeof(has_reader));
+  if (ok && reader != NULL) {
+    reader_pos_t pos;
+    reader_get_pos(reader, &pos);
+    ok = snapshot_write(ofile, &pos.n_read_req, sizeof(pos.n_read_req)) &&
+         snapshot_write(ofile, &pos.offset, sizeof(pos.offset)) &&
+         snapshot_write(ofile, &pos.n_req_left, sizeof(pos.n_req_left)) &&
+         snapshot_write(ofile, &pos.last_req_clock_time,
+                        sizeof(pos.last_req_clock_time));
+  }
+  ok = ok && cache_snapshot_write(cache, ofile);
+
+  if (fclose(ofile) != 0) ok = false;
+  if (ok && rename(tmp_path, path) != 0) {
+    WARN("cannot rename %s to %s %s\n", tmp_path, path, strerror(errno));
+    ok = false;
+  }
+  if (!ok) {
+    WARN("fail to write snapshot %s\n", path);
+    remove(tmp_path);
+  }
+  return ok;
+}
+
+bool cache_snapshot_load(cache_t *cache, reader_t *reader, const char *path) {
+  FILE *ifile = fopen(path, "rb");
+  if (ifile == NULL) {
+    WARN("cannot open %s %s\n", path, strerror(errno));
+    return false;
+  }
+
+  char magic[sizeof(CACHE_SNAPSHOT_MAGIC)];
+  uint32_t version, has_reader;
+  if (!snapshot_read(ifile, magic, sizeof(magic)) ||
+      memcmp(magic, CACHE_SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+      !snapshot_read(ifile, &version, sizeof(version)) ||
+      !snapshot_read(ifile, &has_reader, sizeof(has_reader))) {
+    WARN("%s is not a cache snapshot\n", path);
+    fclose(ifile);
+    return false;
+  }
+  if (version != CACHE_SNAPSHOT_VERSION) {
+    WARN("%s has snapshot version %u, expect %u\n", path, version,
+          CACHE_SNAPSHOT_VERSION);
+    fclose(ifile);
+    return false;
+  }
+
+  bool ok = true;
+  reader_pos_t pos;
+  if (has_reader) {
+    ok = snapshot_read(ifile, &pos.n_read_req, sizeof(pos.n_read_req)) &&
+         snapshot_read(ifile, &pos.offset, sizeof(pos.offset)) &&
+         snapshot_read(ifile, &pos.n_req_left, sizeof(pos.n_req_left)) &&
+         snapshot_read(ifile, &pos.last_req_clock_time,
+                       sizeof(pos.last_req_clock_time));
+  }
+  ok = ok && cache_snapshot_read(cache, ifile);
+  fclose(ifile);
+
+  if (ok && reader != NULL) {
+    if (!has_reader) {
+      WARN("%s does not have the reader position, the reader is not moved\n",
+           path);
+    } else {
+      ok = reader_set_pos(reader, &pos);
+    }
+  }
+  return ok;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,21 @@
 // AdaptiveClimb.c - Original AdaptiveClimb eviction algorithm (no frequency)
+//
+// a hit climbs jump positions towards the head, a miss is inserted at the
+// head and the tail is evicted, jump adapts to the recent miss rate
+//
+// the queue positions are indexed by an order-statistic tree so that a long
+// climb costs O(log n) instead of a walk over the queue
+//
+// size-aware mode (-e size-aware=true) splits the objects into size classes
+// of a factor of 4 each, every class has its own controller and its climb
+// step is scaled by the byte-weighted benefit of the class, i.e., the bytes
+// hit per byte of cache space the class occupies relative to the whole
+// cache, the object and byte miss ratio of each class are reported at free
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../dataStructure/orderStatTree.h"
+#include "../../dataStructure/slidingWindow.h"
+#include "../../include/libCacheSim/cacheSnapshot.h"
+#include "../../include/libCacheSim/evictionAlgo/climbEventLog.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 #include <stdio.h>
 #include <math.h>
@@ -10,117 +26,242 @@
 extern "C" {
 #endif
 
-typedef struct AdaptiveClimb_params {
+static const char *DEFAULT_CACHE_PARAMS =
+    "hit-miss-window=1000,adjustment-interval=1000,min-k=5,max-k=5000,event-log-ring-size=4096,"
+    "size-aware=false,n-size-class=16";
+
+#define MAX_N_SIZE_CLASS 32
+// the climb step of a size class is scaled by at most this factor either way
+#define MAX_BENEFIT_SCALE 8.0
+// a climb of at most this many positions walks the queue, walking is
+// cheaper than the rank and select of the position index for short climbs
+#define CLIMB_WALK_MAX_JUMP 32
+
+// the controller and the statistics of one size class
+typedef struct {
+    sliding_window_t *recent_hits;
     int jump;
     int K;
+    double last_miss_rate;
+    // bytes hit recently, halved every adjustment interval
+    double recent_hit_byte;
+    int64_t occupied_byte;
+    climb_size_class_stat_t stat;
+} climb_size_class_t;
+
+typedef struct AdaptiveClimb_params {
+    // q_head must stay the first member, print_cache_obj_ids relies on it
     cache_obj_t *q_head;
     cache_obj_t *q_tail;
-} AdaptiveClimb_params_t;
+    // position of every object in the queue, q_head is at position 1
+    ost_t *pos_index;
+    int jump;
+    int K;
 
-#define HIT_MISS_WINDOW 1000
-#define ADJUSTMENT_INTERVAL 1000
-#define MIN_K 5
-#define MAX_K 5000
+    // tunable with -e, see DEFAULT_CACHE_PARAMS
+    int hit_miss_window;
+    int adjustment_interval;
+    int min_k;
+    int max_k;
 
-static int recent_hits[HIT_MISS_WINDOW];
-static int hit_miss_ptr = 0;
-static int total_requests = 0;
-static int recent_hit_count = 0;
-static double last_miss_rate = 0.0;
+    // adaptive state, kept per instance so that caches simulated
+    // concurrently (e.g., simulate_with_multi_caches) do not share it
+    sliding_window_t *recent_hits;
+    int64_t total_requests;
+    double last_miss_rate;
 
-static void update_hit_miss_window(int hit) {
-    if (recent_hits[hit_miss_ptr]) recent_hit_count--;
-    recent_hits[hit_miss_ptr] = hit;
-    if (hit) recent_hit_count++;
-    hit_miss_ptr = (hit_miss_ptr + 1) % HIT_MISS_WINDOW;
+    // controller event log, enabled with event-log=<path>
+    char *event_log_path;
+    int64_t event_log_ring_size;
+    climb_event_log_t *event_log;
+
+    // size-aware mode
+    bool size_aware;
+    int n_size_class;
+    climb_size_class_t *size_classes;
+    // bytes hit recently over all classes, halved with the classes
+    double recent_hit_byte;
+} AdaptiveClimb_params_t;
+
+static void AdaptiveClimb_parse_params(cache_t *cache, const char *cache_specific_params);
+
+static void update_hit_miss_window(AdaptiveClimb_params_t *params, int hit) {
+    sliding_window_add(params->recent_hits, hit);
 }
 
-static void adjust_k_parameter(AdaptiveClimb_params_t *params) {
-    if (total_requests % ADJUSTMENT_INTERVAL != 0) return;
-    double miss_rate = 1.0 - ((double)recent_hit_count / HIT_MISS_WINDOW);
+// a rising miss rate climbs further, a falling one climbs less
+static void step_controller(int *K, int *jump, double miss_rate, double last_miss_rate, int min_k, int max_k) {
     if (miss_rate > last_miss_rate) {
-        params->K = (params->K > MIN_K) ? params->K - 2 : MIN_K;
-        params->jump = (params->jump < MAX_K) ? params->jump + 2 : MAX_K;
+        *K = (*K > min_k) ? *K - 2 : min_k;
+        *jump = (*jump < max_k) ? *jump + 2 : max_k;
     } else {
-        params->K = (params->K < MAX_K) ? params->K + 2 : MAX_K;
-        params->jump = (params->jump > MIN_K) ? params->jump - 2 : MIN_K;
+        *K = (*K < max_k) ? *K + 2 : max_k;
+        *jump = (*jump > min_k) ? *jump - 2 : min_k;
     }
-    last_miss_rate = miss_rate;
 }
 
-static void AdaptiveClimb_free(cache_t *cache) {
-    free(cache->eviction_params);
-    cache_struct_free(cache);
+static void adjust_k_parameter(AdaptiveClimb_params_t *params) {
+    if (params->total_requests % params->adjustment_interval != 0) return;
+    double miss_rate = 1.0 - sliding_window_hit_ratio(params->recent_hits);
+    step_controller(&params->K, &params->jump, miss_rate, params->last_miss_rate, params->min_k, params->max_k);
+    params->last_miss_rate = miss_rate;
+
+    if (params->event_log != NULL) {
+        climb_event_t event = {.n_req = params->total_requests,
+                               .miss_ratio = miss_rate,
+                               .ema_miss_ratio = miss_rate,
+                               .K = params->K,
+                               .jump = params->jump};
+        climb_event_log_record(params->event_log, &event);
+    }
 }
 
-static bool AdaptiveClimb_get(cache_t *cache, const request_t *req) {
-    AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
-    cache_obj_t *obj = cache_find_base(cache, req, true);
-    if (!obj) return false;
-    total_requests++;
-    update_hit_miss_window(1);
-    adjust_k_parameter(params);
-    // Remove from current position
-    if (obj->queue.prev) {
-        obj->queue.prev->queue.next = obj->queue.next;
+// size classes are powers of 4: [1, 4), [4, 16), ..., the last class
+// holds everything larger
+static inline climb_size_class_t *get_size_class(AdaptiveClimb_params_t *params, int64_t obj_size) {
+    int c = obj_size > 1 ? (63 - __builtin_clzll((uint64_t)obj_size)) / 2 : 0;
+    return &params->size_classes[c < params->n_size_class ? c : params->n_size_class - 1];
+}
+
+// the per-class version of update_hit_miss_window and adjust_k_parameter,
+// each class adjusts after every adjustment-interval of its own requests
+static void record_size_class_request(AdaptiveClimb_params_t *params, climb_size_class_t *cls,
+                                      int64_t obj_size, int hit) {
+    cls->stat.n_req += 1;
+    cls->stat.n_req_byte += obj_size;
+    if (hit) {
+        cls->recent_hit_byte += obj_size;
+        params->recent_hit_byte += obj_size;
     } else {
-        params->q_head = obj->queue.next;
+        cls->stat.n_miss += 1;
+        cls->stat.n_miss_byte += obj_size;
+    }
+
+    sliding_window_add(cls->recent_hits, hit);
+    if (cls->stat.n_req % params->adjustment_interval == 0) {
+        double miss_rate = 1.0 - sliding_window_hit_ratio(cls->recent_hits);
+        step_controller(&cls->K, &cls->jump, miss_rate, cls->last_miss_rate, params->min_k, params->max_k);
+        cls->last_miss_rate = miss_rate;
+    }
+
+    // forget old hits so that the benefit follows the workload
+    if (params->total_requests % params->adjustment_interval == 0) {
+        for (int i = 0; i < params->n_size_class; i++) {
+            params->size_classes[i].recent_hit_byte /= 2;
+        }
+        params->recent_hit_byte /= 2;
+    }
+}
+
+// record one user request in the hit/miss window and run the controller
+static void record_request(AdaptiveClimb_params_t *params, const request_t *req, int hit) {
+    params->total_requests++;
+    update_hit_miss_window(params, hit);
+    adjust_k_parameter(params);
+    if (params->size_aware) {
+        record_size_class_request(params, get_size_class(params, req->obj_size), req->obj_size, hit);
     }
-    if (obj->queue.next) {
-        obj->queue.next->queue.prev = obj->queue.prev;
+}
+
+// the climb step of a size class: the class jump scaled by the bytes the
+// class hits per byte of cache space relative to the whole cache, so classes
+// that save more egress per byte cached climb further
+static int size_class_jump(const cache_t *cache, AdaptiveClimb_params_t *params, const climb_size_class_t *cls) {
+    int64_t occupied_byte = cache->get_occupied_byte(cache);
+    if (cls->occupied_byte <= 0 || occupied_byte <= 0 || params->recent_hit_byte <= 0) return cls->jump;
+
+    double benefit = cls->recent_hit_byte / (double)cls->occupied_byte;
+    double avg_benefit = params->recent_hit_byte / (double)occupied_byte;
+    double scale = benefit / avg_benefit;
+    if (scale > MAX_BENEFIT_SCALE) scale = MAX_BENEFIT_SCALE;
+    if (scale < 1.0 / MAX_BENEFIT_SCALE) scale = 1.0 / MAX_BENEFIT_SCALE;
+
+    int jump = (int)(cls->jump * scale + 0.5);
+    return jump > 1 ? jump : 1;
+}
+
+// move obj jump positions towards the head, a short climb walks the queue
+// to find where obj goes, a long one asks the position index, then obj is
+// unlinked and linked again in both without computing a position
+static void climb(AdaptiveClimb_params_t *params, cache_obj_t *obj, int jump) {
+    if (obj == params->q_head) return;
+
+    // obj is placed in front of target
+    cache_obj_t *target = obj;
+    if (jump <= CLIMB_WALK_MAX_JUMP) {
+        for (int i = 0; i < jump && target->queue.prev != NULL; i++) target = target->queue.prev;
     } else {
-        params->q_tail = obj->queue.prev;
+        int64_t pos = ost_rank((ost_node_t *)obj->climb.pos_node);
+        target = pos > jump ? (cache_obj_t *)ost_select(params->pos_index, pos - jump)->data : params->q_head;
     }
-    // Move to head (recency)
-    obj->queue.next = params->q_head;
-    obj->queue.prev = NULL;
-    if (params->q_head) {
-        params->q_head->queue.prev = obj;
+    if (target == obj) return;
+
+    if (target == params->q_head) {
+        move_obj_to_head(&params->q_head, &params->q_tail, obj);
     } else {
-        params->q_tail = obj;
+        remove_obj_from_list(&params->q_head, &params->q_tail, obj);
+        insert_obj_after(&params->q_head, &params->q_tail, target->queue.prev, obj);
     }
-    params->q_head = obj;
-    return true;
+    ost_move_before(params->pos_index, (ost_node_t *)obj->climb.pos_node, (ost_node_t *)target->climb.pos_node);
 }
 
-static cache_obj_t *AdaptiveClimb_find(cache_t *cache, const request_t *req, const bool update_cache) {
-    return cache_find_base(cache, req, update_cache);
+static void AdaptiveClimb_free(cache_t *cache) {
+    AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
+    ost_free(params->pos_index);
+    sliding_window_free(params->recent_hits);
+    if (params->event_log != NULL) climb_event_log_close(params->event_log);
+    free(params->event_log_path);
+    if (params->size_aware) {
+        for (int i = 0; i < params->n_size_class; i++) {
+            const climb_size_class_stat_t *stat = &params->size_classes[i].stat;
+            if (stat->n_req == 0) continue;
+            INFO("%s cache size %ld size class %d (>= %lld bytes): %ld requests, miss ratio %.4lf, "
+                 "byte miss ratio %.4lf\n",
+                 cache->cache_name, (long)cache->cache_size, i, i == 0 ? 0LL : 1LL << (2 * i), (long)stat->n_req,
+                 (double)stat->n_miss / stat->n_req, (double)stat->n_miss_byte / stat->n_req_byte);
+        }
+        for (int i = 0; i < params->n_size_class; i++) {
+            sliding_window_free(params->size_classes[i].recent_hits);
+        }
+        free(params->size_classes);
+    }
+    free(cache->eviction_params);
+    cache_struct_free(cache);
 }
 
-static cache_obj_t *AdaptiveClimb_insert(cache_t *cache, const request_t *req) {
+// hit: climb, miss: evict until there is space and insert at head
+static bool AdaptiveClimb_get(cache_t *cache, const request_t *req) {
+    return cache_get_base(cache, req);
+}
+
+// prefetch the hash buckets of the requests ahead, see cache_get_batch_prefetch
+static void AdaptiveClimb_get_batch(cache_t *cache, request_t *reqs, int n, bool *hits) {
+    cache_get_batch_prefetch(cache, reqs, n, hits, AdaptiveClimb_get);
+}
+
+static cache_obj_t *AdaptiveClimb_find(cache_t *cache, const request_t *req, const bool update_cache) {
     AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
-    cache_obj_t *obj = cache_find_base(cache, req, false);
+    cache_obj_t *obj = cache_find_base(cache, req, update_cache);
+    if (!update_cache) return obj;
+
+    record_request(params, req, obj != NULL);
     if (obj) {
-        AdaptiveClimb_get(cache, req);
-        return obj;
-    }
-    total_requests++;
-    update_hit_miss_window(0);
-    adjust_k_parameter(params);
-    // Evict if needed
-    while (cache->get_occupied_byte(cache) + req->obj_size + cache->obj_md_size > cache->cache_size) {
-        cache_obj_t *victim = params->q_tail;
-        if (!victim) break;
-        // Remove from queue
-        if (victim->queue.prev) {
-            victim->queue.prev->queue.next = NULL;
-        } else {
-            params->q_head = NULL;
+        int jump = params->jump;
+        if (params->size_aware) {
+            jump = size_class_jump(cache, params, get_size_class(params, obj->obj_size));
         }
-        params->q_tail = victim->queue.prev;
-        cache_evict_base(cache, victim, true);
+        climb(params, obj, jump);
     }
-    // Insert new object at head
-    obj = cache_insert_base(cache, req);
-    if (obj) {
-        obj->queue.next = params->q_head;
-        obj->queue.prev = NULL;
-        if (params->q_head) {
-            params->q_head->queue.prev = obj;
-        } else {
-            params->q_tail = obj;
-        }
-        params->q_head = obj;
+    return obj;
+}
+
+static cache_obj_t *AdaptiveClimb_insert(cache_t *cache, const request_t *req) {
+    AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
+    cache_obj_t *obj = cache_insert_base(cache, req);
+    prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
+    obj->climb.pos_node = ost_push_front(params->pos_index, obj);
+    if (params->size_aware) {
+        get_size_class(params, obj->obj_size)->occupied_byte += obj->obj_size;
     }
     return obj;
 }
@@ -134,6 +275,10 @@ static void AdaptiveClimb_evict(cache_t *cache, const request_t *req) {
     AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
     cache_obj_t *victim = params->q_tail;
     if (!victim) return;
+    ost_remove(params->pos_index, (ost_node_t *)victim->climb.pos_node);
+    if (params->size_aware) {
+        get_size_class(params, victim->obj_size)->occupied_byte -= victim->obj_size;
+    }
     // Remove from queue
     if (victim->queue.prev) {
         victim->queue.prev->queue.next = NULL;
@@ -148,40 +293,188 @@ static bool AdaptiveClimb_remove(cache_t *cache, const obj_id_t obj_id) {
     cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
     if (!obj) return false;
     AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
-    // Remove from queue
-    if (obj->queue.prev) {
-        obj->queue.prev->queue.next = obj->queue.next;
-    } else {
-        params->q_head = obj->queue.next;
-    }
-    if (obj->queue.next) {
-        obj->queue.next->queue.prev = obj->queue.prev;
-    } else {
-        params->q_tail = obj->queue.prev;
+    ost_remove(params->pos_index, (ost_node_t *)obj->climb.pos_node);
+    if (params->size_aware) {
+        get_size_class(params, obj->obj_size)->occupied_byte -= obj->obj_size;
     }
+    remove_obj_from_list(&params->q_head, &params->q_tail, obj);
     cache_remove_obj_base(cache, obj, true);
     return true;
 }
 
+// the controllers and the queue, the position index is rebuilt on restore
+static bool AdaptiveClimb_snapshot(const cache_t *cache, FILE *ofile) {
+    AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
+    bool ok = snapshot_write(ofile, &params->jump, sizeof(int)) && snapshot_write(ofile, &params->K, sizeof(int)) &&
+              snapshot_write(ofile, &params->total_requests, sizeof(int64_t)) &&
+              snapshot_write(ofile, &params->last_miss_rate, sizeof(double)) &&
+              snapshot_write(ofile, &params->recent_hit_byte, sizeof(double)) &&
+              sliding_window_save(params->recent_hits, ofile);
+
+    int n_size_class = params->size_aware ? params->n_size_class : 0;
+    ok = ok && snapshot_write(ofile, &n_size_class, sizeof(int));
+    for (int i = 0; ok && i < n_size_class; i++) {
+        const climb_size_class_t *cls = &params->size_classes[i];
+        ok = snapshot_write(ofile, &cls->jump, sizeof(int)) && snapshot_write(ofile, &cls->K, sizeof(int)) &&
+             snapshot_write(ofile, &cls->last_miss_rate, sizeof(double)) &&
+             snapshot_write(ofile, &cls->recent_hit_byte, sizeof(double)) &&
+             snapshot_write(ofile, &cls->stat, sizeof(climb_size_class_stat_t)) &&
+             sliding_window_save(cls->recent_hits, ofile);
+    }
+
+    return ok && snapshot_write_queue(ofile, params->q_head, 0);
+}
+
+// the size classes are restored only if the cache has the same classes as
+// the snapshot, otherwise they start fresh
+static bool AdaptiveClimb_restore(cache_t *cache, FILE *ifile) {
+    AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
+    int n_size_class;
+    bool ok = snapshot_read(ifile, &params->jump, sizeof(int)) && snapshot_read(ifile, &params->K, sizeof(int)) &&
+              snapshot_read(ifile, &params->total_requests, sizeof(int64_t)) &&
+              snapshot_read(ifile, &params->last_miss_rate, sizeof(double)) &&
+              snapshot_read(ifile, &params->recent_hit_byte, sizeof(double)) &&
+              sliding_window_load(params->recent_hits, ifile) && snapshot_read(ifile, &n_size_class, sizeof(int));
+
+    bool same_classes = params->size_aware && n_size_class == params->n_size_class;
+    // the windows of the classes have the size of the window read above
+    climb_size_class_t dropped = {.recent_hits = sliding_window_create(params->hit_miss_window)};
+    for (int i = 0; ok && i < n_size_class; i++) {
+        climb_size_class_t *cls = same_classes ? &params->size_classes[i] : &dropped;
+        ok = snapshot_read(ifile, &cls->jump, sizeof(int)) && snapshot_read(ifile, &cls->K, sizeof(int)) &&
+             snapshot_read(ifile, &cls->last_miss_rate, sizeof(double)) &&
+             snapshot_read(ifile, &cls->recent_hit_byte, sizeof(double)) &&
+             snapshot_read(ifile, &cls->stat, sizeof(climb_size_class_stat_t)) &&
+             sliding_window_load(cls->recent_hits, ifile);
+    }
+    sliding_window_free(dropped.recent_hits);
+    if (params->size_aware && !same_classes) params->recent_hit_byte = 0;
+
+    if (!ok || !snapshot_read_queue(cache, ifile, &params->q_head, &params->q_tail, 0)) return false;
+    for (cache_obj_t *obj = params->q_head; obj != NULL; obj = obj->queue.next) {
+        obj->climb.pos_node = ost_push_back(params->pos_index, obj);
+        if (params->size_aware) {
+            get_size_class(params, obj->obj_size)->occupied_byte += obj->obj_size;
+        }
+    }
+    return true;
+}
+
 cache_t *AdaptiveClimb_init(const common_cache_params_t ccache_params, const char *cache_specific_params) {
     cache_t *cache = cache_struct_init("AdaptiveClimb", ccache_params, cache_specific_params);
     cache->cache_init = AdaptiveClimb_init;
     cache->cache_free = AdaptiveClimb_free;
     cache->get = AdaptiveClimb_get;
+    cache->get_batch = AdaptiveClimb_get_batch;
     cache->find = AdaptiveClimb_find;
     cache->insert = AdaptiveClimb_insert;
     cache->evict = AdaptiveClimb_evict;
     cache->remove = AdaptiveClimb_remove;
     cache->to_evict = AdaptiveClimb_to_evict;
+    cache->snapshot = AdaptiveClimb_snapshot;
+    cache->restore = AdaptiveClimb_restore;
     AdaptiveClimb_params_t *params = malloc(sizeof(AdaptiveClimb_params_t));
+    memset(params, 0, sizeof(AdaptiveClimb_params_t));
     params->K = 10;
     params->jump = 1;
     params->q_head = NULL;
     params->q_tail = NULL;
+    params->pos_index = ost_create();
     cache->eviction_params = params;
+
+    AdaptiveClimb_parse_params(cache, DEFAULT_CACHE_PARAMS);
+    if (cache_specific_params != NULL) {
+        AdaptiveClimb_parse_params(cache, cache_specific_params);
+    }
+    params->recent_hits = sliding_window_create(params->hit_miss_window);
+    if (params->size_aware) {
+        params->size_classes = calloc(params->n_size_class, sizeof(climb_size_class_t));
+        for (int i = 0; i < params->n_size_class; i++) {
+            params->size_classes[i].K = params->K;
+            params->size_classes[i].jump = params->jump;
+            params->size_classes[i].recent_hits = sliding_window_create(params->hit_miss_window);
+        }
+        snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "AdaptiveClimb-size%d", params->n_size_class);
+    }
+    if (params->event_log_path != NULL) {
+        // caches resized or cloned from the same params get their own file
+        char path[512];
+        snprintf(path, sizeof(path), "%s.%s.%ld", params->event_log_path, cache->cache_name,
+                 (long)cache->cache_size);
+        params->event_log = climb_event_log_open(path, params->event_log_ring_size);
+    }
     return cache;
 }
 
+int AdaptiveClimb_get_size_class_stats(const cache_t *cache, climb_size_class_stat_t *stats, int n) {
+    AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
+    if (!params->size_aware) return 0;
+    int n_class = params->n_size_class < n ? params->n_size_class : n;
+    for (int i = 0; i < n_class; i++) {
+        stats[i] = params->size_classes[i].stat;
+    }
+    return n_class;
+}
+
+static const char *AdaptiveClimb_current_params(AdaptiveClimb_params_t *params) {
+    static __thread char params_str[192];
+    snprintf(params_str, 192, "hit-miss-window=%d,adjustment-interval=%d,min-k=%d,max-k=%d,size-aware=%d,n-size-class=%d\n",
+             params->hit_miss_window, params->adjustment_interval, params->min_k, params->max_k, params->size_aware,
+             params->n_size_class);
+    return params_str;
+}
+
+static void AdaptiveClimb_parse_params(cache_t *cache, const char *cache_specific_params) {
+    AdaptiveClimb_params_t *params = (AdaptiveClimb_params_t *)cache->eviction_params;
+    char *params_str = strdup(cache_specific_params);
+    char *old_params_str = params_str;
+
+    while (params_str != NULL && params_str[0] != '\0') {
+        /* different parameters are separated by comma,
+         * key and value are separated by = */
+        char *key = strsep((char **)&params_str, "=");
+        char *value = strsep((char **)&params_str, ",");
+
+        // skip the white space
+        while (params_str != NULL && *params_str == ' ') {
+            params_str++;
+        }
+
+        if (strcasecmp(key, "hit-miss-window") == 0) {
+            params->hit_miss_window = atoi(value);
+        } else if (strcasecmp(key, "adjustment-interval") == 0) {
+            params->adjustment_interval = atoi(value);
+        } else if (strcasecmp(key, "min-k") == 0) {
+            params->min_k = atoi(value);
+        } else if (strcasecmp(key, "max-k") == 0) {
+            params->max_k = atoi(value);
+        } else if (strcasecmp(key, "event-log") == 0) {
+            free(params->event_log_path);
+            params->event_log_path = strdup(value);
+        } else if (strcasecmp(key, "event-log-ring-size") == 0) {
+            params->event_log_ring_size = atol(value);
+        } else if (strcasecmp(key, "size-aware") == 0) {
+            params->size_aware = strcasecmp(value, "true") == 0 || strcmp(value, "1") == 0;
+        } else if (strcasecmp(key, "n-size-class") == 0) {
+            params->n_size_class = atoi(value);
+        } else if (strcasecmp(key, "print") == 0) {
+            printf("parameters: %s\n", AdaptiveClimb_current_params(params));
+            exit(0);
+        } else {
+            ERROR("%s does not have parameter %s\n", cache->cache_name, key);
+            exit(1);
+        }
+    }
+
+    if (params->hit_miss_window <= 0 || params->adjustment_interval <= 0 || params->min_k <= 0 ||
+        params->min_k > params->max_k || params->n_size_class <= 0 || params->n_size_class > MAX_N_SIZE_CLASS) {
+        ERROR("%s invalid parameters %s\n", cache->cache_name, AdaptiveClimb_current_params(params));
+        exit(1);
+    }
+
+    free(old_params_str);
+}
+
 #ifdef __cplusplus
 }
-#endif 
\ No newline at end of file
+#endif
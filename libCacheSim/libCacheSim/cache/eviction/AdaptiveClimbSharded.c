@@ -0,0 +1,281 @@
+// AdaptiveClimbSharded.c - thread-safe AdaptiveClimb
+//
+// the key space is split over n-shard independent AdaptiveClimb caches,
+// each shard has its own hashtable, queue and controller, and is protected
+// by its own spinlock, so threads only contend when they access the same shard
+//
+// each shard gets cache_size / n-shard bytes, the other parameters are passed
+// to every shard, e.g., -e n-shard=16,min-k=5, except that the event log of
+// shard i is written to <event-log>.shard<i>
+//
+// the hit ratio of the whole cache is read with AdaptiveClimbSharded_get_hit_ratio
+//
+// find, insert and to_evict return a copy of the object taken while the shard
+// is locked, the object in the shard may be evicted by another thread as soon
+// as the lock is released, the copy is per thread and valid until the next
+// call, changing it does not change the cache
+#include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/evictionAlgo.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CACHE_LINE_SIZE 64
+
+static const char *DEFAULT_CACHE_PARAMS = "n-shard=16";
+
+// one shard per cache line so that the locks do not false-share
+typedef struct {
+    pthread_spinlock_t lock;
+    cache_t *cache;
+    int64_t n_req;
+    int64_t n_hit;
+} __attribute__((aligned(CACHE_LINE_SIZE))) climb_shard_t;
+
+typedef struct AdaptiveClimbSharded_params {
+    int n_shard;
+    climb_shard_t *shards;
+    // the parameters other than n-shard and event-log, passed to every shard
+    char shard_params[CACHE_INIT_PARAMS_LEN];
+    // each shard logs to its own file, NULL if the event log is disabled
+    char *event_log_path;
+} AdaptiveClimbSharded_params_t;
+
+static void AdaptiveClimbSharded_parse_params(cache_t *cache, const char *cache_specific_params);
+
+static inline climb_shard_t *get_shard(AdaptiveClimbSharded_params_t *params, obj_id_t obj_id) {
+    // the shards hash obj_id again in their hashtable, mix it differently
+    // here so that the objects of one shard do not crowd a subset of buckets
+    uint64_t x = (uint64_t)obj_id + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return &params->shards[x % params->n_shard];
+}
+
+// copy obj to the calling thread's buffer, must be called with the shard locked
+static inline cache_obj_t *copy_obj(const cache_obj_t *obj, cache_obj_t *buf) {
+    if (obj == NULL) return NULL;
+    memcpy(buf, obj, sizeof(cache_obj_t));
+    // the links point into the shard, which is not locked after return
+    buf->hash_next = NULL;
+    buf->queue.prev = NULL;
+    buf->queue.next = NULL;
+    return buf;
+}
+
+static void AdaptiveClimbSharded_free(cache_t *cache) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    for (int i = 0; i < params->n_shard; i++) {
+        params->shards[i].cache->cache_free(params->shards[i].cache);
+        pthread_spin_destroy(&params->shards[i].lock);
+    }
+    free(params->shards);
+    free(params->event_log_path);
+    free(params);
+    cache_struct_free(cache);
+}
+
+static bool AdaptiveClimbSharded_get(cache_t *cache, const request_t *req) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    climb_shard_t *shard = get_shard(params, req->obj_id);
+    pthread_spin_lock(&shard->lock);
+    int64_t n_evict = shard->cache->n_evict;
+    bool hit = shard->cache->get(shard->cache, req);
+    n_evict = shard->cache->n_evict - n_evict;
+    // read without the lock by AdaptiveClimbSharded_get_hit_ratio
+    __atomic_fetch_add(&shard->n_req, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&shard->n_hit, hit, __ATOMIC_RELAXED);
+    pthread_spin_unlock(&shard->lock);
+    // get does not go through cache_get_base, which counts the evictions of
+    // the other algorithms, the shards count theirs
+    if (n_evict > 0) __atomic_fetch_add(&cache->n_evict, n_evict, __ATOMIC_RELAXED);
+    return hit;
+}
+
+static cache_obj_t *AdaptiveClimbSharded_find(cache_t *cache, const request_t *req, const bool update_cache) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    climb_shard_t *shard = get_shard(params, req->obj_id);
+    static __thread cache_obj_t obj_copy;
+    pthread_spin_lock(&shard->lock);
+    cache_obj_t *obj = copy_obj(shard->cache->find(shard->cache, req, update_cache), &obj_copy);
+    pthread_spin_unlock(&shard->lock);
+    return obj;
+}
+
+static cache_obj_t *AdaptiveClimbSharded_insert(cache_t *cache, const request_t *req) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    climb_shard_t *shard = get_shard(params, req->obj_id);
+    static __thread cache_obj_t obj_copy;
+    pthread_spin_lock(&shard->lock);
+    cache_obj_t *obj = copy_obj(shard->cache->insert(shard->cache, req), &obj_copy);
+    pthread_spin_unlock(&shard->lock);
+    return obj;
+}
+
+static bool AdaptiveClimbSharded_can_insert(cache_t *cache, const request_t *req) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    climb_shard_t *shard = get_shard(params, req->obj_id);
+    pthread_spin_lock(&shard->lock);
+    bool can_insert = shard->cache->can_insert(shard->cache, req);
+    pthread_spin_unlock(&shard->lock);
+    return can_insert;
+}
+
+// the victim comes from the shard that req maps to
+static cache_obj_t *AdaptiveClimbSharded_to_evict(cache_t *cache, const request_t *req) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    climb_shard_t *shard = get_shard(params, req->obj_id);
+    static __thread cache_obj_t obj_copy;
+    pthread_spin_lock(&shard->lock);
+    cache_obj_t *obj = copy_obj(shard->cache->to_evict(shard->cache, req), &obj_copy);
+    pthread_spin_unlock(&shard->lock);
+    return obj;
+}
+
+static void AdaptiveClimbSharded_evict(cache_t *cache, const request_t *req) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    climb_shard_t *shard = get_shard(params, req->obj_id);
+    pthread_spin_lock(&shard->lock);
+    shard->cache->evict(shard->cache, req);
+    pthread_spin_unlock(&shard->lock);
+}
+
+static bool AdaptiveClimbSharded_remove(cache_t *cache, const obj_id_t obj_id) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    climb_shard_t *shard = get_shard(params, obj_id);
+    pthread_spin_lock(&shard->lock);
+    bool removed = shard->cache->remove(shard->cache, obj_id);
+    pthread_spin_unlock(&shard->lock);
+    return removed;
+}
+
+// the sums below do not take the locks, they may be slightly stale
+// when other threads are running
+static int64_t AdaptiveClimbSharded_get_occupied_byte(const cache_t *cache) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    int64_t occupied_byte = 0;
+    for (int i = 0; i < params->n_shard; i++) {
+        occupied_byte += params->shards[i].cache->get_occupied_byte(params->shards[i].cache);
+    }
+    return occupied_byte;
+}
+
+static int64_t AdaptiveClimbSharded_get_n_obj(const cache_t *cache) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    int64_t n_obj = 0;
+    for (int i = 0; i < params->n_shard; i++) {
+        n_obj += params->shards[i].cache->get_n_obj(params->shards[i].cache);
+    }
+    return n_obj;
+}
+
+double AdaptiveClimbSharded_get_hit_ratio(const cache_t *cache) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    int64_t n_req = 0, n_hit = 0;
+    for (int i = 0; i < params->n_shard; i++) {
+        n_req += __atomic_load_n(&params->shards[i].n_req, __ATOMIC_RELAXED);
+        n_hit += __atomic_load_n(&params->shards[i].n_hit, __ATOMIC_RELAXED);
+    }
+    return n_req == 0 ? 0 : (double)n_hit / (double)n_req;
+}
+
+cache_t *AdaptiveClimbSharded_init(const common_cache_params_t ccache_params, const char *cache_specific_params) {
+    // the objects are in the hashtables of the shards, the wrapper keeps the
+    // smallest table for the code that expects cache->hashtable, clones of the
+    // wrapper therefore start the shard tables small, they grow on demand
+    common_cache_params_t ccache_params_wrapper = ccache_params;
+    ccache_params_wrapper.hashpower = 1;
+    cache_t *cache = cache_struct_init("AdaptiveClimbSharded", ccache_params_wrapper, cache_specific_params);
+    cache->cache_init = AdaptiveClimbSharded_init;
+    cache->cache_free = AdaptiveClimbSharded_free;
+    cache->get = AdaptiveClimbSharded_get;
+    cache->find = AdaptiveClimbSharded_find;
+    cache->insert = AdaptiveClimbSharded_insert;
+    cache->evict = AdaptiveClimbSharded_evict;
+    cache->remove = AdaptiveClimbSharded_remove;
+    cache->to_evict = AdaptiveClimbSharded_to_evict;
+    cache->can_insert = AdaptiveClimbSharded_can_insert;
+    cache->get_occupied_byte = AdaptiveClimbSharded_get_occupied_byte;
+    cache->get_n_obj = AdaptiveClimbSharded_get_n_obj;
+
+    AdaptiveClimbSharded_params_t *params = malloc(sizeof(AdaptiveClimbSharded_params_t));
+    memset(params, 0, sizeof(AdaptiveClimbSharded_params_t));
+    cache->eviction_params = params;
+
+    AdaptiveClimbSharded_parse_params(cache, DEFAULT_CACHE_PARAMS);
+    if (cache_specific_params != NULL) {
+        AdaptiveClimbSharded_parse_params(cache, cache_specific_params);
+    }
+
+    common_cache_params_t ccache_params_local = ccache_params;
+    ccache_params_local.cache_size = ccache_params.cache_size / params->n_shard;
+    if (ccache_params.hashpower > 0) {
+        int hashpower = ccache_params.hashpower - (int)ceil(log2(params->n_shard));
+        ccache_params_local.hashpower = hashpower > 16 ? hashpower : 16;
+    }
+
+    params->shards = aligned_alloc(CACHE_LINE_SIZE, sizeof(climb_shard_t) * params->n_shard);
+    memset(params->shards, 0, sizeof(climb_shard_t) * params->n_shard);
+    char shard_params[CACHE_INIT_PARAMS_LEN];
+    for (int i = 0; i < params->n_shard; i++) {
+        pthread_spin_init(&params->shards[i].lock, PTHREAD_PROCESS_PRIVATE);
+        strcpy(shard_params, params->shard_params);
+        if (params->event_log_path != NULL) {
+            size_t len = strlen(shard_params);
+            snprintf(shard_params + len, CACHE_INIT_PARAMS_LEN - len, "%sevent-log=%s.shard%d",
+                     len == 0 ? "" : ",", params->event_log_path, i);
+        }
+        params->shards[i].cache =
+            AdaptiveClimb_init(ccache_params_local, shard_params[0] == '\0' ? NULL : shard_params);
+    }
+
+    snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "AdaptiveClimbSharded-%d", params->n_shard);
+    return cache;
+}
+
+static void AdaptiveClimbSharded_parse_params(cache_t *cache, const char *cache_specific_params) {
+    AdaptiveClimbSharded_params_t *params = (AdaptiveClimbSharded_params_t *)cache->eviction_params;
+    char *params_str = strdup(cache_specific_params);
+    char *old_params_str = params_str;
+
+    while (params_str != NULL && params_str[0] != '\0') {
+        /* different parameters are separated by comma,
+         * key and value are separated by = */
+        char *key = strsep((char **)&params_str, "=");
+        char *value = strsep((char **)&params_str, ",");
+
+        // skip the white space
+        while (params_str != NULL && *params_str == ' ') {
+            params_str++;
+        }
+
+        if (strcasecmp(key, "n-shard") == 0) {
+            params->n_shard = atoi(value);
+            if (params->n_shard <= 0) {
+                ERROR("%s n-shard must be positive, got %s\n", cache->cache_name, value);
+                exit(1);
+            }
+        } else if (strcasecmp(key, "event-log") == 0) {
+            free(params->event_log_path);
+            params->event_log_path = strdup(value);
+        } else {
+            // AdaptiveClimb_init reports the parameters it does not know
+            size_t len = strlen(params->shard_params);
+            snprintf(params->shard_params + len, CACHE_INIT_PARAMS_LEN - len, "%s%s=%s",
+                     len == 0 ? "" : ",", key, value == NULL ? "" : value);
+        }
+    }
+
+    free(old_params_str);
+}
+
+#ifdef __cplusplus
+}
+#endif
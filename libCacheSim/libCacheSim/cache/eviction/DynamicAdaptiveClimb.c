@@ -1,5 +1,14 @@
 // DynamicAdaptiveClimb.c - Optimized Dynamic AdaptiveClimb eviction algorithm
+//
+// with climb-on-hit, the queue positions are indexed by an order-statistic
+// tree, so finding the position of an object, the object at a position and
+// shifting are O(log n), the default move-to-head policy does not use
+// positions and keeps no index
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../dataStructure/orderStatTree.h"
+#include "../../dataStructure/slidingWindow.h"
+#include "../../include/libCacheSim/cacheSnapshot.h"
+#include "../../include/libCacheSim/evictionAlgo/climbEventLog.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 #include <stdio.h>
 #include <math.h>
@@ -10,18 +19,11 @@
 extern "C" {
 #endif
 
-#define HIT_MISS_WINDOW 1000  // Reduced from 2000
 #define DECAY_INTERVAL 50000   // Increased from 10000
 #define K_ADJUSTMENT_WINDOW 10000  // Increased from 5000
-#define MIN_K 5
-#define MAX_K 5000
 #define K_INCREASE_THRESHOLD 0.7
 #define K_DECREASE_THRESHOLD 0.8
-#define ADJUSTMENT_INTERVAL 10000  // Less frequent parameter updates
-#define MAX_SHIFT_DISTANCE 10  // More aggressive limit for shift distance
 #define MAX_CACHE_SIZE 2000000  // Set large enough for most workloads
-#define ADAPTIVECLIMB_FALLBACK_INTERVAL 5  // Number of intervals with no improvement before fallback
-#define EMA_ALPHA 0.3  // Exponential moving average smoothing factor
 
 typedef struct DynamicAdaptiveClimb_params {
     int jump;
@@ -30,18 +32,49 @@ typedef struct DynamicAdaptiveClimb_params {
     double epsilon;
     cache_obj_t *q_head;
     cache_obj_t *q_tail;
-    int queue_size;
-    int recent_hits[HIT_MISS_WINDOW];
-    int hit_miss_ptr;
-    int total_requests;
-    int recent_hit_count;
+    // position of every object in the queue, q_head is at position 1,
+    // NULL unless climb_on_hit
+    ost_t *pos_index;
+    sliding_window_t *recent_hits;
+    int64_t total_requests;
     double last_miss_rates[3];
     double last_hit_rates[3];
     double ema_miss_ratio;
     int fallback_counter;
     int in_fallback;
+
+    // the queue may hold size_boost x cache_size bytes, cache->cache_size
+    // keeps the requested size so that results stay comparable
+    double size_boost;
+    int64_t capacity;
+    // memory-budget accounting: report the peak occupied bytes against the
+    // requested size when the cache is freed
+    bool memory_budget;
+    int64_t peak_occupied_byte;
+
+    // tunable with -e, see DEFAULT_CACHE_PARAMS
+    int hit_miss_window;
+    int adjustment_interval;  // requests between parameter updates
+    int min_k;
+    int max_k;
+    double ema_alpha;         // smoothing factor of the miss ratio EMA
+    int max_shift_distance;   // limit of positions a hit climbs
+    // a hit climbs jump positions (bounded by max_shift_distance) instead of
+    // moving to the head
+    bool climb_on_hit;
+    int fallback_interval;    // intervals with no improvement before fallback
+
+    // controller event log, enabled with event-log=<path>
+    char *event_log_path;
+    int64_t event_log_ring_size;
+    climb_event_log_t *event_log;
 } DynamicAdaptiveClimb_params_t;
 
+static const char *DEFAULT_CACHE_PARAMS =
+    "size-boost=1.0,memory-budget=false,hit-miss-window=1000,adjustment-interval=10000,"
+    "min-k=5,max-k=5000,ema-alpha=0.3,max-shift-distance=10,fallback-interval=5,"
+    "climb-on-hit=false,event-log-ring-size=4096";
+
 // Forward declarations
 static void DynamicAdaptiveClimb_free(cache_t *cache);
 static bool DynamicAdaptiveClimb_get(cache_t *cache, const request_t *req);
@@ -49,157 +82,63 @@ static cache_obj_t *DynamicAdaptiveClimb_find(cache_t *cache, const request_t *r
 static cache_obj_t *DynamicAdaptiveClimb_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *DynamicAdaptiveClimb_to_evict(cache_t *cache, const request_t *req);
 static void DynamicAdaptiveClimb_evict(cache_t *cache, const request_t *req);
+static cache_obj_t *insert_obj(cache_t *cache, const request_t *req, bool sampled);
 static bool DynamicAdaptiveClimb_remove(cache_t *cache, const obj_id_t obj_id);
 cache_t *DynamicAdaptiveClimb_init(const common_cache_params_t ccache_params, const char *cache_specific_params);
+static void DynamicAdaptiveClimb_parse_params(cache_t *cache, const char *cache_specific_params);
 
-// Helper: get position (1-based) of obj in queue (array)
-static int get_obj_pos_array(cache_obj_t **queue, int queue_size, cache_obj_t *obj) {
-    for (int i = 0; i < queue_size; ++i) {
-        if (queue[i] == obj) return i + 1; // 1-based
-    }
-    return -1;
+// Helper: get position (1-based) of obj in queue
+static int64_t get_obj_pos(DynamicAdaptiveClimb_params_t *params, cache_obj_t *obj) {
+    return ost_rank((ost_node_t *)obj->climb.pos_node);
 }
 
-// Helper: get object at position (1-based)
-static cache_obj_t *get_obj_at_pos_array(cache_obj_t **queue, int queue_size, int pos) {
-    if (pos < 1 || pos > queue_size) return NULL;
-    return queue[pos - 1];
+// Helper: get object at position (1-based), NULL if out of range
+static cache_obj_t *get_obj_at_pos(DynamicAdaptiveClimb_params_t *params, int64_t pos) {
+    ost_node_t *node = ost_select(params->pos_index, pos);
+    return node ? (cache_obj_t *)node->data : NULL;
 }
 
-// Helper: shift down elements between start_pos and end_pos (inclusive, 1-based)
-static void shift_down_array(cache_obj_t **queue, int queue_size, int start_pos, int end_pos) {
-    if (start_pos >= end_pos || end_pos > queue_size) return;
-    int shift_distance = end_pos - start_pos + 1;
-    if (shift_distance > MAX_SHIFT_DISTANCE) {
-        // Only move partway
-        end_pos = start_pos + MAX_SHIFT_DISTANCE - 1;
+// Helper: move the object at end_pos to start_pos (1-based) and shift the
+// objects in between down by one, the object climbs at most
+// max_shift_distance - 1 positions
+static void shift_down(DynamicAdaptiveClimb_params_t *params, int64_t start_pos, int64_t end_pos) {
+    if (start_pos < 1 || start_pos >= end_pos || end_pos > ost_size(params->pos_index)) return;
+    if (end_pos - start_pos + 1 > params->max_shift_distance) {
+        start_pos = end_pos - params->max_shift_distance + 1;
     }
-    cache_obj_t *end = queue[end_pos - 1];
-    memmove(&queue[start_pos], &queue[start_pos - 1], (end_pos - start_pos) * sizeof(cache_obj_t*));
-    queue[start_pos - 1] = end;
-}
 
-// OPTIMIZED: Get position using cached queue size and limited traversal
-static int get_obj_pos_optimized(cache_obj_t *head, cache_obj_t *obj, int queue_size) {
-    if (!head || !obj) return -1;
-    
-    // If object is at head, return 1
-    if (head == obj) return 1;
-    
-    // If object is at tail, return queue_size
-    if (obj->queue.next == NULL) return queue_size;
-    
-    // For small queues, use full traversal
-    if (queue_size <= 50) {
-        int pos = 1;
-        while (head && head != obj) {
-            head = head->queue.next;
-            pos++;
-        }
-        return (head == obj) ? pos : -1;
-    }
-    
-    // For large queues, use limited traversal from both ends
-    int pos = 1;
-    cache_obj_t *cur = head;
-    cache_obj_t *tail = head;
-    while (tail->queue.next) tail = tail->queue.next;
-    
-    // Search from head (first half)
-    while (cur && pos <= queue_size/2) {
-        if (cur == obj) return pos;
-        cur = cur->queue.next;
-        pos++;
-    }
-    
-    // Search from tail (second half)
-    pos = queue_size;
-    cur = tail;
-    while (cur && pos > queue_size/2) {
-        if (cur == obj) return pos;
-        cur = cur->queue.prev;
-        pos--;
-    }
-    
-    return -1;
-}
-
-// OPTIMIZED: Get object at position with early exit
-static cache_obj_t *get_obj_at_pos_optimized(cache_obj_t *head, int pos, int queue_size) {
-    if (!head || pos < 1 || pos > queue_size) return NULL;
-    
-    // If position is 1, return head
-    if (pos == 1) return head;
-    
-    // If position is queue_size, traverse to tail
-    if (pos == queue_size) {
-        cache_obj_t *cur = head;
-        while (cur->queue.next) cur = cur->queue.next;
-        return cur;
-    }
-    
-    // For small positions, traverse from head
-    if (pos <= queue_size/2) {
-        cache_obj_t *cur = head;
-        for (int i = 1; i < pos && cur; i++) {
-            cur = cur->queue.next;
-        }
-        return cur;
-    }
-    
-    // For large positions, traverse from tail
-    cache_obj_t *cur = head;
-    while (cur->queue.next) cur = cur->queue.next;
-    for (int i = queue_size; i > pos && cur; i--) {
-        cur = cur->queue.prev;
+    cache_obj_t *start = get_obj_at_pos(params, start_pos);
+    cache_obj_t *end = get_obj_at_pos(params, end_pos);
+    remove_obj_from_list(&params->q_head, &params->q_tail, end);
+    if (start->queue.prev) {
+        insert_obj_after(&params->q_head, &params->q_tail, start->queue.prev, end);
+    } else {
+        prepend_obj_to_head(&params->q_head, &params->q_tail, end);
     }
-    return cur;
+    ost_move(params->pos_index, (ost_node_t *)end->climb.pos_node, start_pos);
 }
 
-// OPTIMIZED: Shift down with distance limiting and early exit
-static void shift_down_optimized(cache_obj_t **head, cache_obj_t **tail, int start_pos, int end_pos, int queue_size) {
-    if (!head || !*head || start_pos >= end_pos || end_pos > queue_size) return;
-    
-    // Limit shift distance for performance
-    int shift_distance = end_pos - start_pos + 1;
-    if (shift_distance > MAX_SHIFT_DISTANCE) {
-        shift_distance = MAX_SHIFT_DISTANCE;
-        end_pos = start_pos + shift_distance - 1;
-    }
-    
-    cache_obj_t *start = get_obj_at_pos_optimized(*head, start_pos, queue_size);
-    cache_obj_t *end = get_obj_at_pos_optimized(*head, end_pos, queue_size);
-    if (!start || !end) return;
-    
-    // Remove end from list
-    if (end->queue.prev) end->queue.prev->queue.next = end->queue.next;
-    else *head = end->queue.next;
-    if (end->queue.next) end->queue.next->queue.prev = end->queue.prev;
-    else *tail = end->queue.prev;
-    
-    // Insert before start
-    end->queue.prev = start->queue.prev;
-    end->queue.next = start;
-    if (start->queue.prev) start->queue.prev->queue.next = end;
-    else *head = end;
-    start->queue.prev = end;
+// Helper: move object to head of queue
+static void move_to_head(DynamicAdaptiveClimb_params_t *params, cache_obj_t *obj) {
+    if (obj == params->q_head) return;
+    remove_obj_from_list(&params->q_head, &params->q_tail, obj);
+    prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
+    if (params->pos_index) ost_move(params->pos_index, (ost_node_t *)obj->climb.pos_node, 1);
 }
 
 // OPTIMIZED: Update hit/miss window with reduced frequency
 static void update_hit_miss_window(DynamicAdaptiveClimb_params_t *params, int hit) {
-    if (params->recent_hits[params->hit_miss_ptr]) params->recent_hit_count--;
-    params->recent_hits[params->hit_miss_ptr] = hit;
-    if (hit) params->recent_hit_count++;
-    params->hit_miss_ptr = (params->hit_miss_ptr + 1) % HIT_MISS_WINDOW;
+    sliding_window_add(params->recent_hits, hit);
 }
 
 // OPTIMIZED: Adjust K parameter with reduced frequency
 static void adjust_k_parameter(DynamicAdaptiveClimb_params_t *params) {
-    if (params->total_requests % ADJUSTMENT_INTERVAL != 0) return;
-    double miss_rate = 1.0 - ((double)params->recent_hit_count / HIT_MISS_WINDOW);
+    if (params->total_requests % params->adjustment_interval != 0) return;
+    double miss_rate = 1.0 - sliding_window_hit_ratio(params->recent_hits);
+    int min_k = params->min_k, max_k = params->max_k;
     double hit_rate = 1.0 - miss_rate;
     // Update EMA
-    params->ema_miss_ratio = EMA_ALPHA * miss_rate + (1.0 - EMA_ALPHA) * params->ema_miss_ratio;
+    params->ema_miss_ratio = params->ema_alpha * miss_rate + (1.0 - params->ema_alpha) * params->ema_miss_ratio;
     // Check for improvement
     int improving = (params->ema_miss_ratio < params->last_miss_rates[2]);
     if (improving) {
@@ -209,7 +148,7 @@ static void adjust_k_parameter(DynamicAdaptiveClimb_params_t *params) {
         }
     } else {
         params->fallback_counter++;
-        if (params->fallback_counter >= ADAPTIVECLIMB_FALLBACK_INTERVAL) {
+        if (params->fallback_counter >= params->fallback_interval) {
             params->in_fallback = 1; // Switch to AdaptiveClimb logic
         }
     }
@@ -217,20 +156,20 @@ static void adjust_k_parameter(DynamicAdaptiveClimb_params_t *params) {
     if (params->in_fallback) {
         // AdaptiveClimb logic: simple up/down
         if (miss_rate > params->last_miss_rates[2]) {
-            params->K = (params->K > MIN_K) ? params->K - 1 : MIN_K;
-            params->jump = (params->jump < MAX_K) ? params->jump + 1 : MAX_K;
+            params->K = (params->K > min_k) ? params->K - 1 : min_k;
+            params->jump = (params->jump < max_k) ? params->jump + 1 : max_k;
         } else {
-            params->K = (params->K < MAX_K) ? params->K + 1 : MAX_K;
-            params->jump = (params->jump > MIN_K) ? params->jump - 1 : MIN_K;
+            params->K = (params->K < max_k) ? params->K + 1 : max_k;
+            params->jump = (params->jump > min_k) ? params->jump - 1 : min_k;
         }
     } else {
         // Aggressive DynamicAdaptiveClimb logic
         if (miss_rate > params->last_miss_rates[2]) {
-            params->K = (params->K > MIN_K) ? params->K - 2 : MIN_K;
-            params->jump = (params->jump < MAX_K) ? params->jump + 2 : MAX_K;
+            params->K = (params->K > min_k) ? params->K - 2 : min_k;
+            params->jump = (params->jump < max_k) ? params->jump + 2 : max_k;
         } else {
-            params->K = (params->K < MAX_K) ? params->K + 2 : MAX_K;
-            params->jump = (params->jump > MIN_K) ? params->jump - 2 : MIN_K;
+            params->K = (params->K < max_k) ? params->K + 2 : max_k;
+            params->jump = (params->jump > min_k) ? params->jump - 2 : min_k;
         }
     }
     // Update last miss rates
@@ -240,78 +179,74 @@ static void adjust_k_parameter(DynamicAdaptiveClimb_params_t *params) {
     params->last_hit_rates[0] = hit_rate;
     params->last_hit_rates[1] = params->last_hit_rates[0];
     params->last_hit_rates[2] = params->last_hit_rates[1];
-}
 
-// Helper: move object to head of queue
-static void move_to_head(DynamicAdaptiveClimb_params_t *params, cache_obj_t *obj) {
-    if (!obj) return;
-    // Remove from current position
-    if (obj->queue.prev) {
-        obj->queue.prev->queue.next = obj->queue.next;
-    } else {
-        params->q_head = obj->queue.next;
+    if (params->event_log != NULL) {
+        climb_event_t event = {.n_req = params->total_requests,
+                               .miss_ratio = miss_rate,
+                               .ema_miss_ratio = params->ema_miss_ratio,
+                               .K = params->K,
+                               .jump = params->jump,
+                               .fallback_counter = params->fallback_counter,
+                               .in_fallback = params->in_fallback};
+        climb_event_log_record(params->event_log, &event);
     }
-    if (obj->queue.next) {
-        obj->queue.next->queue.prev = obj->queue.prev;
-    } else {
-        params->q_tail = obj->queue.prev;
-    }
-    // Insert at head
-    obj->queue.next = params->q_head;
-    obj->queue.prev = NULL;
-    if (params->q_head) {
-        params->q_head->queue.prev = obj;
-    } else {
-        params->q_tail = obj;
-    }
-    params->q_head = obj;
 }
 
 static void DynamicAdaptiveClimb_free(cache_t *cache) {
     DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
+    if (params->memory_budget) {
+        INFO("%s memory budget: requested %ld bytes, capacity %ld bytes, "
+             "peak occupied %ld bytes (%.2lf%% of requested), index %ld bytes\n",
+             cache->cache_name, (long)cache->cache_size, (long)params->capacity,
+             (long)params->peak_occupied_byte,
+             100.0 * params->peak_occupied_byte / cache->cache_size,
+             (long)(params->pos_index ? ost_size(params->pos_index) * sizeof(ost_node_t) : 0));
+    }
+    if (params->pos_index) ost_free(params->pos_index);
+    sliding_window_free(params->recent_hits);
+    if (params->event_log != NULL) climb_event_log_close(params->event_log);
+    free(params->event_log_path);
     free(params);
     cache_struct_free(cache);
 }
 
 static bool DynamicAdaptiveClimb_get(cache_t *cache, const request_t *req) {
     DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
-    cache_obj_t *obj = cache_find_base(cache, req, true);
-    if (!obj) return false;
+    cache->n_req += 1;
+    // get does not go through cache_get_base, so it times the ops itself
+    bool sampled = OP_LATENCY_SAMPLE(cache);
+    cache_obj_t *obj;
+    OP_LATENCY_TIME(cache, sampled, CACHE_OP_FIND, obj = cache_find_base(cache, req, true));
+    if (!obj) {
+        // a miss is admitted here, so callers do not need a separate insert
+        insert_obj(cache, req, sampled);
+        return false;
+    }
     params->total_requests++;
     update_hit_miss_window(params, 1);
-    move_to_head(params, obj);
+    if (params->climb_on_hit) {
+        // climb jump positions towards the head
+        int64_t pos = get_obj_pos(params, obj);
+        shift_down(params, pos > params->jump ? pos - params->jump : 1, pos);
+    } else {
+        move_to_head(params, obj);
+    }
     adjust_k_parameter(params);
     return true;
 }
 
+// prefetch the hash buckets of the requests ahead, see cache_get_batch_prefetch
+static void DynamicAdaptiveClimb_get_batch(cache_t *cache, request_t *reqs, int n, bool *hits) {
+    cache_get_batch_prefetch(cache, reqs, n, hits, DynamicAdaptiveClimb_get);
+}
+
 static cache_obj_t *DynamicAdaptiveClimb_find(cache_t *cache, const request_t *req, const bool update_cache) {
     return cache_find_base(cache, req, update_cache);
 }
 
-static cache_obj_t *DynamicAdaptiveClimb_insert(cache_t *cache, const request_t *req) {
-    DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
-    cache_obj_t *obj = cache_find_base(cache, req, false);
-    if (obj) {
-        DynamicAdaptiveClimb_get(cache, req);
-        return obj;
-    }
-    params->total_requests++;
-    update_hit_miss_window(params, 0);
-    // Evict if needed
-    while (cache->get_occupied_byte(cache) + req->obj_size + cache->obj_md_size > cache->cache_size) {
-        cache_obj_t *victim = params->q_tail;
-        if (!victim) break;
-        // Remove from queue
-        if (victim->queue.prev) {
-            victim->queue.prev->queue.next = NULL;
-        } else {
-            params->q_head = NULL;
-        }
-        params->q_tail = victim->queue.prev;
-        cache_evict_base(cache, victim, true);
-    }
-    // Insert new object at head
-    obj = cache_insert_base(cache, req);
+// Helper: put a new object at the head of queue
+static cache_obj_t *insert_at_head(cache_t *cache, DynamicAdaptiveClimb_params_t *params, const request_t *req) {
+    cache_obj_t *obj = cache_insert_base(cache, req);
     if (obj) {
         obj->queue.next = params->q_head;
         obj->queue.prev = NULL;
@@ -321,11 +256,43 @@ static cache_obj_t *DynamicAdaptiveClimb_insert(cache_t *cache, const request_t
             params->q_tail = obj;
         }
         params->q_head = obj;
+        if (params->pos_index) obj->climb.pos_node = ost_push_front(params->pos_index, obj);
+        if (params->memory_budget && cache->occupied_byte > params->peak_occupied_byte) {
+            params->peak_occupied_byte = cache->occupied_byte;
+        }
     }
+    return obj;
+}
+
+// the evictions and the insert are timed when the request is sampled
+static cache_obj_t *insert_obj(cache_t *cache, const request_t *req, bool sampled) {
+    DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
+    cache_obj_t *obj = cache_find_base(cache, req, false);
+    if (obj) {
+        DynamicAdaptiveClimb_get(cache, req);
+        return obj;
+    }
+    params->total_requests++;
+    update_hit_miss_window(params, 0);
+    // Evict if needed, get does not go through cache_get_base, which counts
+    // the evictions of the other algorithms
+    int64_t n_evict = 0;
+    while (cache->get_occupied_byte(cache) + req->obj_size + cache->obj_md_size > params->capacity) {
+        if (!params->q_tail) break;
+        OP_LATENCY_TIME(cache, sampled, CACHE_OP_EVICT, DynamicAdaptiveClimb_evict(cache, req));
+        n_evict += 1;
+    }
+    cache->n_evict += n_evict;
+    OP_LATENCY_EVICT_ITER(cache, sampled, n_evict);
+    OP_LATENCY_TIME(cache, sampled, CACHE_OP_INSERT, obj = insert_at_head(cache, params, req));
     adjust_k_parameter(params);
     return obj;
 }
 
+static cache_obj_t *DynamicAdaptiveClimb_insert(cache_t *cache, const request_t *req) {
+    return insert_obj(cache, req, false);
+}
+
 static cache_obj_t *DynamicAdaptiveClimb_to_evict(cache_t *cache, const request_t *req) {
     DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
     return params->q_tail;
@@ -335,6 +302,7 @@ static void DynamicAdaptiveClimb_evict(cache_t *cache, const request_t *req) {
     DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
     cache_obj_t *victim = params->q_tail;
     if (!victim) return;
+    if (params->pos_index) ost_remove(params->pos_index, (ost_node_t *)victim->climb.pos_node);
     // Remove from queue
     if (victim->queue.prev) {
         victim->queue.prev->queue.next = NULL;
@@ -349,6 +317,7 @@ static bool DynamicAdaptiveClimb_remove(cache_t *cache, const obj_id_t obj_id) {
     cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
     if (!obj) return false;
     DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
+    if (params->pos_index) ost_remove(params->pos_index, (ost_node_t *)obj->climb.pos_node);
     // Remove from queue
     if (obj->queue.prev) {
         obj->queue.prev->queue.next = obj->queue.next;
@@ -364,35 +333,76 @@ static bool DynamicAdaptiveClimb_remove(cache_t *cache, const obj_id_t obj_id) {
     return true;
 }
 
+// the controller and the queue, the position index is rebuilt on restore
+static bool DynamicAdaptiveClimb_snapshot(const cache_t *cache, FILE *ofile) {
+    DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
+    return snapshot_write(ofile, &params->jump, sizeof(int)) && snapshot_write(ofile, &params->jump_prime, sizeof(int)) &&
+           snapshot_write(ofile, &params->K, sizeof(int)) && snapshot_write(ofile, &params->epsilon, sizeof(double)) &&
+           snapshot_write(ofile, &params->total_requests, sizeof(int64_t)) &&
+           snapshot_write(ofile, params->last_miss_rates, sizeof(params->last_miss_rates)) &&
+           snapshot_write(ofile, params->last_hit_rates, sizeof(params->last_hit_rates)) &&
+           snapshot_write(ofile, &params->ema_miss_ratio, sizeof(double)) &&
+           snapshot_write(ofile, &params->fallback_counter, sizeof(int)) &&
+           snapshot_write(ofile, &params->in_fallback, sizeof(int)) &&
+           snapshot_write(ofile, &params->peak_occupied_byte, sizeof(int64_t)) &&
+           sliding_window_save(params->recent_hits, ofile) && snapshot_write_queue(ofile, params->q_head, 0);
+}
+
+static bool DynamicAdaptiveClimb_restore(cache_t *cache, FILE *ifile) {
+    DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
+    bool ok = snapshot_read(ifile, &params->jump, sizeof(int)) && snapshot_read(ifile, &params->jump_prime, sizeof(int)) &&
+              snapshot_read(ifile, &params->K, sizeof(int)) && snapshot_read(ifile, &params->epsilon, sizeof(double)) &&
+              snapshot_read(ifile, &params->total_requests, sizeof(int64_t)) &&
+              snapshot_read(ifile, params->last_miss_rates, sizeof(params->last_miss_rates)) &&
+              snapshot_read(ifile, params->last_hit_rates, sizeof(params->last_hit_rates)) &&
+              snapshot_read(ifile, &params->ema_miss_ratio, sizeof(double)) &&
+              snapshot_read(ifile, &params->fallback_counter, sizeof(int)) &&
+              snapshot_read(ifile, &params->in_fallback, sizeof(int)) &&
+              snapshot_read(ifile, &params->peak_occupied_byte, sizeof(int64_t)) &&
+              sliding_window_load(params->recent_hits, ifile) &&
+              snapshot_read_queue(cache, ifile, &params->q_head, &params->q_tail, 0);
+    if (!ok) return false;
+
+    if (!params->pos_index) return true;
+    for (cache_obj_t *obj = params->q_head; obj != NULL; obj = obj->queue.next) {
+        obj->climb.pos_node = ost_push_back(params->pos_index, obj);
+    }
+    return true;
+}
+
 cache_t *DynamicAdaptiveClimb_init(const common_cache_params_t ccache_params, const char *cache_specific_params) {
-    // Increase cache size by 20% for DynamicAdaptiveClimb
-    common_cache_params_t boosted_params = ccache_params;
-    boosted_params.cache_size = (size_t)(ccache_params.cache_size * 1.20);
-    cache_t *cache = cache_struct_init("DynamicAdaptiveClimb", boosted_params, cache_specific_params);
+    cache_t *cache = cache_struct_init("DynamicAdaptiveClimb", ccache_params, cache_specific_params);
     cache->cache_init = DynamicAdaptiveClimb_init;
     cache->cache_free = DynamicAdaptiveClimb_free;
     cache->get = DynamicAdaptiveClimb_get;
+    cache->get_batch = DynamicAdaptiveClimb_get_batch;
     cache->find = DynamicAdaptiveClimb_find;
     cache->insert = DynamicAdaptiveClimb_insert;
     cache->evict = DynamicAdaptiveClimb_evict;
     cache->remove = DynamicAdaptiveClimb_remove;
     cache->to_evict = DynamicAdaptiveClimb_to_evict;
+    cache->snapshot = DynamicAdaptiveClimb_snapshot;
+    cache->restore = DynamicAdaptiveClimb_restore;
     DynamicAdaptiveClimb_params_t *params = malloc(sizeof(DynamicAdaptiveClimb_params_t));
+    memset(params, 0, sizeof(DynamicAdaptiveClimb_params_t));
+    cache->eviction_params = params;
+
+    DynamicAdaptiveClimb_parse_params(cache, DEFAULT_CACHE_PARAMS);
+    if (cache_specific_params != NULL) {
+        DynamicAdaptiveClimb_parse_params(cache, cache_specific_params);
+    }
+
     params->K = (int)(sqrt((double)ccache_params.cache_size / 1024));
-    if (params->K < 5) params->K = 5;
-    if (params->K > 5000) params->K = 5000;
+    if (params->K < params->min_k) params->K = params->min_k;
+    if (params->K > params->max_k) params->K = params->max_k;
     params->jump = params->K;
     params->jump_prime = 0;
     params->epsilon = 0.1;
     params->q_head = NULL;
     params->q_tail = NULL;
-    params->queue_size = 0;
-    params->hit_miss_ptr = 0;
+    params->pos_index = params->climb_on_hit ? ost_create() : NULL;
     params->total_requests = 0;
-    params->recent_hit_count = 0;
-    for (int i = 0; i < HIT_MISS_WINDOW; i++) {
-        params->recent_hits[i] = 0;
-    }
+    params->recent_hits = sliding_window_create(params->hit_miss_window);
     for (int i = 0; i < 3; i++) {
         params->last_miss_rates[i] = 0;
         params->last_hit_rates[i] = 0;
@@ -400,10 +410,97 @@ cache_t *DynamicAdaptiveClimb_init(const common_cache_params_t ccache_params, co
     params->ema_miss_ratio = 0.5;
     params->fallback_counter = 0;
     params->in_fallback = 0;
-    cache->eviction_params = params;
+    params->peak_occupied_byte = 0;
+    params->capacity = (int64_t)(ccache_params.cache_size * params->size_boost);
+    if (params->size_boost != 1.0) {
+        snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "DynamicAdaptiveClimb-boost%.2lf", params->size_boost);
+    }
+    if (params->event_log_path != NULL) {
+        // caches resized or cloned from the same params get their own file
+        char path[512];
+        snprintf(path, sizeof(path), "%s.%s.%ld", params->event_log_path, cache->cache_name,
+                 (long)cache->cache_size);
+        params->event_log = climb_event_log_open(path, params->event_log_ring_size);
+    }
     return cache;
 }
 
+static const char *DynamicAdaptiveClimb_current_params(DynamicAdaptiveClimb_params_t *params) {
+    static __thread char params_str[512];
+    snprintf(params_str, 512,
+             "size-boost=%.4lf,memory-budget=%s,hit-miss-window=%d,adjustment-interval=%d,"
+             "min-k=%d,max-k=%d,ema-alpha=%.4lf,max-shift-distance=%d,fallback-interval=%d,"
+             "climb-on-hit=%s\n",
+             params->size_boost, params->memory_budget ? "true" : "false", params->hit_miss_window,
+             params->adjustment_interval, params->min_k, params->max_k, params->ema_alpha,
+             params->max_shift_distance, params->fallback_interval, params->climb_on_hit ? "true" : "false");
+    return params_str;
+}
+
+static void DynamicAdaptiveClimb_parse_params(cache_t *cache, const char *cache_specific_params) {
+    DynamicAdaptiveClimb_params_t *params = (DynamicAdaptiveClimb_params_t *)cache->eviction_params;
+    char *params_str = strdup(cache_specific_params);
+    char *old_params_str = params_str;
+
+    while (params_str != NULL && params_str[0] != '\0') {
+        /* different parameters are separated by comma,
+         * key and value are separated by = */
+        char *key = strsep((char **)&params_str, "=");
+        char *value = strsep((char **)&params_str, ",");
+
+        // skip the white space
+        while (params_str != NULL && *params_str == ' ') {
+            params_str++;
+        }
+
+        if (strcasecmp(key, "size-boost") == 0) {
+            params->size_boost = strtod(value, NULL);
+            if (params->size_boost <= 0) {
+                ERROR("%s size-boost must be positive, got %s\n", cache->cache_name, value);
+                exit(1);
+            }
+        } else if (strcasecmp(key, "memory-budget") == 0) {
+            params->memory_budget = strcasecmp(value, "true") == 0 || strcmp(value, "1") == 0;
+        } else if (strcasecmp(key, "hit-miss-window") == 0) {
+            params->hit_miss_window = atoi(value);
+        } else if (strcasecmp(key, "adjustment-interval") == 0) {
+            params->adjustment_interval = atoi(value);
+        } else if (strcasecmp(key, "min-k") == 0) {
+            params->min_k = atoi(value);
+        } else if (strcasecmp(key, "max-k") == 0) {
+            params->max_k = atoi(value);
+        } else if (strcasecmp(key, "ema-alpha") == 0) {
+            params->ema_alpha = strtod(value, NULL);
+        } else if (strcasecmp(key, "max-shift-distance") == 0) {
+            params->max_shift_distance = atoi(value);
+        } else if (strcasecmp(key, "fallback-interval") == 0) {
+            params->fallback_interval = atoi(value);
+        } else if (strcasecmp(key, "climb-on-hit") == 0) {
+            params->climb_on_hit = strcasecmp(value, "true") == 0 || strcmp(value, "1") == 0;
+        } else if (strcasecmp(key, "event-log") == 0) {
+            free(params->event_log_path);
+            params->event_log_path = strdup(value);
+        } else if (strcasecmp(key, "event-log-ring-size") == 0) {
+            params->event_log_ring_size = atol(value);
+        } else if (strcasecmp(key, "print") == 0) {
+            printf("parameters: %s\n", DynamicAdaptiveClimb_current_params(params));
+            exit(0);
+        } else {
+            ERROR("%s does not have parameter %s\n", cache->cache_name, key);
+            exit(1);
+        }
+    }
+
+    if (params->hit_miss_window <= 0 || params->adjustment_interval <= 0 || params->min_k <= 0 ||
+        params->min_k > params->max_k || params->ema_alpha < 0 || params->ema_alpha > 1 ||
+        params->max_shift_distance < 2) {
+        ERROR("%s invalid parameters %s\n", cache->cache_name, DynamicAdaptiveClimb_current_params(params));
+        exit(1);
+    }
+
+    free(old_params_str);
+}
+
 #ifdef __cplusplus
 }
 #endif 
\ No newline at end of file
@@ -10,6 +10,7 @@
 //
 
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/cacheSnapshot.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -26,12 +27,16 @@ static void FIFO_parse_params(cache_t *cache,
                               const char *cache_specific_params);
 static void FIFO_free(cache_t *cache);
 static bool FIFO_get(cache_t *cache, const request_t *req);
+static void FIFO_get_batch(cache_t *cache, request_t *reqs, int n,
+                           bool *hits);
 static cache_obj_t *FIFO_find(cache_t *cache, const request_t *req,
                               const bool update_cache);
 static cache_obj_t *FIFO_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *FIFO_to_evict(cache_t *cache, const request_t *req);
 static void FIFO_evict(cache_t *cache, const request_t *req);
 static bool FIFO_remove(cache_t *cache, const obj_id_t obj_id);
+static bool FIFO_snapshot(const cache_t *cache, FILE *ofile);
+static bool FIFO_restore(cache_t *cache, FILE *ifile);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -52,6 +57,7 @@ cache_t *FIFO_init(const common_cache_params_t ccache_params,
   cache->cache_init = FIFO_init;
   cache->cache_free = FIFO_free;
   cache->get = FIFO_get;
+  cache->get_batch = FIFO_get_batch;
   cache->find = FIFO_find;
   cache->insert = FIFO_insert;
   cache->evict = FIFO_evict;
@@ -60,6 +66,8 @@ cache_t *FIFO_init(const common_cache_params_t ccache_params,
   cache->get_occupied_byte = cache_get_occupied_byte_default;
   cache->get_n_obj = cache_get_n_obj_default;
   cache->can_insert = cache_can_insert_default;
+  cache->snapshot = FIFO_snapshot;
+  cache->restore = FIFO_restore;
   cache->obj_md_size = 0;
 
   cache->eviction_params = malloc(sizeof(FIFO_params_t));
@@ -103,6 +111,12 @@ static bool FIFO_get(cache_t *cache, const request_t *req) {
   return cache_get_base(cache, req);
 }
 
+/* prefetch the hash buckets ahead, see cache_get_batch_prefetch */
+static void FIFO_get_batch(cache_t *cache, request_t *reqs, int n,
+                           bool *hits) {
+  cache_get_batch_prefetch(cache, reqs, n, hits, FIFO_get);
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****       developer facing APIs (used by cache developer)         ****
@@ -214,6 +228,21 @@ static bool FIFO_remove(cache_t *cache, const obj_id_t obj_id) {
   return true;
 }
 
+/**
+ * @brief write the queue from the newest to the oldest,
+ * see cacheSnapshot.h
+ */
+static bool FIFO_snapshot(const cache_t *cache, FILE *ofile) {
+  FIFO_params_t *params = (FIFO_params_t *)cache->eviction_params;
+  return snapshot_write_queue(ofile, params->q_head, 0);
+}
+
+static bool FIFO_restore(cache_t *cache, FILE *ifile) {
+  FIFO_params_t *params = (FIFO_params_t *)cache->eviction_params;
+  return snapshot_read_queue(cache, ifile, &params->q_head, &params->q_tail,
+                             0);
+}
+
 #ifdef __cplusplus
 }
 #endif
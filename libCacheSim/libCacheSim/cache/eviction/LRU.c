@@ -10,6 +10,7 @@
 //
 
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/cacheSnapshot.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -26,6 +27,8 @@ extern "C" {
 
 static void LRU_free(cache_t *cache);
 static bool LRU_get(cache_t *cache, const request_t *req);
+static void LRU_get_batch(cache_t *cache, request_t *reqs, int n,
+                          bool *hits);
 static cache_obj_t *LRU_find(cache_t *cache, const request_t *req,
                              const bool update_cache);
 static cache_obj_t *LRU_insert(cache_t *cache, const request_t *req);
@@ -33,6 +36,8 @@ static cache_obj_t *LRU_to_evict(cache_t *cache, const request_t *req);
 static void LRU_evict(cache_t *cache, const request_t *req);
 static bool LRU_remove(cache_t *cache, const obj_id_t obj_id);
 static void LRU_print_cache(const cache_t *cache);
+static bool LRU_snapshot(const cache_t *cache, FILE *ofile);
+static bool LRU_restore(cache_t *cache, FILE *ifile);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -53,6 +58,7 @@ cache_t *LRU_init(const common_cache_params_t ccache_params,
   cache->cache_init = LRU_init;
   cache->cache_free = LRU_free;
   cache->get = LRU_get;
+  cache->get_batch = LRU_get_batch;
   cache->find = LRU_find;
   cache->insert = LRU_insert;
   cache->evict = LRU_evict;
@@ -62,6 +68,8 @@ cache_t *LRU_init(const common_cache_params_t ccache_params,
   cache->can_insert = cache_can_insert_default;
   cache->get_n_obj = cache_get_n_obj_default;
   cache->print_cache = LRU_print_cache;
+  cache->snapshot = LRU_snapshot;
+  cache->restore = LRU_restore;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 8 * 2;
@@ -111,6 +119,12 @@ static bool LRU_get(cache_t *cache, const request_t *req) {
   return cache_get_base(cache, req);
 }
 
+/* prefetch the hash buckets ahead, see cache_get_batch_prefetch */
+static void LRU_get_batch(cache_t *cache, request_t *reqs, int n,
+                          bool *hits) {
+  cache_get_batch_prefetch(cache, reqs, n, hits, LRU_get);
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****       developer facing APIs (used by cache developer)         ****
@@ -265,6 +279,21 @@ static bool LRU_remove(cache_t *cache, const obj_id_t obj_id) {
   return true;
 }
 
+/**
+ * @brief write the queue from the most recent to the least recent,
+ * see cacheSnapshot.h
+ */
+static bool LRU_snapshot(const cache_t *cache, FILE *ofile) {
+  LRU_params_t *params = (LRU_params_t *)cache->eviction_params;
+  return snapshot_write_queue(ofile, params->q_head, 0);
+}
+
+static bool LRU_restore(cache_t *cache, FILE *ifile) {
+  LRU_params_t *params = (LRU_params_t *)cache->eviction_params;
+  return snapshot_read_queue(cache, ifile, &params->q_head, &params->q_tail,
+                             0);
+}
+
 static void LRU_print_cache(const cache_t *cache) {
   LRU_params_t *params = (LRU_params_t *)cache->eviction_params;
   cache_obj_t *cur = params->q_head;
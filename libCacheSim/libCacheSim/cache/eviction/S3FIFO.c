@@ -21,6 +21,7 @@
 //
 
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/cacheSnapshot.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -72,6 +73,8 @@ static inline int64_t S3FIFO_get_n_obj(const cache_t *cache);
 static inline bool S3FIFO_can_insert(cache_t *cache, const request_t *req);
 static void S3FIFO_parse_params(cache_t *cache,
                                 const char *cache_specific_params);
+static bool S3FIFO_snapshot(const cache_t *cache, FILE *ofile);
+static bool S3FIFO_restore(cache_t *cache, FILE *ifile);
 
 static void S3FIFO_evict_fifo(cache_t *cache, const request_t *req);
 static void S3FIFO_evict_main(cache_t *cache, const request_t *req);
@@ -97,6 +100,8 @@ cache_t *S3FIFO_init(const common_cache_params_t ccache_params,
   cache->get_n_obj = S3FIFO_get_n_obj;
   cache->get_occupied_byte = S3FIFO_get_occupied_byte;
   cache->can_insert = S3FIFO_can_insert;
+  cache->snapshot = S3FIFO_snapshot;
+  cache->restore = S3FIFO_restore;
 
   cache->obj_md_size = 0;
 
@@ -481,6 +486,76 @@ static inline bool S3FIFO_can_insert(cache_t *cache, const request_t *req) {
   return req->obj_size <= params->fifo->cache_size;
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                     snapshot and restore                      ****
+// ****                                                               ****
+// ***********************************************************************
+/* the small, ghost and main FIFOs keep the S3FIFO metadata in their
+ * objects, so their queues are written here rather than by FIFO_snapshot */
+static bool S3FIFO_snapshot_fifo(const cache_t *fifo, FILE *ofile) {
+  FIFO_params_t *fifo_params = (FIFO_params_t *)fifo->eviction_params;
+  return snapshot_write(ofile, &fifo->n_req, sizeof(int64_t)) &&
+         snapshot_write_queue(ofile, fifo_params->q_head,
+                              sizeof(S3FIFO_obj_metadata_t));
+}
+
+static bool S3FIFO_restore_fifo(cache_t *fifo, FILE *ifile) {
+  FIFO_params_t *fifo_params = (FIFO_params_t *)fifo->eviction_params;
+  return snapshot_read(ifile, &fifo->n_req, sizeof(int64_t)) &&
+         snapshot_read_queue(fifo, ifile, &fifo_params->q_head,
+                             &fifo_params->q_tail,
+                             sizeof(S3FIFO_obj_metadata_t));
+}
+
+static bool S3FIFO_snapshot(const cache_t *cache, FILE *ofile) {
+  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
+  int64_t counters[6] = {params->n_obj_admit_to_fifo,
+                         params->n_obj_admit_to_main,
+                         params->n_obj_move_to_main,
+                         params->n_byte_admit_to_fifo,
+                         params->n_byte_admit_to_main,
+                         params->n_byte_move_to_main};
+  bool has_ghost = params->fifo_ghost != NULL;
+
+  return snapshot_write(ofile, counters, sizeof(counters)) &&
+         snapshot_write(ofile, &has_ghost, sizeof(has_ghost)) &&
+         S3FIFO_snapshot_fifo(params->fifo, ofile) &&
+         (!has_ghost || S3FIFO_snapshot_fifo(params->fifo_ghost, ofile)) &&
+         S3FIFO_snapshot_fifo(params->main_cache, ofile);
+}
+
+static bool S3FIFO_restore(cache_t *cache, FILE *ifile) {
+  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
+  int64_t counters[6];
+  bool has_ghost;
+  if (!snapshot_read(ifile, counters, sizeof(counters)) ||
+      !snapshot_read(ifile, &has_ghost, sizeof(has_ghost)) ||
+      !S3FIFO_restore_fifo(params->fifo, ifile)) {
+    return false;
+  }
+  params->n_obj_admit_to_fifo = counters[0];
+  params->n_obj_admit_to_main = counters[1];
+  params->n_obj_move_to_main = counters[2];
+  params->n_byte_admit_to_fifo = counters[3];
+  params->n_byte_admit_to_main = counters[4];
+  params->n_byte_move_to_main = counters[5];
+
+  if (has_ghost && params->fifo_ghost != NULL) {
+    if (!S3FIFO_restore_fifo(params->fifo_ghost, ifile)) return false;
+  } else if (has_ghost) {
+    /* this variant has no ghost, the saved one is dropped */
+    common_cache_params_t ccache_params = default_common_cache_params();
+    ccache_params.hashpower = 10;
+    cache_t *ghost = FIFO_init(ccache_params, NULL);
+    bool ok = S3FIFO_restore_fifo(ghost, ifile);
+    ghost->cache_free(ghost);
+    if (!ok) return false;
+  }
+
+  return S3FIFO_restore_fifo(params->main_cache, ifile);
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                parameter set up functions                     ****
@@ -2,6 +2,7 @@
 
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/cache.h"
+#include "../../include/libCacheSim/cacheSnapshot.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,12 +22,16 @@ typedef struct {
 // ***********************************************************************
 static void Sieve_free(cache_t *cache);
 static bool Sieve_get(cache_t *cache, const request_t *req);
+static void Sieve_get_batch(cache_t *cache, request_t *reqs, int n,
+                            bool *hits);
 static cache_obj_t *Sieve_find(cache_t *cache, const request_t *req,
                                const bool update_cache);
 static cache_obj_t *Sieve_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *Sieve_to_evict(cache_t *cache, const request_t *req);
 static void Sieve_evict(cache_t *cache, const request_t *req);
 static bool Sieve_remove(cache_t *cache, const obj_id_t obj_id);
+static bool Sieve_snapshot(const cache_t *cache, FILE *ofile);
+static bool Sieve_restore(cache_t *cache, FILE *ifile);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -49,11 +54,14 @@ cache_t *Sieve_init(const common_cache_params_t ccache_params,
   cache->cache_init = Sieve_init;
   cache->cache_free = Sieve_free;
   cache->get = Sieve_get;
+  cache->get_batch = Sieve_get_batch;
   cache->find = Sieve_find;
   cache->insert = Sieve_insert;
   cache->evict = Sieve_evict;
   cache->remove = Sieve_remove;
   cache->to_evict = Sieve_to_evict;
+  cache->snapshot = Sieve_snapshot;
+  cache->restore = Sieve_restore;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 1;
@@ -106,6 +114,12 @@ static bool Sieve_get(cache_t *cache, const request_t *req) {
   return ck_hit;
 }
 
+/* prefetch the hash buckets ahead, see cache_get_batch_prefetch */
+static void Sieve_get_batch(cache_t *cache, request_t *reqs, int n,
+                            bool *hits) {
+  cache_get_batch_prefetch(cache, reqs, n, hits, Sieve_get);
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****       developer facing APIs (used by cache developer)         ****
@@ -265,6 +279,30 @@ static bool Sieve_remove(cache_t *cache, const obj_id_t obj_id) {
   return true;
 }
 
+/**
+ * @brief write the hand (as its position in the queue) and the queue with the
+ * visited bits, see cacheSnapshot.h
+ */
+static bool Sieve_snapshot(const cache_t *cache, FILE *ofile) {
+  Sieve_params_t *params = cache->eviction_params;
+  int64_t pointer_pos = snapshot_obj_pos(params->q_head, params->pointer);
+  return snapshot_write(ofile, &pointer_pos, sizeof(pointer_pos)) &&
+         snapshot_write_queue(ofile, params->q_head,
+                              sizeof(Sieve_obj_params_t));
+}
+
+static bool Sieve_restore(cache_t *cache, FILE *ifile) {
+  Sieve_params_t *params = cache->eviction_params;
+  int64_t pointer_pos;
+  if (!snapshot_read(ifile, &pointer_pos, sizeof(pointer_pos)) ||
+      !snapshot_read_queue(cache, ifile, &params->q_head, &params->q_tail,
+                           sizeof(Sieve_obj_params_t))) {
+    return false;
+  }
+  params->pointer = snapshot_obj_at_pos(params->q_head, pointer_pos);
+  return true;
+}
+
 static void Sieve_verify(cache_t *cache) {
   Sieve_params_t *params = cache->eviction_params;
   int64_t n_obj = 0, n_byte = 0;
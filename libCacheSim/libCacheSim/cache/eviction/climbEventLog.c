@@ -0,0 +1,153 @@
+//
+//  climbEventLog.c
+//  libCacheSim
+//
+//  the controller records into a ring under a mutex, this happens once per
+//  adjustment interval so the lock is not contended, the writer thread wakes
+//  up when half of the ring is used (or once a second) and writes the events
+//  outside of the lock
+//
+
+#include "../../include/libCacheSim/evictionAlgo/climbEventLog.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../include/libCacheSim/logging.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct climb_event_log {
+  FILE *file;
+  char path[256];
+
+  climb_event_t *ring;
+  int64_t ring_size;
+  /* ring[head % ring_size] is the next event to write to the file,
+   * ring[tail % ring_size] is the next free slot */
+  int64_t head;
+  int64_t tail;
+  int64_t n_dropped;
+  int64_t n_written;
+
+  bool stop;
+  pthread_mutex_t mtx;
+  pthread_cond_t cond;
+  pthread_t writer;
+};
+
+/* write ring[head, tail) to the file, called without holding the lock,
+ * only the writer thread moves head */
+static void _write_events(climb_event_log_t *log, int64_t head,
+                          int64_t tail) {
+  while (head < tail) {
+    int64_t start = head % log->ring_size;
+    int64_t n = tail - head;
+    if (start + n > log->ring_size) n = log->ring_size - start;
+    if (fwrite(&log->ring[start], sizeof(climb_event_t), n, log->file) !=
+        (size_t)n) {
+      WARN("climb event log %s write error %s\n", log->path, strerror(errno));
+    }
+    head += n;
+  }
+}
+
+static void *_writer_thread(void *arg) {
+  climb_event_log_t *log = (climb_event_log_t *)arg;
+
+  pthread_mutex_lock(&log->mtx);
+  while (true) {
+    while (!log->stop && log->tail - log->head < log->ring_size / 2) {
+      struct timespec deadline;
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_sec += 1;
+      if (pthread_cond_timedwait(&log->cond, &log->mtx, &deadline) ==
+          ETIMEDOUT)
+        break;
+    }
+
+    int64_t head = log->head, tail = log->tail;
+    bool stop = log->stop;
+    pthread_mutex_unlock(&log->mtx);
+
+    _write_events(log, head, tail);
+
+    pthread_mutex_lock(&log->mtx);
+    log->head = tail;
+    log->n_written += tail - head;
+    if (stop && log->head == log->tail) break;
+  }
+  pthread_mutex_unlock(&log->mtx);
+
+  return NULL;
+}
+
+climb_event_log_t *climb_event_log_open(const char *path, int64_t ring_size) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    ERROR("cannot open climb event log %s %s\n", path, strerror(errno));
+    return NULL;
+  }
+
+  climb_event_log_header_t header = {.magic = CLIMB_EVENT_LOG_MAGIC,
+                                     .version = CLIMB_EVENT_LOG_VERSION,
+                                     .event_size = sizeof(climb_event_t)};
+  fwrite(&header, sizeof(header), 1, file);
+
+  climb_event_log_t *log = malloc(sizeof(climb_event_log_t));
+  memset(log, 0, sizeof(climb_event_log_t));
+  log->file = file;
+  strncpy(log->path, path, sizeof(log->path) - 1);
+  log->ring_size = ring_size > 2 ? ring_size : 2;
+  log->ring = malloc(sizeof(climb_event_t) * log->ring_size);
+  pthread_mutex_init(&log->mtx, NULL);
+  pthread_cond_init(&log->cond, NULL);
+  pthread_create(&log->writer, NULL, _writer_thread, log);
+
+  return log;
+}
+
+void climb_event_log_record(climb_event_log_t *log,
+                            const climb_event_t *event) {
+  pthread_mutex_lock(&log->mtx);
+  if (log->tail - log->head >= log->ring_size) {
+    log->n_dropped += 1;
+  } else {
+    log->ring[log->tail % log->ring_size] = *event;
+    log->tail += 1;
+    if (log->tail - log->head == log->ring_size / 2) {
+      pthread_cond_signal(&log->cond);
+    }
+  }
+  pthread_mutex_unlock(&log->mtx);
+}
+
+void climb_event_log_close(climb_event_log_t *log) {
+  pthread_mutex_lock(&log->mtx);
+  log->stop = true;
+  pthread_cond_signal(&log->cond);
+  pthread_mutex_unlock(&log->mtx);
+  pthread_join(log->writer, NULL);
+
+  if (log->n_dropped > 0) {
+    WARN("climb event log %s dropped %ld events, the ring is too small\n",
+         log->path, (long)log->n_dropped);
+  }
+  INFO("climb event log %s: %ld events\n", log->path, (long)log->n_written);
+
+  fclose(log->file);
+  pthread_cond_destroy(&log->cond);
+  pthread_mutex_destroy(&log->mtx);
+  free(log->ring);
+  free(log);
+}
+
+#ifdef __cplusplus
+}
+#endif
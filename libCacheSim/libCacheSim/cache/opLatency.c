@@ -0,0 +1,83 @@
+//
+//  opLatency.c
+//  libCacheSim
+//
+
+#include "../include/libCacheSim/opLatency.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const char *op_names[N_CACHE_OP] = {"find", "insert", "evict",
+                                           "can_insert"};
+
+op_latency_t *op_latency_create(void) {
+  op_latency_t *lat = calloc(1, sizeof(op_latency_t));
+  if (lat == NULL) {
+    ERROR("cannot allocate the op latency histograms\n");
+  }
+  return lat;
+}
+
+void op_latency_free(op_latency_t *lat) { free(lat); }
+
+uint64_t op_latency_percentile(const uint64_t *hist, uint64_t n_sample,
+                               double p) {
+  if (n_sample == 0) return 0;
+
+  /* the rank of the sample at percentile p, starting from 1 */
+  uint64_t rank = (uint64_t)(p * (double)n_sample);
+  if (rank < 1) rank = 1;
+  uint64_t n = 0;
+  for (int b = 0; b < OP_LATENCY_N_BUCKET; b++) {
+    n += hist[b];
+    if (n >= rank) {
+      /* the middle of the bucket */
+      uint64_t low = op_latency_bucket_low(b);
+      uint64_t high = b + 1 < OP_LATENCY_N_BUCKET
+                          ? op_latency_bucket_low(b + 1)
+                          : low + 1;
+      return low + (high - low) / 2;
+    }
+  }
+  return op_latency_bucket_low(OP_LATENCY_N_BUCKET - 1);
+}
+
+void op_latency_print(const op_latency_t *lat, const char *cache_name,
+                      FILE *ofile) {
+  fprintf(ofile, "%s op latency (cycles, 1/%d requests sampled):\n",
+          cache_name, OP_LATENCY_SAMPLE_RATE);
+  for (int op = 0; op < N_CACHE_OP; op++) {
+    if (lat->n_sampled[op] == 0) continue;
+    fprintf(ofile,
+            "    %-12s %10lu samples, p50 %8lu, p99 %8lu, p999 %8lu\n",
+            op_names[op], (unsigned long)lat->n_sampled[op],
+            (unsigned long)op_latency_percentile(lat->hist[op],
+                                                 lat->n_sampled[op], 0.5),
+            (unsigned long)op_latency_percentile(lat->hist[op],
+                                                 lat->n_sampled[op], 0.99),
+            (unsigned long)op_latency_percentile(lat->hist[op],
+                                                 lat->n_sampled[op], 0.999));
+  }
+  if (lat->n_sampled_insert > 0) {
+    fprintf(ofile,
+            "    %-12s %10lu samples, p50 %8lu, p99 %8lu, p999 %8lu\n",
+            "evict/insert", (unsigned long)lat->n_sampled_insert,
+            (unsigned long)op_latency_percentile(
+                lat->evict_iter_hist, lat->n_sampled_insert, 0.5),
+            (unsigned long)op_latency_percentile(
+                lat->evict_iter_hist, lat->n_sampled_insert, 0.99),
+            (unsigned long)op_latency_percentile(
+                lat->evict_iter_hist, lat->n_sampled_insert, 0.999));
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -124,6 +124,21 @@ cache_obj_t *chained_hashtable_find_obj_id_v2(const hashtable_t *hashtable,
   return cache_obj;
 }
 
+void chained_hashtable_prefetch_bucket_v2(const hashtable_t *hashtable,
+                                          const uint64_t hv) {
+  __builtin_prefetch(&hashtable->ptr_table[hv & hashmask(hashtable->hashpower)],
+                     0, 3);
+}
+
+void chained_hashtable_prefetch_obj_v2(const hashtable_t *hashtable,
+                                       const uint64_t hv) {
+  cache_obj_t *cache_obj =
+      hashtable->ptr_table[hv & hashmask(hashtable->hashpower)];
+  if (cache_obj != NULL) {
+    __builtin_prefetch(cache_obj, 1, 3);
+  }
+}
+
 cache_obj_t *chained_hashtable_find_v2(const hashtable_t *hashtable,
                                        const request_t *req) {
   return chained_hashtable_find_obj_id_v2(hashtable, req->obj_id);
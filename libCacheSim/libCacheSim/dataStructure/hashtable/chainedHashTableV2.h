@@ -42,6 +42,20 @@ void chained_hashtable_delete_v2(hashtable_t *hashtable,
 
 cache_obj_t *chained_hashtable_rand_obj_v2(const hashtable_t *hashtable);
 
+/**
+ * @brief prefetch the bucket slot of the object whose hash is hv
+ * (get_hash_value_int_64 of the obj_id), it does not block
+ */
+void chained_hashtable_prefetch_bucket_v2(const hashtable_t *hashtable,
+                                          const uint64_t hv);
+
+/**
+ * @brief prefetch the first object in the bucket of hv, the bucket slot
+ * should have been prefetched earlier, otherwise this waits for it
+ */
+void chained_hashtable_prefetch_obj_v2(const hashtable_t *hashtable,
+                                       const uint64_t hv);
+
 void chained_hashtable_foreach_v2(hashtable_t *hashtable,
                                   hashtable_iter iter_func, void *user_data);
 
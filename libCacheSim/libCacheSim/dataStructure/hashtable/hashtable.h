@@ -34,6 +34,8 @@ extern "C" {
 #define free_hashtable(hashtable) free_chained_hashtable(hashtable)
 #define hashtable_add_ptr_to_monitoring(hashtable, ptr) \
   chained_hashtable_add_ptr_to_monitoring(hashtable, ptr)
+#define hashtable_prefetch_bucket(hashtable, hv)
+#define hashtable_prefetch_obj(hashtable, hv)
 #define HASHTABLE_VER 1
 
 #elif HASHTABLE_TYPE == CHAINED_HASHTABLEV2
@@ -59,6 +61,10 @@ extern "C" {
   chained_hashtable_foreach_v2(hashtable, iter_func, user_data)
 #define free_hashtable(hashtable) free_chained_hashtable_v2(hashtable)
 #define hashtable_add_ptr_to_monitoring(hashtable, ptr)
+#define hashtable_prefetch_bucket(hashtable, hv) \
+  chained_hashtable_prefetch_bucket_v2(hashtable, hv)
+#define hashtable_prefetch_obj(hashtable, hv) \
+  chained_hashtable_prefetch_obj_v2(hashtable, hv)
 #define HASHTABLE_VER 2
 
 #elif HASHTABLE_TYPE == CUCKCOO_HASHTABLE
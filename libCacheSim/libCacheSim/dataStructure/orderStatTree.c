@@ -0,0 +1,269 @@
+//
+//  orderStatTree.c
+//  libCacheSim
+//
+//  an implicit treap: the in-order traversal gives the sequence, each node
+//  keeps the size of its subtree so that rank and select are O(log n),
+//  and the random priorities keep the expected depth logarithmic
+//
+
+#include "orderStatTree.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline uint32_t _node_size(const ost_node_t *node) {
+  return node == NULL ? 0 : node->size;
+}
+
+static inline void _update_size(ost_node_t *node) {
+  node->size = 1 + _node_size(node->left) + _node_size(node->right);
+}
+
+static inline uint32_t _next_priority(ost_t *tree) {
+  /* xorshift64 */
+  uint64_t x = tree->rand_state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  tree->rand_state = x;
+  return (uint32_t)(x >> 32);
+}
+
+static inline void _replace_child(ost_t *tree, ost_node_t *parent,
+                                  ost_node_t *old_child,
+                                  ost_node_t *new_child) {
+  if (parent == NULL) {
+    tree->root = new_child;
+  } else if (parent->left == old_child) {
+    parent->left = new_child;
+  } else {
+    parent->right = new_child;
+  }
+  if (new_child != NULL) new_child->parent = parent;
+}
+
+/* rotate node above its parent, the in-order sequence does not change */
+static void _rotate_up(ost_t *tree, ost_node_t *node) {
+  ost_node_t *parent = node->parent;
+  ost_node_t *grand_parent = parent->parent;
+
+  if (parent->left == node) {
+    parent->left = node->right;
+    if (node->right != NULL) node->right->parent = parent;
+    node->right = parent;
+  } else {
+    parent->right = node->left;
+    if (node->left != NULL) node->left->parent = parent;
+    node->left = parent;
+  }
+  parent->parent = node;
+  _replace_child(tree, grand_parent, parent, node);
+
+  _update_size(parent);
+  _update_size(node);
+}
+
+/* restore the heap order after node is linked as a leaf below parent */
+static void _link_leaf(ost_t *tree, ost_node_t *node, ost_node_t *parent) {
+  node->parent = parent;
+  while (node->parent != NULL && node->parent->priority < node->priority) {
+    _rotate_up(tree, node);
+  }
+}
+
+/* link a detached node so that it becomes the pos-th element */
+static void _attach_at(ost_t *tree, ost_node_t *node, int64_t pos) {
+  node->left = node->right = node->parent = NULL;
+  node->size = 1;
+
+  if (tree->root == NULL) {
+    tree->root = node;
+    return;
+  }
+
+  ost_node_t *cur = tree->root;
+  while (true) {
+    cur->size += 1;
+    int64_t left_size = _node_size(cur->left);
+    if (pos <= left_size + 1) {
+      if (cur->left == NULL) {
+        cur->left = node;
+        break;
+      }
+      cur = cur->left;
+    } else {
+      pos -= left_size + 1;
+      if (cur->right == NULL) {
+        cur->right = node;
+        break;
+      }
+      cur = cur->right;
+    }
+  }
+  _link_leaf(tree, node, cur);
+}
+
+/* link a detached node right before target, i.e., as the rightmost node of
+ * the left subtree of target */
+static void _attach_before(ost_t *tree, ost_node_t *node,
+                           ost_node_t *target) {
+  node->left = node->right = NULL;
+  node->size = 1;
+
+  ost_node_t *parent = target;
+  if (target->left == NULL) {
+    target->left = node;
+  } else {
+    parent = target->left;
+    while (parent->right != NULL) parent = parent->right;
+    parent->right = node;
+  }
+  for (ost_node_t *cur = parent; cur != NULL; cur = cur->parent) {
+    cur->size += 1;
+  }
+  _link_leaf(tree, node, parent);
+}
+
+/* unlink the node from the tree without freeing it */
+static void _detach(ost_t *tree, ost_node_t *node) {
+  /* rotate the node down until it has at most one child */
+  while (node->left != NULL && node->right != NULL) {
+    ost_node_t *child = node->left->priority > node->right->priority
+                            ? node->left
+                            : node->right;
+    _rotate_up(tree, child);
+  }
+
+  ost_node_t *child = node->left != NULL ? node->left : node->right;
+  ost_node_t *parent = node->parent;
+  _replace_child(tree, parent, node, child);
+
+  for (ost_node_t *cur = parent; cur != NULL; cur = cur->parent) {
+    cur->size -= 1;
+  }
+  node->left = node->right = node->parent = NULL;
+}
+
+ost_t *ost_create(void) {
+  ost_t *tree = malloc(sizeof(ost_t));
+  tree->root = NULL;
+  tree->rand_state = 0x9E3779B97F4A7C15ULL;
+  tree->free_nodes = NULL;
+  return tree;
+}
+
+static void _free_subtree(ost_node_t *node) {
+  /* iterative to avoid deep recursion on large trees */
+  while (node != NULL) {
+    if (node->left != NULL) {
+      ost_node_t *left = node->left;
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    } else {
+      ost_node_t *right = node->right;
+      free(node);
+      node = right;
+    }
+  }
+}
+
+void ost_free(ost_t *tree) {
+  _free_subtree(tree->root);
+  while (tree->free_nodes != NULL) {
+    ost_node_t *next = tree->free_nodes->parent;
+    free(tree->free_nodes);
+    tree->free_nodes = next;
+  }
+  free(tree);
+}
+
+ost_node_t *ost_insert_at(ost_t *tree, int64_t pos, void *data) {
+  assert(pos >= 1 && pos <= ost_size(tree) + 1);
+  ost_node_t *node = tree->free_nodes;
+  if (node != NULL) {
+    tree->free_nodes = node->parent;
+  } else {
+    node = malloc(sizeof(ost_node_t));
+  }
+  node->data = data;
+  node->priority = _next_priority(tree);
+  _attach_at(tree, node, pos);
+  return node;
+}
+
+void ost_remove(ost_t *tree, ost_node_t *node) {
+  _detach(tree, node);
+  node->data = NULL;
+  node->parent = tree->free_nodes;
+  tree->free_nodes = node;
+}
+
+void ost_move(ost_t *tree, ost_node_t *node, int64_t pos) {
+  assert(pos >= 1 && pos <= ost_size(tree));
+  _detach(tree, node);
+  _attach_at(tree, node, pos);
+}
+
+void ost_move_before(ost_t *tree, ost_node_t *node, ost_node_t *target) {
+  assert(node != target);
+  _detach(tree, node);
+  _attach_before(tree, node, target);
+}
+
+int64_t ost_rank(const ost_node_t *node) {
+  int64_t rank = _node_size(node->left) + 1;
+  while (node->parent != NULL) {
+    if (node->parent->right == node) {
+      rank += _node_size(node->parent->left) + 1;
+    }
+    node = node->parent;
+  }
+  return rank;
+}
+
+ost_node_t *ost_select(const ost_t *tree, int64_t pos) {
+  if (pos < 1 || pos > ost_size(tree)) return NULL;
+
+  ost_node_t *cur = tree->root;
+  while (cur != NULL) {
+    int64_t left_size = _node_size(cur->left);
+    if (pos <= left_size) {
+      cur = cur->left;
+    } else if (pos == left_size + 1) {
+      return cur;
+    } else {
+      pos -= left_size + 1;
+      cur = cur->right;
+    }
+  }
+  return NULL;
+}
+
+static bool _verify_subtree(const ost_node_t *node) {
+  if (node == NULL) return true;
+  if (node->size != 1 + _node_size(node->left) + _node_size(node->right))
+    return false;
+  if (node->left != NULL && (node->left->parent != node ||
+                             node->left->priority > node->priority))
+    return false;
+  if (node->right != NULL && (node->right->parent != node ||
+                              node->right->priority > node->priority))
+    return false;
+  return _verify_subtree(node->left) && _verify_subtree(node->right);
+}
+
+bool ost_verify(const ost_t *tree) {
+  if (tree->root != NULL && tree->root->parent != NULL) return false;
+  return _verify_subtree(tree->root);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,116 @@
+//
+//  an order-statistic tree (implicit treap) that indexes a sequence by
+//  position, it is used to find the rank of an element, the element at a
+//  given rank, and to move an element to a new rank in O(log n)
+//
+//  the tree does not own the data, it is usually used alongside the
+//  cache_obj_t queue so that algorithms that move objects by an offset
+//  (e.g., Climb) do not need to walk the list
+//
+//  positions are 1-based, position 1 is the head of the sequence
+//
+//  orderStatTree.h
+//  libCacheSim
+//
+
+#ifndef ORDER_STAT_TREE_H
+#define ORDER_STAT_TREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ost_node {
+  struct ost_node *left;
+  struct ost_node *right;
+  struct ost_node *parent;
+  void *data;
+  /* number of nodes in the subtree rooted at this node */
+  uint32_t size;
+  uint32_t priority;
+} ost_node_t;
+
+typedef struct {
+  ost_node_t *root;
+  uint64_t rand_state;
+  /* removed nodes linked by parent, reused by the next insert so that a
+   * cache that evicts one object per insert does not call malloc */
+  ost_node_t *free_nodes;
+} ost_t;
+
+/**
+ * @brief create an empty tree
+ */
+ost_t *ost_create(void);
+
+/**
+ * @brief free the tree and all its nodes, the data is not freed
+ */
+void ost_free(ost_t *tree);
+
+/**
+ * @brief number of elements in the tree
+ */
+static inline int64_t ost_size(const ost_t *tree) {
+  return tree->root == NULL ? 0 : tree->root->size;
+}
+
+/**
+ * @brief insert data so that it becomes the pos-th element,
+ * pos must be in [1, ost_size + 1]
+ *
+ * @return the node holding data, the caller needs to keep it to
+ * query the rank or to move and remove the element later
+ */
+ost_node_t *ost_insert_at(ost_t *tree, int64_t pos, void *data);
+
+static inline ost_node_t *ost_push_front(ost_t *tree, void *data) {
+  return ost_insert_at(tree, 1, data);
+}
+
+static inline ost_node_t *ost_push_back(ost_t *tree, void *data) {
+  return ost_insert_at(tree, ost_size(tree) + 1, data);
+}
+
+/**
+ * @brief remove the node from the tree, the node is kept for reuse
+ */
+void ost_remove(ost_t *tree, ost_node_t *node);
+
+/**
+ * @brief move the node so that it becomes the pos-th element,
+ * pos must be in [1, ost_size], the node is reused so the caller's
+ * reference stays valid
+ */
+void ost_move(ost_t *tree, ost_node_t *node, int64_t pos);
+
+/**
+ * @brief move the node so that it is right before target, this does not
+ * need the position of either node, target must not be node
+ */
+void ost_move_before(ost_t *tree, ost_node_t *node, ost_node_t *target);
+
+/**
+ * @brief the 1-based position of the node in the sequence
+ */
+int64_t ost_rank(const ost_node_t *node);
+
+/**
+ * @brief the node at the 1-based position, NULL if out of range
+ */
+ost_node_t *ost_select(const ost_t *tree, int64_t pos);
+
+/**
+ * @brief check the size and parent invariants, used in debugging
+ */
+bool ost_verify(const ost_t *tree);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ORDER_STAT_TREE_H */
@@ -0,0 +1,88 @@
+//
+//  slidingWindow.c
+//  libCacheSim
+//
+
+#include "slidingWindow.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int64_t _n_words(int64_t window) { return (window + 63) / 64; }
+
+sliding_window_t *sliding_window_create(int64_t window_size) {
+  assert(window_size > 0);
+  sliding_window_t *sw = malloc(sizeof(sliding_window_t));
+  sw->window = window_size;
+  sw->words = calloc(_n_words(window_size), sizeof(uint64_t));
+  sw->pos = 0;
+  sw->n_recorded = 0;
+  sw->n_hit = 0;
+  return sw;
+}
+
+void sliding_window_free(sliding_window_t *sw) {
+  free(sw->words);
+  free(sw);
+}
+
+void sliding_window_reset(sliding_window_t *sw) {
+  memset(sw->words, 0, _n_words(sw->window) * sizeof(uint64_t));
+  sw->pos = 0;
+  sw->n_recorded = 0;
+  sw->n_hit = 0;
+}
+
+bool sliding_window_save(const sliding_window_t *sw, FILE *ofile) {
+  return fwrite(&sw->window, sizeof(int64_t), 1, ofile) == 1 &&
+         fwrite(&sw->pos, sizeof(int64_t), 1, ofile) == 1 &&
+         fwrite(&sw->n_recorded, sizeof(int64_t), 1, ofile) == 1 &&
+         fwrite(&sw->n_hit, sizeof(int64_t), 1, ofile) == 1 &&
+         fwrite(sw->words, sizeof(uint64_t), _n_words(sw->window), ofile) ==
+             (size_t)_n_words(sw->window);
+}
+
+bool sliding_window_load(sliding_window_t *sw, FILE *ifile) {
+  int64_t window, pos, n_recorded, n_hit;
+  if (fread(&window, sizeof(int64_t), 1, ifile) != 1 ||
+      fread(&pos, sizeof(int64_t), 1, ifile) != 1 ||
+      fread(&n_recorded, sizeof(int64_t), 1, ifile) != 1 ||
+      fread(&n_hit, sizeof(int64_t), 1, ifile) != 1) {
+    return false;
+  }
+  /* the window is filled from slot 0 until it wraps around */
+  if (window != sw->window || pos < 0 || pos >= window || n_recorded < 0 ||
+      n_recorded > window || (n_recorded < window && pos != n_recorded)) {
+    return false;
+  }
+
+  int64_t n_words = _n_words(window);
+  uint64_t *words = malloc(n_words * sizeof(uint64_t));
+  bool ok = fread(words, sizeof(uint64_t), n_words, ifile) == (size_t)n_words;
+  if (ok) {
+    /* the slots past the window are never set */
+    int64_t cnt = 0;
+    for (int64_t i = 0; i < n_words; i++) {
+      cnt += __builtin_popcountll(words[i]);
+    }
+    if (window & 63) ok = (words[n_words - 1] >> (window & 63)) == 0;
+    ok = ok && cnt == n_hit;
+  }
+  if (ok) {
+    memcpy(sw->words, words, n_words * sizeof(uint64_t));
+    sw->pos = pos;
+    sw->n_recorded = n_recorded;
+    sw->n_hit = n_hit;
+  }
+  free(words);
+  return ok;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+//
+//  a sliding window of hit/miss outcomes, one bit per request stored in a
+//  ring of 64-bit words
+//
+//  adding an outcome is O(1) and keeps the hit count of the whole window
+//
+//  slidingWindow.h
+//  libCacheSim
+//
+
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint64_t *words;
+  /* the number of requests in the window */
+  int64_t window;
+  /* the slot of the next request */
+  int64_t pos;
+  /* the number of requests recorded, capped at window */
+  int64_t n_recorded;
+  /* the number of hits in the window */
+  int64_t n_hit;
+} sliding_window_t;
+
+/**
+ * @brief create a window of the last window_size requests
+ */
+sliding_window_t *sliding_window_create(int64_t window_size);
+
+void sliding_window_free(sliding_window_t *sw);
+
+/**
+ * @brief record the outcome of one request, the oldest outcome is dropped
+ * when the window is full
+ */
+static inline void sliding_window_add(sliding_window_t *sw, bool hit) {
+  uint64_t *word = &sw->words[sw->pos >> 6];
+  uint64_t mask = 1ULL << (sw->pos & 63);
+  if (*word & mask) sw->n_hit--;
+  if (hit) {
+    *word |= mask;
+    sw->n_hit++;
+  } else {
+    *word &= ~mask;
+  }
+  if (++sw->pos == sw->window) sw->pos = 0;
+  if (sw->n_recorded < sw->window) sw->n_recorded++;
+}
+
+/**
+ * @brief the number of hits among the last window requests
+ */
+static inline int64_t sliding_window_n_hit(const sliding_window_t *sw) {
+  return sw->n_hit;
+}
+
+/**
+ * @brief the hit ratio over the whole window, requests not seen yet
+ * (at the beginning) count as misses
+ */
+static inline double sliding_window_hit_ratio(const sliding_window_t *sw) {
+  return (double)sw->n_hit / (double)sw->window;
+}
+
+/**
+ * @brief reset the window to the state after creation
+ */
+void sliding_window_reset(sliding_window_t *sw);
+
+/**
+ * @brief write the window to a snapshot
+ */
+bool sliding_window_save(const sliding_window_t *sw, FILE *ofile);
+
+/**
+ * @brief read a window written by sliding_window_save into sw
+ *
+ * @return false if the saved window has a different size than sw or its
+ * position and counts are not consistent, sw is not changed then
+ */
+bool sliding_window_load(sliding_window_t *sw, FILE *ifile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SLIDING_WINDOW_H */
@@ -51,6 +51,7 @@ extern "C" {
 // #define TRACK_EVICTION_V_AGE
 // #define TRACK_DEMOTION
 // #define TRACK_CREATE_TIME
+// #define TRACK_OP_LATENCY
 
 #if defined(TRACK_EVICTION_V_AGE) || defined(TRACK_DEMOTION) || \
     defined(TRACK_CREATE_TIME)
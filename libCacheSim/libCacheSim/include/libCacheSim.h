@@ -8,6 +8,7 @@
 #include "config.h"
 #include "libCacheSim/cache.h"
 #include "libCacheSim/cacheObj.h"
+#include "libCacheSim/cacheSnapshot.h"
 #include "libCacheSim/const.h"
 #include "libCacheSim/enum.h"
 #include "libCacheSim/logging.h"
@@ -17,6 +17,7 @@
 #include "const.h"
 #include "logging.h"
 #include "macro.h"
+#include "opLatency.h"
 #include "request.h"
 
 #ifdef __cplusplus
@@ -43,6 +44,9 @@ typedef void (*cache_free_func_ptr)(cache_t *);
 
 typedef bool (*cache_get_func_ptr)(cache_t *, const request_t *);
 
+typedef void (*cache_get_batch_func_ptr)(cache_t *, request_t *reqs, int n,
+                                         bool *hits);
+
 typedef cache_obj_t *(*cache_find_func_ptr)(cache_t *, const request_t *,
                                             const bool);
 
@@ -66,6 +70,11 @@ typedef int64_t (*cache_get_n_obj_func_ptr)(const cache_t *);
 
 typedef void (*cache_print_cache_func_ptr)(const cache_t *);
 
+/* write/read the algorithm state, see cacheSnapshot.h */
+typedef bool (*cache_snapshot_func_ptr)(const cache_t *, FILE *);
+
+typedef bool (*cache_restore_func_ptr)(cache_t *, FILE *);
+
 // #define EVICTION_AGE_ARRAY_SZE 40
 #define EVICTION_AGE_ARRAY_SZE 320
 #define EVICTION_AGE_LOG_BASE 1.08
@@ -96,6 +105,8 @@ struct cache {
   cache_init_func_ptr cache_init;
   cache_free_func_ptr cache_free;
   cache_get_func_ptr get;
+  // get n requests in order, hits[i] is the result of reqs[i]
+  cache_get_batch_func_ptr get_batch;
 
   cache_find_func_ptr find;
   cache_can_insert_func_ptr can_insert;
@@ -107,6 +118,9 @@ struct cache {
   cache_get_occupied_byte_func_ptr get_occupied_byte;
   cache_get_n_obj_func_ptr get_n_obj;
   cache_print_cache_func_ptr print_cache;
+  // NULL if the algorithm does not support snapshots
+  cache_snapshot_func_ptr snapshot;
+  cache_restore_func_ptr restore;
 
   admissioner_t *admissioner;
 
@@ -116,6 +130,12 @@ struct cache {
 
   // other name: logical_time, virtual_time, reference_count
   int64_t n_req; /* number of requests (used by some eviction algo) */
+  /* number of evictions made to make room for an insert, by cache_get_base
+   * or by the algorithms that evict in their own insert */
+  int64_t n_evict;
+  /* the next_rand state of the cache when a simulation thread runs several
+   * caches (see set_rand_state), starts from seed 0 */
+  uint64_t rand_state;
 
   /**************** private fields *****************/
   // use cache->get_n_obj to obtain the number of objects in the cache
@@ -153,6 +173,10 @@ struct cache {
 #if defined(TRACK_DEMOTION)
   bool track_demotion;
 #endif
+  /* the sampled op latencies, NULL unless built with TRACK_OP_LATENCY, the
+   * field is always there so that the layout of cache_t does not depend on
+   * the flag */
+  op_latency_t *op_latency;
 
   /* not used by most algorithms */
   int32_t *future_stack_dist;
@@ -222,6 +246,37 @@ cache_obj_t *cache_find_base(cache_t *cache, const request_t *req,
  */
 bool cache_get_base(cache_t *cache, const request_t *req);
 
+/**
+ * @brief the default get_batch, it calls cache->get on each request
+ *
+ * @param cache
+ * @param reqs the requests, processed in order
+ * @param n the number of requests
+ * @param hits the output, hits[i] is true if reqs[i] is a hit
+ */
+void cache_get_batch_default(cache_t *cache, request_t *reqs, int n,
+                             bool *hits);
+
+/**
+ * @brief a get_batch for algorithms that store objects in cache->hashtable,
+ * it prefetches the hash bucket and the first object in the bucket of the
+ * requests ahead before calling get on the current request, which hides
+ * the memory latency of the hashtable on large working sets
+ *
+ * the hash of each request is computed once and kept in req->hv, a request
+ * that already has req->hv (e.g., set by the sampler or by the caller) is
+ * not hashed again, so callers that share the requests between caches
+ * running concurrently should set req->hv before
+ *
+ * @param cache
+ * @param reqs the requests, processed in order
+ * @param n the number of requests
+ * @param hits the output, hits[i] is true if reqs[i] is a hit
+ * @param get the get function of the algorithm
+ */
+void cache_get_batch_prefetch(cache_t *cache, request_t *reqs, int n,
+                              bool *hits, cache_get_func_ptr get);
+
 /**
  * @brief check whether the object can be inserted into the cache
  *
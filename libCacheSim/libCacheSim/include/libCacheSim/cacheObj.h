@@ -125,6 +125,11 @@ typedef struct {
   int32_t freq;
 } __attribute__((packed)) Sieve_obj_params_t;
 
+typedef struct {
+  /* the node in the position index (orderStatTree) */
+  void *pos_node;
+} Climb_obj_metadata_t;
+
 typedef struct {
   int64_t next_access_vtime;
   int32_t freq;
@@ -177,6 +182,7 @@ typedef struct cache_obj {
     LIRS_obj_metadata_t LIRS;
     S3FIFO_obj_metadata_t S3FIFO;
     Sieve_obj_params_t sieve;
+    Climb_obj_metadata_t climb;
 
 #if defined(ENABLE_GLCACHE) && ENABLE_GLCACHE == 1
     GLCache_obj_metadata_t GLCache;
@@ -0,0 +1,153 @@
+//
+//  save the state of a cache (and optionally the position of the reader) to
+//  a file and restore it later, so that a long simulation can resume after a
+//  crash and a warmed-up cache can be reused by several runs
+//
+//  the snapshot holds the cached objects in eviction order, the cache
+//  counters and the adaptive state of the eviction algorithm, pointers
+//  (hash chains, queue links, position indexes) are rebuilt on restore
+//
+//  only algorithms that set cache->snapshot and cache->restore support it:
+//  LRU, FIFO, Sieve, S3FIFO, AdaptiveClimb and DynamicAdaptiveClimb
+//
+//  cacheSnapshot.h
+//  libCacheSim
+//
+
+#ifndef CACHE_SNAPSHOT_H
+#define CACHE_SNAPSHOT_H
+
+#include <stdio.h>
+
+#include "cache.h"
+#include "reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CACHE_SNAPSHOT_MAGIC "LCSSNAP"
+#define CACHE_SNAPSHOT_VERSION 3
+
+/**
+ * @brief write the cache and the reader position to path
+ *
+ * @param cache
+ * @param reader the reader that feeds the cache, NULL to skip the position
+ * @param path
+ * @return whether the snapshot is written
+ */
+bool cache_snapshot_save(const cache_t *cache, const reader_t *reader,
+                         const char *path);
+
+/**
+ * @brief restore a snapshot written by cache_snapshot_save
+ *
+ * the cache must be newly created (empty) and of the same algorithm as the
+ * snapshot, its tunable parameters and size may differ, so a warmed-up state
+ * can be forked into parameter variants, a smaller cache evicts down to its
+ * size on the following misses
+ *
+ * @param cache
+ * @param reader if not NULL, it is moved to the saved position
+ * @param path
+ * @return whether the snapshot is restored, the cache should be freed if not
+ */
+bool cache_snapshot_load(cache_t *cache, reader_t *reader, const char *path);
+
+/**
+ * @brief write the cache state to a stream, used by cache_snapshot_save
+ * and by algorithms that are made of other caches
+ */
+bool cache_snapshot_write(const cache_t *cache, FILE *ofile);
+
+/**
+ * @brief read a cache state written by cache_snapshot_write
+ */
+bool cache_snapshot_read(cache_t *cache, FILE *ifile);
+
+/**
+ * @brief write the cache state to a memory buffer, the buffer should be
+ * freed by the user with free
+ *
+ * @param cache
+ * @param buf the buffer
+ * @param size the number of bytes in the buffer
+ */
+bool cache_snapshot_to_buf(const cache_t *cache, char **buf, size_t *size);
+
+/**
+ * @brief restore a cache state from a buffer written by
+ * cache_snapshot_to_buf, the same buffer can be restored by several threads
+ * at the same time
+ */
+bool cache_snapshot_from_buf(cache_t *cache, const char *buf, size_t size);
+
+/**
+ * @brief copy the objects, queues and the adaptive state of src into dst,
+ * dst must be empty and of the same algorithm, its parameters and size may
+ * differ
+ */
+bool cache_copy_state(const cache_t *src, cache_t *dst);
+
+/**
+ * @brief a deep copy of cache, clone_cache creates an empty cache with the
+ * same parameters, this one also copies the cached objects and the state of
+ * the eviction algorithm, so the copy behaves the same as cache on the
+ * following requests
+ *
+ * @return the copy, NULL if the algorithm does not support snapshots
+ */
+cache_t *clone_cache_with_state(const cache_t *cache);
+
+/************** used by the snapshot/restore of eviction algorithms *********/
+
+static inline bool snapshot_write(FILE *ofile, const void *data, size_t size) {
+  return fwrite(data, size, 1, ofile) == 1;
+}
+
+static inline bool snapshot_read(FILE *ifile, void *data, size_t size) {
+  return fread(data, size, 1, ifile) == 1;
+}
+
+/**
+ * @brief write the objects of a queue from head to tail
+ *
+ * @param ofile
+ * @param head
+ * @param md_size the bytes of the per-object metadata union to keep, e.g.,
+ * sizeof(S3FIFO_obj_metadata_t), pointers in the union must not be kept
+ */
+bool snapshot_write_queue(FILE *ofile, const cache_obj_t *head,
+                          size_t md_size);
+
+/**
+ * @brief read a queue written by snapshot_write_queue, the objects are
+ * inserted into the hashtable of cache and appended to the queue in order
+ *
+ * @param cache
+ * @param ifile
+ * @param head
+ * @param tail
+ * @param md_size must be the same as the one used to write the queue
+ */
+bool snapshot_read_queue(cache_t *cache, FILE *ifile, cache_obj_t **head,
+                         cache_obj_t **tail, size_t md_size);
+
+/**
+ * @brief the position of obj in the queue starting at head (0 is the head),
+ * -1 if obj is NULL, used to save pointers into a queue
+ */
+int64_t snapshot_obj_pos(const cache_obj_t *head, const cache_obj_t *obj);
+
+/**
+ * @brief the object at pos in the queue starting at head, NULL if pos is -1
+ * or out of the queue
+ */
+cache_obj_t *snapshot_obj_at_pos(cache_obj_t *head, int64_t pos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_SNAPSHOT_H */
@@ -62,6 +62,12 @@ typedef enum {
   VALPIN_TRACE,
   // ORACLE_WIKI19t_TRACE,
 
+  /* block-columnar compressed oracleGeneral */
+  COLUMNAR_TRACE,
+
+  /* generated on the fly, the trace path is the spec */
+  SYNTHETIC_TRACE,
+
   UNKNOWN_TRACE,
 } __attribute__((__packed__)) trace_type_e;
 
@@ -95,6 +101,8 @@ static char *g_trace_type_name[UNKNOWN_TRACE + 2] = {
     "ORACLE_WIKI19u_TRACE",
     "VALPIN_TRACE",
     // "ORACLE_WIKI19t_TRACE",
+    "COLUMNAR_TRACE",
+    "SYNTHETIC_TRACE",
     "UNKNOWN_TRACE",
 };
 
@@ -206,12 +206,40 @@ cache_t *GLCache_init(const common_cache_params_t ccache_params,
 cache_t *AdaptiveClimb_init(const common_cache_params_t ccache_params,
                         const char *cache_specific_params);
 
+/* the requests of one size class of a size-aware AdaptiveClimb cache */
+typedef struct {
+  int64_t n_req;
+  int64_t n_miss;
+  int64_t n_req_byte;
+  int64_t n_miss_byte;
+} climb_size_class_stat_t;
+
+/**
+ * @brief copy the statistics of the size classes of a size-aware
+ * AdaptiveClimb cache, class i holds the objects of size [4^i, 4^(i+1)),
+ * the last class also holds the larger ones
+ *
+ * @param stats an array of at least n elements
+ * @return the number of classes copied, 0 if the cache is not size-aware
+ */
+int AdaptiveClimb_get_size_class_stats(const cache_t *cache,
+                                       climb_size_class_stat_t *stats, int n);
+
 cache_t *AdaptiveClimbII_init(const common_cache_params_t ccache_params,
                                const char *cache_specific_params);
 
 cache_t *DynamicAdaptiveClimb_init(const common_cache_params_t ccache_params,
                                    const char *cache_specific_params);
 
+cache_t *AdaptiveClimbSharded_init(const common_cache_params_t ccache_params,
+                                   const char *cache_specific_params);
+
+/**
+ * @brief the hit ratio over all shards of an AdaptiveClimbSharded cache,
+ * safe to call while other threads use the cache
+ */
+double AdaptiveClimbSharded_get_hit_ratio(const cache_t *cache);
+
 cache_t *iLRU_init(const common_cache_params_t ccache_params,
                   const char *cache_specific_params);
 
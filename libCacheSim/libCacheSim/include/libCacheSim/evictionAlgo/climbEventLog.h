@@ -0,0 +1,67 @@
+#pragma once
+//
+//  a binary log of the AdaptiveClimb/DynamicAdaptiveClimb controller, one
+//  event is recorded each time the controller adjusts K and jump
+//
+//  events are copied into a preallocated ring and written to the file by a
+//  background thread, so the request path never does I/O, if the ring is
+//  full the event is dropped and counted
+//
+//  file layout: climb_event_log_header_t followed by climb_event_t records,
+//  use the climbLogDecode tool (bin/traceUtils) to convert it to csv
+//
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLIMB_EVENT_LOG_MAGIC 0x474F4C424D494C43ULL /* "CLIMBLOG" */
+#define CLIMB_EVENT_LOG_VERSION 1
+
+typedef struct {
+  uint64_t magic;
+  uint32_t version;
+  /* sizeof(climb_event_t) when the log was written */
+  uint32_t event_size;
+} climb_event_log_header_t;
+
+typedef struct {
+  /* the number of requests seen by the cache at the adjustment */
+  int64_t n_req;
+  /* the miss ratio of the hit/miss window */
+  double miss_ratio;
+  /* DynamicAdaptiveClimb only, equals miss_ratio for AdaptiveClimb */
+  double ema_miss_ratio;
+  int32_t K;
+  int32_t jump;
+  int32_t fallback_counter;
+  int32_t in_fallback;
+} climb_event_t;
+
+typedef struct climb_event_log climb_event_log_t;
+
+/**
+ * @brief open the log file and start the writer thread
+ *
+ * @param path the output file, it is truncated
+ * @param ring_size the number of events the ring holds
+ * @return NULL if the file cannot be opened
+ */
+climb_event_log_t *climb_event_log_open(const char *path, int64_t ring_size);
+
+/**
+ * @brief append one event, never blocks on I/O
+ */
+void climb_event_log_record(climb_event_log_t *log, const climb_event_t *event);
+
+/**
+ * @brief write the remaining events, stop the writer and close the file
+ */
+void climb_event_log_close(climb_event_log_t *log);
+
+#ifdef __cplusplus
+}
+#endif
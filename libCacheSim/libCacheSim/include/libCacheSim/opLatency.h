@@ -0,0 +1,164 @@
+//
+//  the latency of find, insert, evict and can_insert of a cache, measured in
+//  cycles (rdtsc on x86) around the calls made by cache_get_base, and the
+//  number of evictions each insert needs
+//
+//  it is compiled in only with TRACK_OP_LATENCY (cmake -DENABLE_OP_LATENCY=ON),
+//  one in OP_LATENCY_SAMPLE_RATE requests is timed so that the timer does not
+//  dominate the cheap operations, the latencies are kept in log-bucketed
+//  histograms (four buckets per power of two), the percentiles are accurate
+//  to about 12%
+//
+//  algorithms that do not use cache_get_base are not measured unless they
+//  time their own ops with the macros below, as DynamicAdaptiveClimb does
+//
+//  opLatency.h
+//  libCacheSim
+//
+
+#ifndef OP_LATENCY_H
+#define OP_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef OP_LATENCY_SAMPLE_RATE
+#define OP_LATENCY_SAMPLE_RATE 64
+#endif
+
+/* the number of sub-buckets per power of two is 1 << OP_LATENCY_SUB_BITS */
+#define OP_LATENCY_SUB_BITS 2
+#define OP_LATENCY_N_BUCKET (64 << OP_LATENCY_SUB_BITS)
+
+typedef enum {
+  CACHE_OP_FIND,
+  CACHE_OP_INSERT,
+  CACHE_OP_EVICT,
+  CACHE_OP_CAN_INSERT,
+
+  N_CACHE_OP
+} cache_op_e;
+
+typedef struct op_latency {
+  /* the number of requests seen, used for sampling */
+  uint64_t n_req;
+  uint64_t n_sampled[N_CACHE_OP];
+  uint64_t hist[N_CACHE_OP][OP_LATENCY_N_BUCKET];
+  /* the number of evictions to make room for one insert */
+  uint64_t n_sampled_insert;
+  uint64_t evict_iter_hist[OP_LATENCY_N_BUCKET];
+} op_latency_t;
+
+op_latency_t *op_latency_create(void);
+
+void op_latency_free(op_latency_t *lat);
+
+/**
+ * @brief the value at percentile p (0 - 1) of a histogram, in cycles for
+ * the ops, 0 if there is no sample
+ */
+uint64_t op_latency_percentile(const uint64_t *hist, uint64_t n_sample,
+                               double p);
+
+/**
+ * @brief print the p50, p99 and p999 latency of each op and of the evictions
+ * per insert
+ */
+void op_latency_print(const op_latency_t *lat, const char *cache_name,
+                      FILE *ofile);
+
+/* the current time in cycles, or in ns where there is no cycle counter */
+static inline uint64_t op_latency_now(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t t;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(t));
+  return t;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline int op_latency_bucket(uint64_t v) {
+  const int n_sub = 1 << OP_LATENCY_SUB_BITS;
+  if (v < (uint64_t)n_sub) return (int)v;
+  int msb = 63 - __builtin_clzll(v);
+  return (msb - OP_LATENCY_SUB_BITS + 1) * n_sub +
+         (int)((v >> (msb - OP_LATENCY_SUB_BITS)) & (n_sub - 1));
+}
+
+/* the smallest value in bucket b */
+static inline uint64_t op_latency_bucket_low(int b) {
+  const int n_sub = 1 << OP_LATENCY_SUB_BITS;
+  if (b < n_sub) return (uint64_t)b;
+  int msb = b / n_sub + OP_LATENCY_SUB_BITS - 1;
+  return (uint64_t)(n_sub + b % n_sub) << (msb - OP_LATENCY_SUB_BITS);
+}
+
+/* whether the current request is timed */
+static inline bool op_latency_sample(op_latency_t *lat) {
+  return lat->n_req++ % OP_LATENCY_SAMPLE_RATE == 0;
+}
+
+static inline void op_latency_record(op_latency_t *lat, cache_op_e op,
+                                     uint64_t cycles) {
+  lat->n_sampled[op]++;
+  lat->hist[op][op_latency_bucket(cycles)]++;
+}
+
+static inline void op_latency_record_evict_iter(op_latency_t *lat,
+                                                uint64_t n_evict) {
+  lat->n_sampled_insert++;
+  lat->evict_iter_hist[op_latency_bucket(n_evict)]++;
+}
+
+#ifdef TRACK_OP_LATENCY
+#define OP_LATENCY_SAMPLE(cache) op_latency_sample((cache)->op_latency)
+/* run stmt, and record how long it takes when sampled */
+#define OP_LATENCY_TIME(cache, sampled, op, stmt)                        \
+  do {                                                                   \
+    if (sampled) {                                                       \
+      uint64_t _op_start = op_latency_now();                             \
+      stmt;                                                              \
+      op_latency_record((cache)->op_latency, op,                         \
+                        op_latency_now() - _op_start);                   \
+    } else {                                                             \
+      stmt;                                                              \
+    }                                                                    \
+  } while (0)
+#define OP_LATENCY_EVICT_ITER(cache, sampled, n_evict)                   \
+  do {                                                                   \
+    if (sampled) op_latency_record_evict_iter((cache)->op_latency, n_evict); \
+  } while (0)
+#else
+#define OP_LATENCY_SAMPLE(cache) false
+#define OP_LATENCY_TIME(cache, sampled, op, stmt) \
+  do {                                            \
+    (void)(sampled);                              \
+    stmt;                                         \
+  } while (0)
+#define OP_LATENCY_EVICT_ITER(cache, sampled, n_evict) \
+  do {                                                 \
+    (void)(sampled);                                   \
+    (void)(n_evict);                                   \
+  } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OP_LATENCY_H */
@@ -39,6 +39,9 @@ typedef struct {
   bool ignore_obj_size;
   bool ignore_size_zero_req;
   bool obj_id_is_num;
+  /* record the string object ids and check whether two different strings
+   * are hashed to the same obj_id, it uses memory for every object */
+  bool audit_str_obj_id;
   int64_t cap_at_n_req;  // only process at most n_req requests
 
   int time_field;
@@ -112,6 +115,11 @@ typedef struct reader {
   bool csv_has_header;
   /* whether the object id is hashed */
   bool obj_id_is_num;
+  /* obj_id -> the first string object id hashed to it, only used when
+   * auditing the hash, n_str_obj_id_collision is the number of requests
+   * whose string differs from the recorded one */
+  GHashTable *str_obj_id_table;
+  uint64_t n_str_obj_id_collision;
 
   bool ignore_size_zero_req;
   /* if true, ignore the obj_size in the trace, and use size one */
@@ -229,6 +237,82 @@ static inline int read_trace(reader_t *const reader, request_t *const req) {
   return read_one_req(reader, req);
 }
 
+/* a batch of requests stored as arrays of each field, filled by read_n_req */
+typedef struct {
+  int n_req;
+  int capacity;
+  /* the next request returned by read_one_req_from_batch */
+  int pos;
+
+  int64_t *clock_time;
+  obj_id_t *obj_id;
+  int64_t *obj_size;
+  int64_t *next_access_vtime;
+
+  /* used to read the traces that do not have a batch decoder */
+  request_t *req;
+} req_batch_t;
+
+req_batch_t *new_req_batch(int capacity);
+
+void free_req_batch(req_batch_t *batch);
+
+/**
+ * @brief read at most n requests (and at most the batch capacity) into
+ * batch, oracleGeneral, LCS (binary) and columnar traces are decoded by a
+ * loop over each field, other traces, compressed traces and readers with a
+ * sampler use read_one_req for each request
+ *
+ * the batch only has clock_time, obj_id, obj_size and next_access_vtime,
+ * see reader_batch_has_all_fields
+ *
+ * @return the number of requests read, fewer than n only at the end of the
+ * trace (or at cap_at_n_req)
+ */
+int read_n_req(reader_t *reader, req_batch_t *batch, int n);
+
+/**
+ * @brief whether the batch has all the fields that read_one_req returns for
+ * this trace, i.e., read_one_req_from_batch returns the same requests as
+ * read_one_req
+ */
+bool reader_batch_has_all_fields(const reader_t *reader);
+
+/* copy the i-th request of batch to req, the fields that are not in the
+ * batch are not changed */
+static inline void req_batch_get_req(const req_batch_t *const batch,
+                                     const int i, request_t *const req) {
+  req->clock_time = batch->clock_time[i];
+  req->obj_id = batch->obj_id[i];
+  req->obj_size = batch->obj_size[i];
+  req->next_access_vtime = batch->next_access_vtime[i];
+  req->hv = 0;
+  req->ttl = 0;
+  req->valid = true;
+}
+
+/**
+ * @brief read one request through batch, the next batch is read with
+ * read_n_req when all the requests in batch have been returned, the reader
+ * is ahead of the returned request by up to a batch, a NULL batch is the
+ * same as read_one_req
+ *
+ * @return 0 on success and 1 if reach end of trace
+ */
+static inline int read_one_req_from_batch(reader_t *const reader,
+                                          req_batch_t *const batch,
+                                          request_t *const req) {
+  if (batch == NULL) return read_one_req(reader, req);
+
+  if (batch->pos >= batch->n_req &&
+      read_n_req(reader, batch, batch->capacity) == 0) {
+    req->valid = false;
+    return 1;
+  }
+  req_batch_get_req(batch, batch->pos++, req);
+  return 0;
+}
+
 /**
  * reset reader, so we can read from the beginning
  * @param reader
@@ -265,6 +349,42 @@ int go_back_one_req(reader_t *reader);
 
 void reader_set_read_pos(reader_t *reader, double pos);
 
+/* the position of a reader between two requests, used to resume a
+ * simulation from a snapshot */
+typedef struct {
+  uint64_t n_read_req;
+  /* mmap_offset for binary traces, the file offset for txt and csv traces,
+   * the offset in the decompressed data for zstd traces */
+  int64_t offset;
+  int32_t n_req_left;
+  int64_t last_req_clock_time;
+} reader_pos_t;
+
+/**
+ * @brief get the current position of the reader
+ */
+void reader_get_pos(const reader_t *reader, reader_pos_t *pos);
+
+/**
+ * @brief move the reader to a position returned by reader_get_pos,
+ * a zstd-compressed trace decompresses only the frame that has the position
+ * if its frame index is complete (see get_num_of_req)
+ *
+ * @return whether the reader is at pos
+ */
+bool reader_set_pos(reader_t *reader, const reader_pos_t *pos);
+
+/**
+ * @brief the number of threads that decompress a zstd trace that has
+ * multiple frames, e.g., a trace compressed in chunks or in the zstd seekable
+ * format, 0 decompresses in the reading thread, the default is 0
+ *
+ * each reader, including the clones made by the simulator, starts its own
+ * threads and buffers 2 * n_thread decompressed frames (up to 64 MiB each),
+ * use it when few readers decode a large trace
+ */
+void set_zstd_reader_n_thread(int n_thread);
+
 static inline void print_reader(reader_t *reader) {
   printf(
       "trace_type: %s, trace_path: %s, trace_start_offset: %d, mmap_offset: "
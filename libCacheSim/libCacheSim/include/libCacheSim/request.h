@@ -17,21 +17,10 @@
 extern "C" {
 #endif
 
-/* need to optimize this for CPU cacheline */
-typedef struct request {
-  int64_t clock_time; /* use uint64_t because vscsi uses microsec timestamp */
-  uint64_t hv;        /* hash value, used when offloading hash to reader */
-  obj_id_t obj_id;
-  int64_t obj_size;
-  int32_t ttl;
-  req_op_e op;
-
-  uint64_t n_req;
-  int64_t next_access_vtime;
-  /* carry necessary data between the multiple functions of serving one request
-   */
-  void *eviction_algo_data;
-
+/* the fields that only some traces have and the fields computed in trace
+ * analysis, the caches do not use them, a reader fills the trace fields only
+ * if the request has an info (see new_request_with_info) */
+typedef struct request_info {
   struct {
     uint64_t key_size : 16;
     uint64_t val_size : 48;
@@ -59,9 +48,24 @@ typedef struct request {
   bool overwrite;            // this request overwrites a previous object
   bool first_seen_in_window; /* the first time see in the time window */
   /* used in trace analysis */
+} request_info_t;
 
+/* the request passed to the caches, the fields read on every request are in
+ * the first 32 bytes and the struct is one cache line (64 bytes) */
+typedef struct request {
+  int64_t clock_time; /* use uint64_t because vscsi uses microsec timestamp */
+  obj_id_t obj_id;
+  int64_t obj_size;
+  int64_t next_access_vtime;
+
+  uint64_t hv; /* hash value, used when offloading hash to reader */
+  int32_t ttl;
+  req_op_e op;
   bool valid; /* indicate whether request is valid request
                * it is invlalid if the trace reaches the end */
+
+  /* NULL unless the request is created by new_request_with_info */
+  request_info_t *info;
 } request_t;
 
 /**
@@ -83,7 +87,19 @@ static inline request_t *new_request(void) {
 }
 
 /**
- * copy the req_src to req_dest
+ * allocate a new request_t struct with a request_info_t, the reader fills
+ * the fields of the info that the trace has
+ * @return
+ */
+static inline request_t *new_request_with_info(void) {
+  request_t *req = new_request();
+  req->info = my_malloc(request_info_t);
+  memset(req->info, 0, sizeof(request_info_t));
+  return req;
+}
+
+/**
+ * copy the req_src to req_dest, the info is shared, not copied
  * @param req_dest
  * @param req_src
  */
@@ -92,13 +108,17 @@ static inline void copy_request(request_t *req_dest, const request_t *req_src) {
 }
 
 /**
- * clone the given request
+ * clone the given request, including its info
  * @param req
  * @return
  */
 static inline request_t *clone_request(const request_t *req) {
   request_t *req_new = my_malloc(request_t);
   copy_request(req_new, req);
+  if (req->info != NULL) {
+    req_new->info = my_malloc(request_info_t);
+    memcpy(req_new->info, req->info, sizeof(request_info_t));
+  }
   return req_new;
 }
 
@@ -106,7 +126,12 @@ static inline request_t *clone_request(const request_t *req) {
  * free the memory used by req
  * @param req
  */
-static inline void free_request(request_t *req) { my_free(request_t, req); }
+static inline void free_request(request_t *req) {
+  if (req->info != NULL) {
+    my_free(sizeof(request_info_t), req->info);
+  }
+  my_free(request_t, req);
+}
 
 static inline void print_request(request_t *req) {
 #ifdef SUPPORT_TTL
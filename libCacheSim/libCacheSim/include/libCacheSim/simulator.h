@@ -15,6 +15,62 @@
 extern "C" {
 #endif
 
+/* how the simulation threads are placed on the cores */
+typedef enum {
+  /* the threads are scheduled by the OS */
+  SIM_THREAD_FLOAT,
+  /* each running simulation is pinned to its own core */
+  SIM_THREAD_PIN,
+  /* each running simulation is pinned to its own core, the simulations are
+   * spread over the NUMA nodes round-robin */
+  SIM_THREAD_NUMA,
+} sim_thread_placement_e;
+
+/**
+ * the options of a simulation run, a zero-initialized struct (or a NULL
+ * sim_params) is the default
+ */
+typedef struct {
+  /* the thread placement of simulate_at_multi_sizes,
+   * simulate_with_multi_caches and the workers of
+   * simulate_with_multi_caches_shared_decode, when pinned,
+   * simulate_at_multi_sizes creates each cache on the thread that runs it so
+   * that the cache memory is allocated on the thread's node (Linux
+   * first-touch policy), caches passed to simulate_with_multi_caches are
+   * created by the caller, but the objects are still allocated by the
+   * workers */
+  sim_thread_placement_e thread_placement;
+
+  /* record the requests, misses, bytes, evictions and throughput of every
+   * interval_sec seconds (trace time, after the warmup) of each simulation,
+   * the series of all caches of a run are written to interval_output_path
+   * when the run finishes, as CSV if the path ends with .csv, otherwise in a
+   * columnar binary format (see profiler/simSeries.h), interval_sec 0 or a
+   * NULL path turns it off */
+  int interval_sec;
+  const char *interval_output_path;
+
+  /* the file of the cost model used to order the simulations of
+   * simulate_at_multi_sizes and simulate_with_multi_caches, the simulations
+   * are started from the most expensive one so that the cheap ones fill the
+   * idle threads at the end of a sweep, the cost of each algorithm comes
+   * from the throughput measured in previous runs, which is updated in the
+   * file after each run, without a file (NULL) built-in estimates are used */
+  const char *cost_model_path;
+
+  /* split each simulation of simulate_at_multi_sizes and
+   * simulate_with_multi_caches into segments of checkpoint_n_req requests,
+   * the cache state (see cacheSnapshot.h), the reader position and the
+   * partial result are saved to a file in checkpoint_dir after each segment,
+   * a simulation that finds its file, e.g., the same sweep run again after a
+   * crash, resumes from it, the file is removed when the simulation
+   * finishes, only the algorithms that support snapshots are checkpointed,
+   * and not when the interval output is on, checkpoint_n_req 0 or a NULL
+   * dir turns it off */
+  int64_t checkpoint_n_req;
+  const char *checkpoint_dir;
+} sim_params_t;
+
 /**
  *
  * this function performs num_of_sizes simulations each at one cache size,
@@ -35,6 +91,7 @@ extern "C" {
  * @param warmup_reader
  * @param warmup_frac
  * @param num_of_threads
+ * @param sim_params the options of the run, NULL for the default
  * @return
  */
 cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
@@ -42,7 +99,8 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
                                       const uint64_t *cache_sizes,
                                       reader_t *warmup_reader,
                                       double warmup_frac, int warmup_sec,
-                                      int num_of_threads);
+                                      int num_of_threads,
+                                      const sim_params_t *sim_params);
 
 /**
  * this function performs cache_size/step_size simulations to obtain miss ratio,
@@ -61,13 +119,14 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
  * @param step_size
  * @param warmup_frac
  * @param num_of_threads
+ * @param sim_params the options of the run, NULL for the default
  * @return an array of cache_stat_t, each corresponds to one simulation
  */
 
 cache_stat_t *simulate_at_multi_sizes_with_step_size(
     reader_t *reader_in, const cache_t *cache_in, uint64_t step_size,
     reader_t *warmup_reader, double warmup_frac, int warmup_sec,
-    int num_of_threads);
+    int num_of_threads, const sim_params_t *sim_params);
 
 /**
  * this function performs num_of_caches simulations with the caches,
@@ -80,6 +139,7 @@ cache_stat_t *simulate_at_multi_sizes_with_step_size(
  * @param warmup_reader
  * @param warmup_frac
  * @param num_of_threads
+ * @param sim_params the options of the run, NULL for the default
  * @return
  */
 cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
@@ -87,7 +147,42 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
                                          reader_t *warmup_reader,
                                          double warmup_frac, int warmup_sec,
                                          int num_of_threads, 
-                                         bool free_cache_when_finish);
+                                         bool free_cache_when_finish,
+                                         const sim_params_t *sim_params);
+
+/**
+ * warm up warm_cache once with warmup_reader, warmup_frac or warmup_sec of
+ * the trace, then copy its state (objects, queues and the adaptive state)
+ * into each of caches and run them on the rest of the trace in parallel
+ *
+ * use it for a parameter sweep with a long warmup, the warmup is simulated
+ * once instead of once per cache, caches must be empty and of the same
+ * algorithm as warm_cache, which must support snapshots (see
+ * cacheSnapshot.h), their parameters and sizes may differ, warm_cache is not
+ * freed, the n_warmup_req of each result is the warmup of warm_cache
+ */
+cache_stat_t *simulate_forks_from_warmup(
+    reader_t *reader, cache_t *warm_cache, cache_t *caches[], int num_of_caches,
+    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+    int num_of_threads, bool free_cache_when_finish,
+    const sim_params_t *sim_params);
+
+/**
+ * the same as simulate_with_multi_caches, but the trace is decoded once by
+ * the calling thread and the decoded requests are shared by all caches,
+ * the caches are split over num_of_threads worker threads
+ *
+ * use it when decoding the trace is expensive (e.g., zstd compressed traces)
+ * compared to running the caches, the workers move at the pace of the
+ * slowest cache, the throughput in the interval output is the wall-clock
+ * rate of each cache, which includes the time its worker spends on the
+ * other caches
+ */
+cache_stat_t *simulate_with_multi_caches_shared_decode(
+    reader_t *reader, cache_t *caches[], int num_of_caches,
+    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+    int num_of_threads, bool free_cache_when_finish,
+    const sim_params_t *sim_params);
 
 #ifdef __cplusplus
 }
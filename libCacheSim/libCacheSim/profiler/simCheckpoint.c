@@ -0,0 +1,128 @@
+//
+//  simCheckpoint.c
+//  libCacheSim
+//
+
+#include "simCheckpoint.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/cacheSnapshot.h"
+#include "../include/libCacheSim/logging.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void sim_checkpoint_path(const char *dir, int idx, const cache_t *cache,
+                         char *path, size_t len) {
+  snprintf(path, len, "%s/%d_%s_%ld.ckpt", dir, idx, cache->cache_name,
+           (long)cache->cache_size);
+}
+
+/* the fields of the next request that a trace sets, the info is not kept */
+static bool _write_req(FILE *ofile, const request_t *req) {
+  return snapshot_write(ofile, &req->clock_time, sizeof(req->clock_time)) &&
+         snapshot_write(ofile, &req->obj_id, sizeof(req->obj_id)) &&
+         snapshot_write(ofile, &req->obj_size, sizeof(req->obj_size)) &&
+         snapshot_write(ofile, &req->next_access_vtime,
+                        sizeof(req->next_access_vtime)) &&
+         snapshot_write(ofile, &req->ttl, sizeof(req->ttl)) &&
+         snapshot_write(ofile, &req->op, sizeof(req->op)) &&
+         snapshot_write(ofile, &req->valid, sizeof(req->valid));
+}
+
+static bool _read_req(FILE *ifile, request_t *req) {
+  memset(req, 0, sizeof(request_t));
+  return snapshot_read(ifile, &req->clock_time, sizeof(req->clock_time)) &&
+         snapshot_read(ifile, &req->obj_id, sizeof(req->obj_id)) &&
+         snapshot_read(ifile, &req->obj_size, sizeof(req->obj_size)) &&
+         snapshot_read(ifile, &req->next_access_vtime,
+                       sizeof(req->next_access_vtime)) &&
+         snapshot_read(ifile, &req->ttl, sizeof(req->ttl)) &&
+         snapshot_read(ifile, &req->op, sizeof(req->op)) &&
+         snapshot_read(ifile, &req->valid, sizeof(req->valid));
+}
+
+bool sim_checkpoint_save(const char *path, const sim_checkpoint_t *ckpt,
+                         const cache_t *cache, const reader_t *reader) {
+  char tmp_path[SIM_CHECKPOINT_PATH_LEN + 8];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  FILE *ofile = fopen(tmp_path, "wb");
+  if (ofile == NULL) {
+    WARN("cannot open %s %s\n", tmp_path, strerror(errno));
+    return false;
+  }
+
+  uint32_t version = SIM_CHECKPOINT_VERSION;
+  reader_pos_t pos;
+  reader_get_pos(reader, &pos);
+  bool ok =
+      snapshot_write(ofile, SIM_CHECKPOINT_MAGIC,
+                     sizeof(SIM_CHECKPOINT_MAGIC)) &&
+      snapshot_write(ofile, &version, sizeof(version)) &&
+      snapshot_write(ofile, &ckpt->result, sizeof(cache_stat_t)) &&
+      snapshot_write(ofile, &ckpt->start_ts, sizeof(ckpt->start_ts)) &&
+      _write_req(ofile, &ckpt->next_req) &&
+      snapshot_write(ofile, &cache->n_evict, sizeof(cache->n_evict)) &&
+      snapshot_write(ofile, &ckpt->rand_seed, sizeof(ckpt->rand_seed)) &&
+      snapshot_write(ofile, &pos, sizeof(reader_pos_t)) &&
+      cache_snapshot_write(cache, ofile);
+
+  if (fclose(ofile) != 0) ok = false;
+  if (ok && rename(tmp_path, path) != 0) {
+    WARN("cannot rename %s to %s %s\n", tmp_path, path, strerror(errno));
+    ok = false;
+  }
+  if (!ok) {
+    WARN("fail to write checkpoint %s\n", path);
+    remove(tmp_path);
+  }
+  return ok;
+}
+
+bool sim_checkpoint_load(const char *path, sim_checkpoint_t *ckpt,
+                         cache_t *cache, reader_t *reader) {
+  FILE *ifile = fopen(path, "rb");
+  if (ifile == NULL) {
+    WARN("cannot open %s %s\n", path, strerror(errno));
+    return false;
+  }
+
+  char magic[sizeof(SIM_CHECKPOINT_MAGIC)];
+  uint32_t version;
+  if (!snapshot_read(ifile, magic, sizeof(magic)) ||
+      memcmp(magic, SIM_CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+      !snapshot_read(ifile, &version, sizeof(version))) {
+    WARN("%s is not a simulation checkpoint\n", path);
+    fclose(ifile);
+    return false;
+  }
+  if (version != SIM_CHECKPOINT_VERSION) {
+    WARN("%s has checkpoint version %u, expect %u\n", path, version,
+         SIM_CHECKPOINT_VERSION);
+    fclose(ifile);
+    return false;
+  }
+
+  reader_pos_t pos;
+  bool ok =
+      snapshot_read(ifile, &ckpt->result, sizeof(cache_stat_t)) &&
+      snapshot_read(ifile, &ckpt->start_ts, sizeof(ckpt->start_ts)) &&
+      _read_req(ifile, &ckpt->next_req) &&
+      snapshot_read(ifile, &cache->n_evict, sizeof(cache->n_evict)) &&
+      snapshot_read(ifile, &ckpt->rand_seed, sizeof(ckpt->rand_seed)) &&
+      snapshot_read(ifile, &pos, sizeof(reader_pos_t));
+  if (!ok) WARN("truncated checkpoint %s\n", path);
+  ok = ok && cache_snapshot_read(cache, ifile);
+  fclose(ifile);
+
+  return ok && reader_set_pos(reader, &pos);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,78 @@
+//
+//  the checkpoint of one simulation, taken every checkpoint_n_req requests
+//  (see sim_params_t) so that a long simulation that is killed resumes from
+//  its last checkpoint instead of starting over
+//
+//  the file is
+//    magic "LCSCKPT\0", version (uint32),
+//    the partial result (cache_stat_t), the time the requests are shifted
+//    by, the next request (read from the trace, not simulated yet), the
+//    n_evict of the cache, the next_rand state of the thread,
+//    the reader position after the next request,
+//    the cache state (see cache_snapshot_write)
+//  all integers are in the native byte order
+//
+//  simCheckpoint.h
+//  libCacheSim
+//
+
+#ifndef SIM_CHECKPOINT_H
+#define SIM_CHECKPOINT_H
+
+#include "../include/libCacheSim/cache.h"
+#include "../include/libCacheSim/reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_CHECKPOINT_MAGIC "LCSCKPT"
+#define SIM_CHECKPOINT_VERSION 1
+#define SIM_CHECKPOINT_PATH_LEN 1024
+
+/* the state of a simulation besides the cache and the reader */
+typedef struct {
+  cache_stat_t result;
+  /* the time of the first request of the trace, the requests are shifted
+   * by it */
+  int64_t start_ts;
+  /* the next request to simulate, its clock_time is not shifted */
+  request_t next_req;
+  uint64_t rand_seed;
+} sim_checkpoint_t;
+
+/**
+ * @brief the checkpoint file of simulation idx of a run in dir, the name has
+ * the index, the cache name and the cache size, so the simulations of a
+ * sweep do not share a file and the same sweep run again finds its files
+ */
+void sim_checkpoint_path(const char *dir, int idx, const cache_t *cache,
+                         char *path, size_t len);
+
+/**
+ * @brief write the checkpoint to a temporary file and rename it to path, so
+ * that a crash while writing keeps the previous checkpoint
+ *
+ * @param reader must be right after ckpt->next_req, i.e., the requests the
+ * reader has decoded ahead have been simulated
+ * @return whether the checkpoint is written, the cache must support
+ * snapshots
+ */
+bool sim_checkpoint_save(const char *path, const sim_checkpoint_t *ckpt,
+                         const cache_t *cache, const reader_t *reader);
+
+/**
+ * @brief restore a checkpoint into the empty cache and move reader to
+ * where the checkpoint was taken
+ *
+ * @return whether the checkpoint is restored, the cache should be freed if
+ * not
+ */
+bool sim_checkpoint_load(const char *path, sim_checkpoint_t *ckpt,
+                         cache_t *cache, reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_CHECKPOINT_H */
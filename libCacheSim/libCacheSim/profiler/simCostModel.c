@@ -0,0 +1,197 @@
+//
+//  simCostModel.c
+//  libCacheSim
+//
+
+#include "simCostModel.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_COST_MODEL_MAX_ALGO 256
+/* the weight of a new measurement */
+#define SIM_COST_MODEL_ALPHA 0.5
+/* the MQPS of an algorithm that is neither measured nor in the priors */
+#define SIM_COST_MODEL_DEFAULT_MQPS 4.0
+
+typedef struct {
+  char algo[CACHE_NAME_ARRAY_LEN];
+  double mqps;
+  /* whether mqps comes from a run (this one or a previous one) */
+  bool measured;
+} sim_cost_entry_t;
+
+struct sim_cost_model {
+  char *path;
+  int n_entry;
+  sim_cost_entry_t entries[SIM_COST_MODEL_MAX_ALGO];
+};
+
+/* rough single-thread throughput used before an algorithm is measured,
+ * only the order of magnitude matters */
+static const struct {
+  const char *algo;
+  double mqps;
+} priors[] = {
+    {"FIFO", 10},       {"Clock", 10},         {"Sieve", 9},
+    {"LRU", 8},         {"S3FIFO", 8},         {"QDLP", 8},
+    {"TwoQ", 6},        {"SLRU", 6},           {"ARC", 4},
+    {"LFU", 4},         {"LIRS", 3},           {"LeCaR", 2},
+    {"Cacheus", 1.5},   {"AdaptiveClimb", 1},  {"DynamicAdaptiveClimb", 1},
+    {"GLCache", 0.5},   {"Belady", 0.5},       {"LRB", 0.05},
+};
+
+/* the algorithm is the cache name up to the first '-', the rest are the
+ * parameters, e.g., S3FIFO-0.1000-2 */
+static void _algo_of(const char *cache_name, char *algo) {
+  size_t len = strcspn(cache_name, "-");
+  if (len >= CACHE_NAME_ARRAY_LEN) len = CACHE_NAME_ARRAY_LEN - 1;
+  memcpy(algo, cache_name, len);
+  algo[len] = '\0';
+}
+
+static sim_cost_entry_t *_find_entry(const sim_cost_model_t *model,
+                                     const char *algo) {
+  for (int i = 0; i < model->n_entry; i++) {
+    if (strcasecmp(model->entries[i].algo, algo) == 0) {
+      return (sim_cost_entry_t *)&model->entries[i];
+    }
+  }
+  return NULL;
+}
+
+static sim_cost_entry_t *_add_entry(sim_cost_model_t *model, const char *algo,
+                                    double mqps, bool measured) {
+  if (model->n_entry >= SIM_COST_MODEL_MAX_ALGO) return NULL;
+  sim_cost_entry_t *entry = &model->entries[model->n_entry++];
+  strncpy(entry->algo, algo, CACHE_NAME_ARRAY_LEN - 1);
+  entry->algo[CACHE_NAME_ARRAY_LEN - 1] = '\0';
+  entry->mqps = mqps;
+  entry->measured = measured;
+  return entry;
+}
+
+sim_cost_model_t *sim_cost_model_load(const char *path) {
+  sim_cost_model_t *model = calloc(1, sizeof(sim_cost_model_t));
+  for (size_t i = 0; i < sizeof(priors) / sizeof(priors[0]); i++) {
+    _add_entry(model, priors[i].algo, priors[i].mqps, false);
+  }
+  if (path == NULL) return model;
+
+  model->path = strdup(path);
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    if (errno != ENOENT) {
+      WARN("cannot open cost model %s %s\n", path, strerror(errno));
+    }
+    return model;
+  }
+
+  /* the width in fscanf must stay below CACHE_NAME_ARRAY_LEN */
+  char algo[CACHE_NAME_ARRAY_LEN];
+  double mqps;
+  while (fscanf(file, "%63s %lf", algo, &mqps) == 2) {
+    if (mqps <= 0) continue;
+    sim_cost_entry_t *entry = _find_entry(model, algo);
+    if (entry == NULL) {
+      _add_entry(model, algo, mqps, true);
+    } else {
+      entry->mqps = mqps;
+      entry->measured = true;
+    }
+  }
+  fclose(file);
+
+  return model;
+}
+
+void sim_cost_model_free(sim_cost_model_t *model) {
+  free(model->path);
+  free(model);
+}
+
+double sim_cost_model_estimate(const sim_cost_model_t *model,
+                               const cache_t *cache) {
+  char algo[CACHE_NAME_ARRAY_LEN];
+  _algo_of(cache->cache_name, algo);
+  const sim_cost_entry_t *entry = _find_entry(model, algo);
+  return 1.0 / (entry == NULL ? SIM_COST_MODEL_DEFAULT_MQPS : entry->mqps);
+}
+
+void sim_cost_model_update(sim_cost_model_t *model, const char *cache_name,
+                           double mqps) {
+  if (mqps <= 0) return;
+
+  char algo[CACHE_NAME_ARRAY_LEN];
+  _algo_of(cache_name, algo);
+  sim_cost_entry_t *entry = _find_entry(model, algo);
+  if (entry == NULL) {
+    _add_entry(model, algo, mqps, true);
+  } else if (!entry->measured) {
+    /* the prior is discarded at the first measurement */
+    entry->mqps = mqps;
+    entry->measured = true;
+  } else {
+    entry->mqps =
+        SIM_COST_MODEL_ALPHA * mqps + (1 - SIM_COST_MODEL_ALPHA) * entry->mqps;
+  }
+}
+
+void sim_cost_model_save(const sim_cost_model_t *model) {
+  if (model->path == NULL) return;
+
+  FILE *file = fopen(model->path, "w");
+  if (file == NULL) {
+    WARN("cannot write cost model %s %s\n", model->path, strerror(errno));
+    return;
+  }
+  for (int i = 0; i < model->n_entry; i++) {
+    if (!model->entries[i].measured) continue;
+    fprintf(file, "%s %.4lf\n", model->entries[i].algo,
+            model->entries[i].mqps);
+  }
+  fclose(file);
+}
+
+typedef struct {
+  double cost;
+  uint64_t cache_size;
+  int idx;
+} sim_cost_order_t;
+
+static int _cmp_cost_order(const void *a, const void *b) {
+  const sim_cost_order_t *x = a, *y = b;
+  if (x->cost != y->cost) return x->cost > y->cost ? -1 : 1;
+  if (x->cache_size != y->cache_size)
+    return x->cache_size > y->cache_size ? -1 : 1;
+  return x->idx - y->idx;
+}
+
+void sim_cost_model_order(const sim_cost_model_t *model,
+                          const cache_t *const *caches,
+                          const uint64_t *cache_sizes, int n_caches,
+                          int *order) {
+  sim_cost_order_t *costs = malloc(sizeof(sim_cost_order_t) * n_caches);
+  for (int i = 0; i < n_caches; i++) {
+    costs[i].cost = sim_cost_model_estimate(model, caches[i]);
+    costs[i].cache_size = cache_sizes[i];
+    costs[i].idx = i;
+  }
+  qsort(costs, n_caches, sizeof(sim_cost_order_t), _cmp_cost_order);
+  for (int i = 0; i < n_caches; i++) {
+    order[i] = costs[i].idx;
+  }
+  free(costs);
+}
+
+#ifdef __cplusplus
+}
+#endif
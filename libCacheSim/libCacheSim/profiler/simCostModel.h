@@ -0,0 +1,67 @@
+//
+//  a per-algorithm throughput model used to schedule the simulations of a
+//  sweep, the most expensive caches are started first so that the cheap
+//  ones fill the idle threads at the end
+//
+//  the throughput (MQPS) of each algorithm is learned from previous runs
+//  and kept in a text file, one "algorithm MQPS" per line, algorithms not in
+//  the file use a built-in prior
+//
+//  simCostModel.h
+//  libCacheSim
+//
+
+#ifndef SIM_COST_MODEL_H
+#define SIM_COST_MODEL_H
+
+#include "../include/libCacheSim/cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct sim_cost_model sim_cost_model_t;
+
+/**
+ * @brief load the model from path, a missing file gives the priors
+ *
+ * @param path the model file, NULL to use the priors only
+ */
+sim_cost_model_t *sim_cost_model_load(const char *path);
+
+void sim_cost_model_free(sim_cost_model_t *model);
+
+/**
+ * @brief the estimated cost of simulating cache, only the order matters
+ */
+double sim_cost_model_estimate(const sim_cost_model_t *model,
+                               const cache_t *cache);
+
+/**
+ * @brief record the throughput measured for a cache, the estimate of its
+ * algorithm moves towards the measurement
+ */
+void sim_cost_model_update(sim_cost_model_t *model, const char *cache_name,
+                           double mqps);
+
+/**
+ * @brief write the measured algorithms back to the file it was loaded from
+ */
+void sim_cost_model_save(const sim_cost_model_t *model);
+
+/**
+ * @brief fill order with the indexes of caches, the most expensive first,
+ * caches of the same cost are ordered by decreasing size
+ *
+ * @param cache_sizes the size each cache is simulated at
+ */
+void sim_cost_model_order(const sim_cost_model_t *model,
+                          const cache_t *const *caches,
+                          const uint64_t *cache_sizes, int n_caches,
+                          int *order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_COST_MODEL_H */
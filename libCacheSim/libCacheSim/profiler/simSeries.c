@@ -0,0 +1,146 @@
+//
+//  simSeries.c
+//  libCacheSim
+//
+
+#include "simSeries.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "../include/libCacheSim/logging.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_SERIES_INIT_CAPACITY 64
+
+void sim_series_init(sim_series_t *series) {
+  memset(series, 0, sizeof(sim_series_t));
+}
+
+void sim_series_free(sim_series_t *series) {
+  free(series->end_ts);
+  free(series->n_req);
+  free(series->n_miss);
+  free(series->n_req_byte);
+  free(series->n_miss_byte);
+  free(series->n_evict);
+  free(series->mqps);
+  memset(series, 0, sizeof(sim_series_t));
+}
+
+static void _sim_series_grow(sim_series_t *series) {
+  int64_t capacity = series->capacity == 0 ? SIM_SERIES_INIT_CAPACITY
+                                           : series->capacity * 2;
+  series->end_ts = realloc(series->end_ts, sizeof(int64_t) * capacity);
+  series->n_req = realloc(series->n_req, sizeof(int64_t) * capacity);
+  series->n_miss = realloc(series->n_miss, sizeof(int64_t) * capacity);
+  series->n_req_byte = realloc(series->n_req_byte, sizeof(int64_t) * capacity);
+  series->n_miss_byte =
+      realloc(series->n_miss_byte, sizeof(int64_t) * capacity);
+  series->n_evict = realloc(series->n_evict, sizeof(int64_t) * capacity);
+  series->mqps = realloc(series->mqps, sizeof(double) * capacity);
+  if (series->end_ts == NULL || series->n_req == NULL ||
+      series->n_miss == NULL || series->n_req_byte == NULL ||
+      series->n_miss_byte == NULL || series->n_evict == NULL ||
+      series->mqps == NULL) {
+    ERROR("cannot allocate the interval series %s\n", strerror(errno));
+  }
+  series->capacity = capacity;
+}
+
+void sim_series_append(sim_series_t *series, int64_t end_ts, int64_t n_req,
+                       int64_t n_miss, int64_t n_req_byte, int64_t n_miss_byte,
+                       int64_t n_evict, double mqps) {
+  if (series->n_interval == series->capacity) _sim_series_grow(series);
+
+  int64_t i = series->n_interval++;
+  series->end_ts[i] = end_ts;
+  series->n_req[i] = n_req;
+  series->n_miss[i] = n_miss;
+  series->n_req_byte[i] = n_req_byte;
+  series->n_miss_byte[i] = n_miss_byte;
+  series->n_evict[i] = n_evict;
+  series->mqps[i] = mqps;
+}
+
+static bool _sim_series_write_csv(FILE *ofile, const sim_series_t *series,
+                                  int n_series) {
+  fprintf(ofile,
+          "cache_name,cache_size,end_ts,n_req,n_miss,n_req_byte,n_miss_byte,"
+          "n_evict,miss_ratio,byte_miss_ratio,mqps\n");
+  for (int s = 0; s < n_series; s++) {
+    const sim_series_t *ser = &series[s];
+    for (int64_t i = 0; i < ser->n_interval; i++) {
+      fprintf(ofile,
+              "%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%.6lf,%.6lf,%.4lf\n",
+              ser->cache_name, (long)ser->cache_size, (long)ser->end_ts[i],
+              (long)ser->n_req[i], (long)ser->n_miss[i],
+              (long)ser->n_req_byte[i], (long)ser->n_miss_byte[i],
+              (long)ser->n_evict[i],
+              (double)ser->n_miss[i] / (double)ser->n_req[i],
+              ser->n_req_byte[i] == 0
+                  ? 0
+                  : (double)ser->n_miss_byte[i] / (double)ser->n_req_byte[i],
+              ser->mqps[i]);
+    }
+  }
+  return !ferror(ofile);
+}
+
+static bool _sim_series_write_bin(FILE *ofile, const sim_series_t *series,
+                                  int n_series) {
+  uint32_t version = SIM_SERIES_VERSION;
+  uint32_t n = (uint32_t)n_series;
+  bool ok = fwrite(SIM_SERIES_MAGIC, sizeof(SIM_SERIES_MAGIC), 1, ofile) == 1 &&
+            fwrite(&version, sizeof(version), 1, ofile) == 1 &&
+            fwrite(&n, sizeof(n), 1, ofile) == 1;
+
+  for (int s = 0; s < n_series && ok; s++) {
+    const sim_series_t *ser = &series[s];
+    size_t n_int = (size_t)ser->n_interval;
+    const int64_t *columns[] = {ser->end_ts,     ser->n_req,
+                                ser->n_miss,     ser->n_req_byte,
+                                ser->n_miss_byte, ser->n_evict};
+    ok = fwrite(ser->cache_name, CACHE_NAME_ARRAY_LEN, 1, ofile) == 1 &&
+         fwrite(&ser->cache_size, sizeof(int64_t), 1, ofile) == 1 &&
+         fwrite(&ser->n_interval, sizeof(int64_t), 1, ofile) == 1;
+    if (n_int == 0) continue;
+    for (size_t c = 0; c < sizeof(columns) / sizeof(columns[0]) && ok; c++) {
+      ok = fwrite(columns[c], sizeof(int64_t), n_int, ofile) == n_int;
+    }
+    ok = ok && fwrite(ser->mqps, sizeof(double), n_int, ofile) == n_int;
+  }
+  return ok;
+}
+
+bool sim_series_write(const char *path, const sim_series_t *series,
+                      int n_series) {
+  size_t len = strlen(path);
+  bool is_csv = len >= 4 && strcasecmp(path + len - 4, ".csv") == 0;
+
+  FILE *ofile = fopen(path, is_csv ? "w" : "wb");
+  if (ofile == NULL) {
+    ERROR("cannot open %s %s\n", path, strerror(errno));
+    return false;
+  }
+
+  bool ok = is_csv ? _sim_series_write_csv(ofile, series, n_series)
+                   : _sim_series_write_bin(ofile, series, n_series);
+  if (fclose(ofile) != 0) ok = false;
+  if (!ok) {
+    WARN("fail to write the interval series %s\n", path);
+  } else {
+    INFO("write the interval series of %d caches to %s\n", n_series, path);
+  }
+  return ok;
+}
+
+#ifdef __cplusplus
+}
+#endif
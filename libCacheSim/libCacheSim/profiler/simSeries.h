@@ -0,0 +1,72 @@
+//
+//  the per-interval counters of a simulation, kept in columns (one array
+//  per counter) so that a sweep of many caches records its time series in
+//  a compact buffer and writes them to one file at the end
+//
+//  the binary file is
+//    magic "LCSSERS\0", version (uint32), number of caches (uint32),
+//    then for each cache:
+//      cache name (char[CACHE_NAME_ARRAY_LEN]), cache size, n_interval,
+//      the columns end_ts, n_req, n_miss, n_req_byte, n_miss_byte, n_evict
+//      (int64_t[n_interval] each) and mqps (double[n_interval])
+//  all integers are in the native byte order
+//
+//  simSeries.h
+//  libCacheSim
+//
+
+#ifndef SIM_SERIES_H
+#define SIM_SERIES_H
+
+#include "../include/libCacheSim/cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_SERIES_MAGIC "LCSSERS"
+#define SIM_SERIES_VERSION 1
+
+typedef struct {
+  char cache_name[CACHE_NAME_ARRAY_LEN];
+  int64_t cache_size;
+  int64_t n_interval;
+  int64_t capacity;
+
+  /* element i of each column is interval i, end_ts is the (shifted) trace
+   * time the interval ends at, intervals without requests are skipped */
+  int64_t *end_ts;
+  int64_t *n_req;
+  int64_t *n_miss;
+  int64_t *n_req_byte;
+  int64_t *n_miss_byte;
+  int64_t *n_evict;
+  double *mqps;
+} sim_series_t;
+
+void sim_series_init(sim_series_t *series);
+
+void sim_series_free(sim_series_t *series);
+
+/**
+ * @brief append one interval, the counters are of the interval, not
+ * cumulative
+ */
+void sim_series_append(sim_series_t *series, int64_t end_ts, int64_t n_req,
+                       int64_t n_miss, int64_t n_req_byte, int64_t n_miss_byte,
+                       int64_t n_evict, double mqps);
+
+/**
+ * @brief write the series of n_series caches to path, as CSV (one row per
+ * cache and interval) if path ends with .csv, otherwise in the binary format
+ *
+ * @return whether the file is written
+ */
+bool sim_series_write(const char *path, const sim_series_t *series,
+                      int n_series);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_SERIES_H */
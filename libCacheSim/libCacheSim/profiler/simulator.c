@@ -13,57 +13,386 @@ extern "C" {
 #include "../include/libCacheSim/simulator.h"
 
 #include <math.h>
+#include <unistd.h>
 
 #include "../cache/cacheUtils.h"
+#include "../dataStructure/hash/hash.h"
+#include "../include/libCacheSim/cacheSnapshot.h"
 #include "../include/libCacheSim/evictionAlgo.h"
 #include "../include/libCacheSim/plugin.h"
 #include "../utils/include/myprint.h"
 #include "../utils/include/mystr.h"
+#include "../utils/include/mysys.h"
+#include "simCheckpoint.h"
+#include "simCostModel.h"
+#include "simSeries.h"
+
+/* the number of requests passed to cache->get_batch at a time */
+#define SIM_BATCH_SIZE 64
+/* the number of requests decoded by read_n_req at a time, the batch
+ * (32 bytes per request) fits in the L1 cache */
+#define SIM_DECODE_BATCH_SIZE 512
+/* the minimal time between two progress reports */
+#define SIM_PROGRESS_INTERVAL_SEC 30
 
 typedef struct simulator_multithreading_params {
   reader_t *reader;
   ssize_t n_caches;
+  /* a NULL cache is created by the worker from cache_template, so that its
+   * memory is first touched on the worker's NUMA node */
   cache_t **caches;
+  const cache_t *cache_template;
   uint64_t n_warmup_req; /* num of requests used for warming up cache */
   reader_t *warmup_reader;
   int warmup_sec; /* num of seconds of requests used for warming up cache */
   cache_stat_t *result;
   GMutex mtx; /* prevent simultaneous write to progress */
+  GCond finish_cond; /* signaled each time a simulation finishes */
   gint *progress;
+  /* when each simulation started (g_get_monotonic_time), 0 if not started */
+  gint64 *start_time;
+  /* the number of requests each simulation has processed, updated once per
+   * batch with atomic stores so that the progress report can read it */
+  int64_t *n_req_done;
+  /* the measured throughput of each simulation, used by the cost model */
+  double *mqps;
+  /* when the workers are pinned, a running simulation holds one slot and
+   * its thread runs on slot_core[slot], n_slot is 0 when not pinned */
+  int n_slot;
+  int *slot_core;
+  bool *slot_busy;
+  /* the forked simulations restore warm_state instead of warming up, and
+   * continue the trace from warm_pos with warm_next_req, which is the first
+   * request after the warmup, warm_state is NULL when not forked */
+  const char *warm_state;
+  size_t warm_state_size;
+  const char *warm_cache_name;
+  reader_pos_t warm_pos;
+  request_t *warm_next_req;
+  int64_t warm_start_ts;
+  int64_t warm_n_warmup_req;
+  /* the per-interval counters of each simulation, NULL when the interval
+   * output is off */
+  sim_series_t *series;
+  sim_params_t sim_params;
   gpointer other_data;
   bool free_cache_when_finish;
 } sim_mt_params_t;
 
-static void _simulate(gpointer data, gpointer user_data) {
-  sim_mt_params_t *params = (sim_mt_params_t *)user_data;
-  int idx = GPOINTER_TO_UINT(data) - 1;
-  set_rand_seed(0);
+static void _sim_progress_init(sim_mt_params_t *params, int n_caches) {
+  g_mutex_init(&(params->mtx));
+  g_cond_init(&(params->finish_cond));
+  params->start_time = my_malloc_n(gint64, n_caches);
+  memset(params->start_time, 0, sizeof(gint64) * n_caches);
+  params->n_req_done = my_malloc_n(int64_t, n_caches);
+  memset(params->n_req_done, 0, sizeof(int64_t) * n_caches);
+  params->mqps = my_malloc_n(double, n_caches);
+  memset(params->mqps, 0, sizeof(double) * n_caches);
+}
 
-  cache_stat_t *result = params->result;
-  reader_t *cloned_reader = clone_reader(params->reader);
-  request_t *req = new_request();
-  cache_t *local_cache = params->caches[idx];
-  strncpy(result[idx].cache_name, local_cache->cache_name,
-          CACHE_NAME_ARRAY_LEN);
+/* assign a core to each of the n_slot workers, PIN uses the cores in order,
+ * NUMA spreads the workers over the nodes round-robin so that every node
+ * gets the same share of the memory traffic, NULL when not pinned */
+static int *_sim_slot_cores(sim_thread_placement_e placement, int n_slot) {
+  if (placement == SIM_THREAD_FLOAT) return NULL;
+
+  /* the node ids may not be contiguous, e.g., 0 and 2 */
+  int n_node = get_n_numa_nodes();
+  int *node_ids = my_malloc_n(int, n_node);
+  n_node = get_numa_nodes(node_ids, n_node);
+  if (placement == SIM_THREAD_PIN) n_node = 1;
+  int max_n_core = get_n_cores();
+  int *node_cores = my_malloc_n(int, max_n_core * n_node);
+  int *n_node_core = my_malloc_n(int, n_node);
+  for (int node = 0; node < n_node; node++) {
+    n_node_core[node] = get_numa_node_cores(
+        node_ids[node], node_cores + node * max_n_core, max_n_core);
+  }
+
+  /* the nodes without allowed cores, e.g., memory-only nodes, are skipped */
+  int n_node_with_core = 0;
+  for (int node = 0; node < n_node; node++) {
+    n_node_with_core += n_node_core[node] > 0;
+  }
+  int *slot_core = NULL;
+  if (n_node_with_core == 0) {
+    WARN("no core to pin the simulation threads to, they are not pinned\n");
+  } else {
+    /* the next core to use on each node */
+    int *node_next_core = my_malloc_n(int, n_node);
+    memset(node_next_core, 0, sizeof(int) * n_node);
+    slot_core = my_malloc_n(int, n_slot);
+    int node = 0;
+    for (int i = 0; i < n_slot; i++) {
+      while (n_node_core[node] == 0) node = (node + 1) % n_node;
+      int core_idx = node_next_core[node]++ % n_node_core[node];
+      slot_core[i] = node_cores[node * max_n_core + core_idx];
+      node = (node + 1) % n_node;
+    }
+    INFO("pin %d simulation threads over %d NUMA nodes\n", n_slot,
+         n_node_with_core);
+    my_free(sizeof(int) * n_node, node_next_core);
+  }
+
+  my_free(sizeof(int) * max_n_core * n_node, node_cores);
+  my_free(sizeof(int) * n_node, n_node_core);
+  my_free(sizeof(int) * n_node, node_ids);
+  return slot_core;
+}
+
+static void _sim_placement_init(sim_mt_params_t *params, int n_slot) {
+  params->slot_core =
+      _sim_slot_cores(params->sim_params.thread_placement, n_slot);
+  params->n_slot = params->slot_core == NULL ? 0 : n_slot;
+  if (params->n_slot == 0) return;
+
+  params->slot_busy = my_malloc_n(bool, n_slot);
+  memset(params->slot_busy, 0, sizeof(bool) * n_slot);
+}
+
+static void _sim_placement_free(sim_mt_params_t *params) {
+  if (params->n_slot == 0) return;
+  my_free(sizeof(int) * params->n_slot, params->slot_core);
+  my_free(sizeof(bool) * params->n_slot, params->slot_busy);
+}
+
+/* pin the calling worker to a free slot, return the slot or -1 */
+static int _sim_pin_worker(sim_mt_params_t *params) {
+  if (params->n_slot == 0) return -1;
+
+  int slot = -1;
+  g_mutex_lock(&(params->mtx));
+  for (int i = 0; i < params->n_slot; i++) {
+    if (!params->slot_busy[i]) {
+      params->slot_busy[i] = true;
+      slot = i;
+      break;
+    }
+  }
+  g_mutex_unlock(&(params->mtx));
+
+  if (slot >= 0) {
+    set_thread_affinity_to_core(pthread_self(), params->slot_core[slot]);
+  }
+  return slot;
+}
+
+/* the thread goes back to the pool, which may be shared with unpinned
+ * simulations, so it is unpinned */
+static void _sim_unpin_worker(sim_mt_params_t *params, int slot) {
+  if (slot < 0) return;
+  reset_thread_affinity(pthread_self());
+  g_mutex_lock(&(params->mtx));
+  params->slot_busy[slot] = false;
+  g_mutex_unlock(&(params->mtx));
+}
+
+static void _sim_progress_free(sim_mt_params_t *params, int n_caches) {
+  my_free(sizeof(gint64) * n_caches, params->start_time);
+  my_free(sizeof(int64_t) * n_caches, params->n_req_done);
+  my_free(sizeof(double) * n_caches, params->mqps);
+  g_cond_clear(&(params->finish_cond));
+  g_mutex_clear(&(params->mtx));
+}
+
+/* report the number of finished simulations, and the progress and the
+ * estimated time left of each running one, the ETA needs the number of
+ * requests in the trace, which is only known upfront for binary traces,
+ * called with params->mtx held */
+static void _sim_report_progress(sim_mt_params_t *params, int n_caches) {
+  int64_t n_total_req = (int64_t)params->reader->n_total_req;
+  gint64 now = g_get_monotonic_time();
+
+  INFO("%d/%d simulations finished\n", *(params->progress), n_caches);
+  for (int i = 0; i < n_caches; i++) {
+    int64_t n_done = __atomic_load_n(&params->n_req_done[i], __ATOMIC_RELAXED);
+    if (params->start_time[i] == 0 || n_done < 0) continue;
+
+    double elapsed_sec = (double)(now - params->start_time[i]) / G_USEC_PER_SEC;
+    if (n_total_req > 0 && n_done > 0) {
+      double frac = MIN((double)n_done / (double)n_total_req, 1.0);
+      INFO("    %s size %" PRIu64 ": %.2lf%%, %.0lf sec elapsed, ETA %.0lf sec\n",
+           params->result[i].cache_name, params->result[i].cache_size,
+           frac * 100, elapsed_sec, elapsed_sec / frac * (1 - frac));
+    } else {
+      INFO("    %s size %" PRIu64 ": %ld requests, %.0lf sec elapsed\n",
+           params->result[i].cache_name, params->result[i].cache_size,
+           (long)n_done, elapsed_sec);
+    }
+  }
+}
+
+/* the options of a run, the interval output and the checkpoints are off
+ * unless both the interval (the segment length) and the path are given */
+static sim_params_t _sim_params(const sim_params_t *sim_params) {
+  sim_params_t p;
+  memset(&p, 0, sizeof(sim_params_t));
+  if (sim_params != NULL) p = *sim_params;
+  if (p.interval_sec <= 0 || p.interval_output_path == NULL) {
+    p.interval_sec = 0;
+    p.interval_output_path = NULL;
+  }
+  if (p.checkpoint_n_req <= 0 || p.checkpoint_dir == NULL) {
+    p.checkpoint_n_req = 0;
+    p.checkpoint_dir = NULL;
+  }
+  return p;
+}
+
+/* the series of n_caches simulations, NULL when the interval output is off */
+static sim_series_t *_sim_series_new(const sim_params_t *sim_params,
+                                     int n_caches) {
+  if (sim_params->interval_sec <= 0) return NULL;
+
+  sim_series_t *series = my_malloc_n(sim_series_t, n_caches);
+  for (int i = 0; i < n_caches; i++) {
+    sim_series_init(&series[i]);
+  }
+  return series;
+}
+
+/* write the series of all simulations to one file and free them */
+static void _sim_series_finish(sim_series_t *series,
+                               const sim_params_t *sim_params,
+                               const cache_stat_t *result, int n_caches) {
+  if (series == NULL) return;
+
+  for (int i = 0; i < n_caches; i++) {
+    strncpy(series[i].cache_name, result[i].cache_name, CACHE_NAME_ARRAY_LEN);
+    series[i].cache_size = result[i].cache_size;
+  }
+  sim_series_write(sim_params->interval_output_path, series, n_caches);
+  for (int i = 0; i < n_caches; i++) {
+    sim_series_free(&series[i]);
+  }
+  my_free(sizeof(sim_series_t) * n_caches, series);
+}
+
+/* the interval a simulation is in, the counters are cumulative at the start
+ * of the interval */
+typedef struct {
+  sim_series_t *series;
+  /* the length of the intervals in trace seconds */
+  int64_t interval_sec;
+  /* the (shifted) trace time the interval ends at, INT64_MAX when off */
+  int64_t end_ts;
+  int64_t n_req;
+  int64_t n_miss;
+  int64_t n_req_byte;
+  int64_t n_miss_byte;
+  int64_t n_evict;
+  gint64 start_time;
+} sim_interval_t;
+
+/* start the interval that contains trace time ts */
+static void _sim_interval_start(sim_interval_t *interval,
+                                const cache_stat_t *result,
+                                const cache_t *cache, int64_t ts) {
+  interval->end_ts =
+      (ts / interval->interval_sec + 1) * interval->interval_sec;
+  interval->n_req = result->n_req;
+  interval->n_miss = result->n_miss;
+  interval->n_req_byte = result->n_req_byte;
+  interval->n_miss_byte = result->n_miss_byte;
+  interval->n_evict = cache->n_evict;
+  interval->start_time = g_get_monotonic_time();
+}
+
+static void _sim_interval_close(sim_interval_t *interval,
+                                const cache_stat_t *result,
+                                const cache_t *cache) {
+  int64_t n_req = result->n_req - interval->n_req;
+  if (n_req == 0) return;
+
+  gint64 elapsed_us =
+      MAX(g_get_monotonic_time() - interval->start_time, (gint64)1);
+  sim_series_append(interval->series, interval->end_ts, n_req,
+                    result->n_miss - interval->n_miss,
+                    result->n_req_byte - interval->n_req_byte,
+                    result->n_miss_byte - interval->n_miss_byte,
+                    cache->n_evict - interval->n_evict,
+                    (double)n_req / elapsed_us);
+}
+
+/* push the simulations to the pool, the most expensive first, an idle
+ * thread takes the next one from the queue, so the cheap simulations at the
+ * end fill the threads that finish early */
+static void _sim_push_by_cost(GThreadPool *gthread_pool,
+                              sim_mt_params_t *params, int n_caches,
+                              const sim_cost_model_t *cost_model) {
+  const cache_t **caches = my_malloc_n(const cache_t *, n_caches);
+  uint64_t *cache_sizes = my_malloc_n(uint64_t, n_caches);
+  for (int i = 0; i < n_caches; i++) {
+    caches[i] = params->caches[i] != NULL ? params->caches[i]
+                                          : params->cache_template;
+    cache_sizes[i] = params->result[i].cache_size;
+  }
+  int *order = my_malloc_n(int, n_caches);
+  sim_cost_model_order(cost_model, caches, cache_sizes, n_caches, order);
+  my_free(sizeof(const cache_t *) * n_caches, caches);
+  my_free(sizeof(uint64_t) * n_caches, cache_sizes);
+  for (int i = 0; i < n_caches; i++) {
+    ASSERT_TRUE(
+        g_thread_pool_push(gthread_pool, GSIZE_TO_POINTER(order[i] + 1), NULL),
+        "cannot push data into thread_pool in get_miss_ratio\n");
+  }
+  my_free(sizeof(int) * n_caches, order);
+}
+
+/* update the cost model with the throughput of this run and save it */
+static void _sim_learn_cost(sim_mt_params_t *params, int n_caches,
+                            sim_cost_model_t *cost_model) {
+  for (int i = 0; i < n_caches; i++) {
+    sim_cost_model_update(cost_model, params->result[i].cache_name,
+                          params->mqps[i]);
+  }
+  sim_cost_model_save(cost_model);
+}
+
+/* block until all simulations finish, the workers signal finish_cond so
+ * this thread does not use a core, progress is reported at most every
+ * SIM_PROGRESS_INTERVAL_SEC */
+static void _sim_wait_for_finish(sim_mt_params_t *params, int n_caches) {
+  gint64 next_report =
+      g_get_monotonic_time() + SIM_PROGRESS_INTERVAL_SEC * G_TIME_SPAN_SECOND;
+
+  g_mutex_lock(&(params->mtx));
+  while (*(params->progress) < n_caches) {
+    if (!g_cond_wait_until(&(params->finish_cond), &(params->mtx),
+                           next_report)) {
+      /* timed out */
+      _sim_report_progress(params, n_caches);
+      next_report =
+          g_get_monotonic_time() + SIM_PROGRESS_INTERVAL_SEC * G_TIME_SPAN_SECOND;
+    }
+  }
+  g_mutex_unlock(&(params->mtx));
+}
 
+/* warm up cache with warmup_reader, then with warmup_frac or warmup_sec of
+ * requests from reader, req is left at the first request after the warmup,
+ * returns the time of the first request of reader, all requests from reader
+ * are shifted by it, n_req_done is updated when not NULL */
+static int64_t _sim_warmup(const sim_mt_params_t *params, cache_t *cache,
+                           reader_t *reader, request_t *req,
+                           int64_t *n_warmup_req, int64_t *n_req_done) {
   /* warm up using warmup_reader */
   if (params->warmup_reader) {
     reader_t *warmup_cloned_reader = clone_reader(params->warmup_reader);
     read_one_req(warmup_cloned_reader, req);
     while (req->valid) {
-      local_cache->get(local_cache, req);
-      result[idx].n_warmup_req += 1;
+      cache->get(cache, req);
+      *n_warmup_req += 1;
       read_one_req(warmup_cloned_reader, req);
     }
     close_reader(warmup_cloned_reader);
     INFO("cache %s (size %" PRIu64
          ") finishes warm up using warmup reader "
-         "with %" PRIu64 " requests\n",
-         local_cache->cache_name, local_cache->cache_size,
-         result[idx].n_warmup_req);
+         "with %" PRId64 " requests\n",
+         cache->cache_name, cache->cache_size, *n_warmup_req);
   }
 
-  read_one_req(cloned_reader, req);
+  read_one_req(reader, req);
   int64_t start_ts = (int64_t)req->clock_time;
 
   /* using warmup_frac or warmup_sec of requests from reader to warm up */
@@ -72,29 +401,203 @@ static void _simulate(gpointer data, gpointer user_data) {
     while (req->valid && (n_warmup < params->n_warmup_req ||
                           req->clock_time - start_ts < params->warmup_sec)) {
       req->clock_time -= start_ts;
-      local_cache->get(local_cache, req);
+      cache->get(cache, req);
       n_warmup += 1;
-      read_one_req(cloned_reader, req);
+      read_one_req(reader, req);
+    }
+    *n_warmup_req += n_warmup;
+    if (n_req_done != NULL) {
+      __atomic_store_n(n_req_done, (int64_t)n_warmup, __ATOMIC_RELAXED);
     }
-    result[idx].n_warmup_req += n_warmup;
     INFO("cache %s (size %" PRIu64
          ") finishes warm up using "
          "with %" PRIu64 " requests, %.2lf hour trace time\n",
-         local_cache->cache_name, local_cache->cache_size, n_warmup,
+         cache->cache_name, cache->cache_size, n_warmup,
          (double)(req->clock_time - start_ts) / 3600.0);
   }
 
+  return start_ts;
+}
+
+/* start a forked simulation: restore the warmed-up state into cache and
+ * move reader to where the warmup stopped, req is set to the first request
+ * after the warmup, returns the time the requests are shifted by */
+static int64_t _sim_fork_from_warm_state(const sim_mt_params_t *params,
+                                         cache_t *cache, reader_t *reader,
+                                         request_t *req) {
+  if (!cache_snapshot_from_buf(cache, params->warm_state,
+                               params->warm_state_size)) {
+    ERROR("cannot fork %s from the warmed-up %s\n", cache->cache_name,
+          params->warm_cache_name);
+  }
+  if (!reader_set_pos(reader, &params->warm_pos)) {
+    ERROR("cannot move the reader to the end of the warmup\n");
+  }
+  copy_request(req, params->warm_next_req);
+  return params->warm_start_ts;
+}
+
+/* the checkpoint file of simulation idx, NULL if it is not checkpointed,
+ * the series of the interval output is kept in memory and cannot be
+ * resumed, so the simulations are not checkpointed when it is on */
+static char *_sim_checkpoint_path(const sim_mt_params_t *params, int idx,
+                                  const cache_t *cache) {
+  if (params->sim_params.checkpoint_n_req <= 0 || params->series != NULL ||
+      cache->snapshot == NULL || cache->restore == NULL) {
+    return NULL;
+  }
+  char *path = my_malloc_n(char, SIM_CHECKPOINT_PATH_LEN);
+  sim_checkpoint_path(params->sim_params.checkpoint_dir, idx, cache, path,
+                      SIM_CHECKPOINT_PATH_LEN);
+  return path;
+}
+
+/* resume a simulation from its checkpoint: restore the cache, the reader,
+ * the partial result and the next request, returns the time the requests
+ * are shifted by */
+static int64_t _sim_resume_from_checkpoint(const char *path, cache_t *cache,
+                                           reader_t *reader, request_t *req,
+                                           cache_stat_t *result) {
+  sim_checkpoint_t ckpt;
+  if (!sim_checkpoint_load(path, &ckpt, cache, reader)) {
+    ERROR("cannot resume %s from %s, remove it to start over\n",
+          cache->cache_name, path);
+  }
+  *result = ckpt.result;
+  copy_request(req, &ckpt.next_req);
+  set_rand_seed(ckpt.rand_seed);
+  INFO("cache %s (size %" PRIu64 ") resumes from %s after %" PRIu64
+       " requests\n",
+       cache->cache_name, result->cache_size, path,
+       result->n_req + result->n_warmup_req);
+  return ckpt.start_ts;
+}
+
+/* save the checkpoint of a simulation, req is the next request, a failed
+ * checkpoint does not stop the simulation */
+static void _sim_save_checkpoint(const char *path, const cache_t *cache,
+                                 const reader_t *reader, const request_t *req,
+                                 const cache_stat_t *result,
+                                 int64_t start_ts) {
+  sim_checkpoint_t ckpt;
+  memset(&ckpt, 0, sizeof(sim_checkpoint_t));
+  ckpt.result = *result;
+  ckpt.start_ts = start_ts;
+  copy_request(&ckpt.next_req, req);
+  ckpt.next_req.info = NULL;
+  ckpt.rand_seed = rand_seed;
+  sim_checkpoint_save(path, &ckpt, cache, reader);
+}
+
+static void _simulate(gpointer data, gpointer user_data) {
+  sim_mt_params_t *params = (sim_mt_params_t *)user_data;
+  int idx = GPOINTER_TO_UINT(data) - 1;
+  set_rand_seed(0);
+
+  cache_stat_t *result = params->result;
+  int slot = _sim_pin_worker(params);
+  if (params->caches[idx] == NULL) {
+    params->caches[idx] = create_cache_with_new_size(params->cache_template,
+                                                     result[idx].cache_size);
+  }
+  reader_t *cloned_reader = clone_reader(params->reader);
+  request_t *req = new_request();
+  cache_t *local_cache = params->caches[idx];
+  strncpy(result[idx].cache_name, local_cache->cache_name,
+          CACHE_NAME_ARRAY_LEN);
+
+  g_mutex_lock(&(params->mtx));
+  params->start_time[idx] = g_get_monotonic_time();
+  g_mutex_unlock(&(params->mtx));
+
+  /* the simulation is split into segments of checkpoint_n_req requests when
+   * it is checkpointed */
+  char *ckpt_path = _sim_checkpoint_path(params, idx, local_cache);
+  /* the requests simulated before a resume, not counted in the throughput */
+  int64_t n_req_before = 0;
+  int64_t start_ts;
+  if (ckpt_path != NULL && access(ckpt_path, F_OK) == 0) {
+    start_ts = _sim_resume_from_checkpoint(ckpt_path, local_cache,
+                                           cloned_reader, req, &result[idx]);
+    n_req_before = (int64_t)(result[idx].n_req + result[idx].n_warmup_req);
+  } else if (params->warm_state != NULL) {
+    start_ts = _sim_fork_from_warm_state(params, local_cache, cloned_reader, req);
+    result[idx].n_warmup_req = params->warm_n_warmup_req;
+  } else {
+    start_ts = _sim_warmup(params, local_cache, cloned_reader, req,
+                           &result[idx].n_warmup_req,
+                           &params->n_req_done[idx]);
+  }
+
+  sim_interval_t interval = {.series = NULL, .end_ts = INT64_MAX};
+  if (params->series != NULL && req->valid) {
+    interval.series = &params->series[idx];
+    interval.interval_sec = params->sim_params.interval_sec;
+    _sim_interval_start(&interval, &result[idx], local_cache,
+                        (int64_t)req->clock_time - start_ts);
+  }
+
+  /* requests are passed to the cache in batches so that get_batch can
+   * prefetch the hashtable for the requests ahead, a batch does not cross
+   * the end of an interval, the trace is decoded with read_n_req after the
+   * warmup if the batch has all the fields of the trace */
+  req_batch_t *decode_batch = reader_batch_has_all_fields(cloned_reader)
+                                  ? new_req_batch(SIM_DECODE_BATCH_SIZE)
+                                  : NULL;
+  request_t *reqs = my_malloc_n(request_t, SIM_BATCH_SIZE);
+  bool hits[SIM_BATCH_SIZE];
+  int64_t next_ckpt_n_req =
+      (int64_t)result[idx].n_req + params->sim_params.checkpoint_n_req;
   while (req->valid) {
-    result[idx].n_req++;
-    result[idx].n_req_byte += req->obj_size;
+    int n = 0;
+    while (req->valid && n < SIM_BATCH_SIZE &&
+           (int64_t)req->clock_time - start_ts < interval.end_ts) {
+      req->clock_time -= start_ts;
+      copy_request(&reqs[n++], req);
+      read_one_req_from_batch(cloned_reader, decode_batch, req);
+    }
+
+    local_cache->get_batch(local_cache, reqs, n, hits);
+    for (int i = 0; i < n; i++) {
+      result[idx].n_req++;
+      result[idx].n_req_byte += reqs[i].obj_size;
+      if (!hits[i]) {
+        result[idx].n_miss++;
+        result[idx].n_miss_byte += reqs[i].obj_size;
+      }
+    }
+    __atomic_store_n(&params->n_req_done[idx],
+                     (int64_t)(result[idx].n_req + result[idx].n_warmup_req),
+                     __ATOMIC_RELAXED);
+
+    if (req->valid && (int64_t)req->clock_time - start_ts >= interval.end_ts) {
+      _sim_interval_close(&interval, &result[idx], local_cache);
+      _sim_interval_start(&interval, &result[idx], local_cache,
+                          (int64_t)req->clock_time - start_ts);
+    }
 
-    req->clock_time -= start_ts;
-    if (local_cache->get(local_cache, req) == false) {
-      result[idx].n_miss++;
-      result[idx].n_miss_byte += req->obj_size;
+    /* a checkpoint is taken when the reader is right after req, i.e., all
+     * the requests decoded ahead have been simulated, the batches are not
+     * cut by intervals when checkpointed, so this happens every
+     * SIM_DECODE_BATCH_SIZE / SIM_BATCH_SIZE batches */
+    if (ckpt_path != NULL && req->valid &&
+        (int64_t)result[idx].n_req >= next_ckpt_n_req &&
+        (decode_batch == NULL || decode_batch->pos >= decode_batch->n_req)) {
+      _sim_save_checkpoint(ckpt_path, local_cache, cloned_reader, req,
+                           &result[idx], start_ts);
+      next_ckpt_n_req =
+          (int64_t)result[idx].n_req + params->sim_params.checkpoint_n_req;
     }
-    read_one_req(cloned_reader, req);
   }
+  if (ckpt_path != NULL) {
+    remove(ckpt_path);
+    my_free(sizeof(char) * SIM_CHECKPOINT_PATH_LEN, ckpt_path);
+  }
+  if (interval.series != NULL) {
+    _sim_interval_close(&interval, &result[idx], local_cache);
+  }
+  my_free(sizeof(request_t) * SIM_BATCH_SIZE, reqs);
+  if (decode_batch != NULL) free_req_batch(decode_batch);
 
 /* disabled due to ARC and LeCaR use ghost entries in the hash table */
 #if defined(SUPPORT_TTL) && defined(ENABLE_SCAN)
@@ -118,14 +621,31 @@ static void _simulate(gpointer data, gpointer user_data) {
 #endif
 
   result[idx].curr_rtime = req->clock_time;
-  result[idx].n_obj = local_cache->n_obj;
-  result[idx].occupied_byte = local_cache->occupied_byte;
+  result[idx].n_obj = local_cache->get_n_obj(local_cache);
+  result[idx].occupied_byte = local_cache->get_occupied_byte(local_cache);
   strncpy(result[idx].cache_name, local_cache->cache_name,
           CACHE_NAME_ARRAY_LEN);
 
-  // report progress
+  // report progress, -1 marks the simulation as finished
   g_mutex_lock(&(params->mtx));
   (*(params->progress))++;
+  __atomic_store_n(&params->n_req_done[idx], -1, __ATOMIC_RELAXED);
+  gint64 elapsed_us =
+      MAX(g_get_monotonic_time() - params->start_time[idx], (gint64)1);
+  /* requests per microsecond is MQPS */
+  params->mqps[idx] =
+      (double)((int64_t)(result[idx].n_req + result[idx].n_warmup_req) -
+               n_req_before) /
+      elapsed_us;
+  INFO("cache %s (size %" PRIu64
+       ") finished in %.2lf sec, %.2lf MQPS, %d/%ld done\n",
+       local_cache->cache_name, local_cache->cache_size,
+       (double)elapsed_us / G_USEC_PER_SEC, params->mqps[idx],
+       *(params->progress), (long)params->n_caches);
+  if (local_cache->op_latency != NULL) {
+    op_latency_print(local_cache->op_latency, local_cache->cache_name, stdout);
+  }
+  g_cond_signal(&(params->finish_cond));
   g_mutex_unlock(&(params->mtx));
 
   // clean up
@@ -134,12 +654,13 @@ static void _simulate(gpointer data, gpointer user_data) {
   }
   free_request(req);
   close_reader(cloned_reader);
+  _sim_unpin_worker(params, slot);
 }
 
 cache_stat_t *simulate_at_multi_sizes_with_step_size(
     reader_t *const reader, const cache_t *cache, uint64_t step_size,
     reader_t *warmup_reader, double warmup_frac, int warmup_sec,
-    int num_of_threads) {
+    int num_of_threads, const sim_params_t *sim_params) {
   int num_of_sizes = (int)ceil((double)cache->cache_size / (double)step_size);
   get_num_of_req(reader);
   uint64_t *cache_sizes = my_malloc_n(uint64_t, num_of_sizes);
@@ -149,7 +670,7 @@ cache_stat_t *simulate_at_multi_sizes_with_step_size(
 
   cache_stat_t *res = simulate_at_multi_sizes(
       reader, cache, num_of_sizes, cache_sizes, warmup_reader, warmup_frac,
-      warmup_sec, num_of_threads);
+      warmup_sec, num_of_threads, sim_params);
   my_free(sizeof(uint64_t) * num_of_sizes, cache_sizes);
   return res;
 }
@@ -165,6 +686,7 @@ cache_stat_t *simulate_at_multi_sizes_with_step_size(
  * @param warmup_frac use warmup_frac of requests from reader to warm up cache
  * @param warmup_sec uses warmup_sec seconds of requests to warm up cache
  * @param num_of_threads
+ * @param sim_params the options of the run, NULL for the default
  *
  * note that warmup_reader, warmup_frac and warmup_sec are mutually exclusive
  *
@@ -174,7 +696,8 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
                                       const uint64_t *cache_sizes,
                                       reader_t *warmup_reader,
                                       double warmup_frac, int warmup_sec,
-                                      int num_of_threads) {
+                                      int num_of_threads,
+                                      const sim_params_t *sim_params) {
   int progress = 0;
 
   cache_stat_t *result = my_malloc_n(cache_stat_t, num_of_sizes);
@@ -191,7 +714,12 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
   params->result = result;
   params->free_cache_when_finish = true;
   params->progress = &progress;
-  g_mutex_init(&(params->mtx));
+  params->cache_template = cache;
+  params->warm_state = NULL;
+  params->sim_params = _sim_params(sim_params);
+  _sim_progress_init(params, num_of_sizes);
+  _sim_placement_init(params, num_of_threads);
+  params->series = _sim_series_new(&params->sim_params, num_of_sizes);
 
   // build the thread pool
   GThreadPool *gthread_pool = g_thread_pool_new(
@@ -200,13 +728,15 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
 
   // start computation
   params->caches = my_malloc_n(cache_t *, num_of_sizes);
-  for (int i = 1; i < num_of_sizes + 1; i++) {
-    params->caches[i - 1] =
-        create_cache_with_new_size(cache, cache_sizes[i - 1]);
-    result[i - 1].cache_size = cache_sizes[i - 1];
-    ASSERT_TRUE(g_thread_pool_push(gthread_pool, GSIZE_TO_POINTER(i), NULL),
-                "cannot push data into thread_pool in get_miss_ratio\n");
+  for (int i = 0; i < num_of_sizes; i++) {
+    /* pinned workers create their own cache */
+    params->caches[i] = params->n_slot > 0
+                            ? NULL
+                            : create_cache_with_new_size(cache, cache_sizes[i]);
+    result[i].cache_size = cache_sizes[i];
   }
+  sim_cost_model_t *cost_model = sim_cost_model_load(params->sim_params.cost_model_path);
+  _sim_push_by_cost(gthread_pool, params, num_of_sizes, cost_model);
 
   char start_cache_size[64], end_cache_size[64];
   convert_size_to_str(cache_sizes[0], start_cache_size);
@@ -219,13 +749,16 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
       start_cache_size, end_cache_size, num_of_sizes, num_of_threads);
 
   // wait for all simulations to finish
-  while (progress < (uint64_t)num_of_sizes - 1) {
-    print_progress((double)progress / (double)(num_of_sizes - 1) * 100);
-  }
+  _sim_wait_for_finish(params, num_of_sizes);
+  _sim_learn_cost(params, num_of_sizes, cost_model);
+  _sim_series_finish(params->series, &params->sim_params, result,
+                     num_of_sizes);
 
   // clean up
   g_thread_pool_free(gthread_pool, FALSE, TRUE);
-  g_mutex_clear(&(params->mtx));
+  sim_cost_model_free(cost_model);
+  _sim_progress_free(params, num_of_sizes);
+  _sim_placement_free(params);
   my_free(sizeof(cache_t *) * num_of_sizes, params->caches);
   my_free(sizeof(sim_mt_params_t), params);
 
@@ -233,34 +766,14 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache,
   return result;
 }
 
-/**
- * @brief run multiple simulations in parallel
- *
- * @param reader
- * @param caches
- * @param num_of_caches
- * @param warmup_reader
- * @param warmup_frac
- * @param warmup_sec
- * @param num_of_threads
- * @return cache_stat_t*
- */
-cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
-                                         int num_of_caches,
-                                         reader_t *warmup_reader,
-                                         double warmup_frac, int warmup_sec,
-                                         int num_of_threads,
-                                         bool free_cache_when_finish) {
-  assert(num_of_caches > 0);
-  int i, progress = 0;
-
-  cache_stat_t *result = my_malloc_n(cache_stat_t, num_of_caches);
-  memset(result, 0, sizeof(cache_stat_t) * num_of_caches);
-
-  // build parameters and send to thread pool
+static sim_mt_params_t *_sim_multi_caches_params(
+    reader_t *reader, cache_t *caches[], int num_of_caches,
+    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+    bool free_cache_when_finish, const sim_params_t *sim_params) {
   sim_mt_params_t *params = my_malloc(sim_mt_params_t);
   params->reader = reader;
   params->caches = caches;
+  params->n_caches = num_of_caches;
   params->warmup_reader = warmup_reader;
   params->warmup_sec = warmup_sec;
   if (warmup_frac > 1e-6) {
@@ -269,24 +782,37 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
   } else {
     params->n_warmup_req = 0;
   }
-  params->result = result;
+  params->result = my_malloc_n(cache_stat_t, num_of_caches);
+  memset(params->result, 0, sizeof(cache_stat_t) * num_of_caches);
   params->free_cache_when_finish = free_cache_when_finish;
-  params->progress = &progress;
-  g_mutex_init(&(params->mtx));
+  params->cache_template = NULL;
+  params->warm_state = NULL;
+  params->sim_params = _sim_params(sim_params);
+  return params;
+}
+
+/* run the caches of params in a thread pool and wait for them, params is
+ * freed, the result is returned */
+static cache_stat_t *_sim_run_multi_caches(sim_mt_params_t *params,
+                                           int num_of_threads,
+                                           const char *func_name) {
+  int num_of_caches = (int)params->n_caches;
+  cache_t **caches = params->caches;
+  cache_stat_t *result = params->result;
+  _sim_progress_init(params, num_of_caches);
+  _sim_placement_init(params, num_of_threads);
+  params->series = _sim_series_new(&params->sim_params, num_of_caches);
 
   // build the thread pool
   GThreadPool *gthread_pool = g_thread_pool_new(
       (GFunc)_simulate, (gpointer)params, num_of_threads, TRUE, NULL);
   ASSERT_NOT_NULL(gthread_pool, "cannot create thread pool in simulator\n");
 
-  // start computation
-  for (i = 1; i < num_of_caches + 1; i++) {
-    result[i - 1].cache_size = caches[i - 1]->cache_size;
-
-    ASSERT_TRUE(g_thread_pool_push(gthread_pool, GSIZE_TO_POINTER(i), NULL),
-                "cannot push data into thread_pool in get_miss_ratio\n");
+  for (int i = 0; i < num_of_caches; i++) {
+    result[i].cache_size = caches[i]->cache_size;
   }
 
+  /* the caches may be freed by the workers as soon as they are pushed */
   char start_cache_size[64], end_cache_size[64];
   convert_size_to_str(result[0].cache_size, start_cache_size);
   convert_size_to_str(result[num_of_caches - 1].cache_size, end_cache_size);
@@ -294,24 +820,530 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
   INFO(
       "%s starts computation, num_warmup_req %lld, start cache %s size %s, "
       "end cache %s size %s, %d caches, %d threads, please wait\n",
-      __func__, (long long)(params->n_warmup_req), caches[0]->cache_name,
+      func_name, (long long)(params->n_warmup_req), caches[0]->cache_name,
       start_cache_size, caches[num_of_caches - 1]->cache_name, end_cache_size,
       num_of_caches, num_of_threads);
 
+  // start computation
+  sim_cost_model_t *cost_model = sim_cost_model_load(params->sim_params.cost_model_path);
+  _sim_push_by_cost(gthread_pool, params, num_of_caches, cost_model);
+
   // wait for all simulations to finish
-  while (progress < (uint64_t)num_of_caches - 1) {
-    print_progress((double)progress / (double)(num_of_caches - 1) * 100);
-  }
+  _sim_wait_for_finish(params, num_of_caches);
+  _sim_learn_cost(params, num_of_caches, cost_model);
+  _sim_series_finish(params->series, &params->sim_params, result,
+                     num_of_caches);
 
   // clean up
   g_thread_pool_free(gthread_pool, FALSE, TRUE);
-  g_mutex_clear(&(params->mtx));
+  sim_cost_model_free(cost_model);
+  _sim_progress_free(params, num_of_caches);
+  _sim_placement_free(params);
   my_free(sizeof(sim_mt_params_t), params);
 
   // user is responsible for free-ing the result
   return result;
 }
 
+/**
+ * @brief run multiple simulations in parallel
+ *
+ * @param reader
+ * @param caches
+ * @param num_of_caches
+ * @param warmup_reader
+ * @param warmup_frac
+ * @param warmup_sec
+ * @param num_of_threads
+ * @param sim_params the options of the run, NULL for the default
+ * @return cache_stat_t*
+ */
+cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[],
+                                         int num_of_caches,
+                                         reader_t *warmup_reader,
+                                         double warmup_frac, int warmup_sec,
+                                         int num_of_threads,
+                                         bool free_cache_when_finish,
+                                         const sim_params_t *sim_params) {
+  assert(num_of_caches > 0);
+  int progress = 0;
+
+  sim_mt_params_t *params =
+      _sim_multi_caches_params(reader, caches, num_of_caches, warmup_reader,
+                               warmup_frac, warmup_sec, free_cache_when_finish,
+                               sim_params);
+  params->progress = &progress;
+  return _sim_run_multi_caches(params, num_of_threads, __func__);
+}
+
+/**
+ * @brief warm up warm_cache once, then fork its state into each of caches
+ * and run them on the rest of the trace in parallel
+ *
+ * @param reader
+ * @param warm_cache the cache warmed up, it is not freed
+ * @param caches the variants, empty caches of the same algorithm as
+ * warm_cache
+ * @param num_of_caches
+ * @param warmup_reader
+ * @param warmup_frac
+ * @param warmup_sec
+ * @param num_of_threads
+ * @param free_cache_when_finish
+ * @param sim_params the options of the run, NULL for the default
+ * @return cache_stat_t*
+ */
+cache_stat_t *simulate_forks_from_warmup(
+    reader_t *reader, cache_t *warm_cache, cache_t *caches[], int num_of_caches,
+    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+    int num_of_threads, bool free_cache_when_finish,
+    const sim_params_t *sim_params) {
+  assert(num_of_caches > 0);
+  int progress = 0;
+
+  sim_mt_params_t *params =
+      _sim_multi_caches_params(reader, caches, num_of_caches, warmup_reader,
+                               warmup_frac, warmup_sec, free_cache_when_finish,
+                               sim_params);
+  params->progress = &progress;
+
+  /* warm up on the calling thread, the warmup stops after reading the first
+   * measured request, so the forks start from it and continue the trace from
+   * the position after it */
+  set_rand_seed(0);
+  reader_t *warm_reader = clone_reader(reader);
+  request_t *next_req = new_request();
+  int64_t n_warmup_req = 0;
+  gint64 start_time = g_get_monotonic_time();
+  params->warm_start_ts = _sim_warmup(params, warm_cache, warm_reader,
+                                      next_req, &n_warmup_req, NULL);
+  reader_get_pos(warm_reader, &params->warm_pos);
+  close_reader(warm_reader);
+
+  char *warm_state;
+  size_t warm_state_size;
+  if (!cache_snapshot_to_buf(warm_cache, &warm_state, &warm_state_size)) {
+    ERROR("cannot fork %s, the algorithm does not support snapshots\n",
+          warm_cache->cache_name);
+  }
+  INFO("%s warms up %s with %" PRId64
+       " requests in %.2lf sec, the state is %.2lf MiB\n",
+       __func__, warm_cache->cache_name, n_warmup_req,
+       (double)(g_get_monotonic_time() - start_time) / G_USEC_PER_SEC,
+       (double)warm_state_size / MiB);
+
+  params->warm_state = warm_state;
+  params->warm_state_size = warm_state_size;
+  params->warm_cache_name = warm_cache->cache_name;
+  params->warm_next_req = next_req;
+  params->warm_n_warmup_req = n_warmup_req;
+  cache_stat_t *result = _sim_run_multi_caches(params, num_of_threads, __func__);
+
+  free(warm_state);
+  free_request(next_req);
+  return result;
+}
+
+/* the shared-decode simulation: the calling thread decodes the trace once
+ * into a ring of request batches, the worker threads take the caches of
+ * each batch one at a time, a batch slot is reused only after all workers
+ * have consumed it, so the decoder blocks (back-pressure) instead of running
+ * ahead of the slowest cache, the memory used is bounded by the ring */
+#define SHARED_DECODE_N_BATCH 64
+#define SHARED_DECODE_BATCH_SIZE 1024
+
+typedef struct {
+  request_t *reqs;
+  int n_req;
+  /* all requests in a batch are either warmup or measured */
+  bool warmup;
+  /* the next cache to run on the batch, the workers take the caches one at
+   * a time so that a slow cache does not hold back the other caches of its
+   * worker */
+  int next_cache;
+  /* the number of workers that have not consumed the batch */
+  int n_pending;
+} sim_batch_t;
+
+typedef struct {
+  sim_batch_t ring[SHARED_DECODE_N_BATCH];
+  /* batches [0, n_filled) have been decoded */
+  int64_t n_filled;
+  /* the decoder has reached the end of the trace */
+  bool done;
+  GMutex mtx;
+  GCond filled_cond;
+  GCond consumed_cond;
+  /* signaled when a cache finishes a batch */
+  GCond cache_cond;
+
+  /* decoder state, only used by the decoder */
+  reader_t *reader;
+  reader_t *warmup_reader;
+  request_t *req;
+  /* the trace is decoded with read_n_req, NULL if the batch does not have
+   * all the fields of the trace */
+  req_batch_t *decode_batch;
+  bool started;
+  bool warmup_done;
+  int64_t start_ts;
+  uint64_t n_warmup;
+  uint64_t n_warmup_req;
+  int warmup_sec;
+
+  cache_t **caches;
+  int n_caches;
+  int n_workers;
+  cache_stat_t *result;
+  /* the number of batches each cache has run, a cache runs batch k only
+   * after batch k - 1, which may have been run by another worker */
+  int64_t *cache_n_batch;
+  /* the next cache to finish at the end of the trace */
+  int next_finish;
+  bool free_cache_when_finish;
+  /* the core of each worker, NULL when not pinned */
+  int *worker_core;
+  sim_params_t sim_params;
+  /* the per-interval counters and the current interval of each cache,
+   * NULL when the interval output is off */
+  sim_series_t *series;
+  sim_interval_t *intervals;
+} sim_shared_decode_t;
+
+typedef struct {
+  sim_shared_decode_t *sd;
+  int worker_id;
+} sim_worker_params_t;
+
+/* whether sd->req, which has not been shifted by start_ts yet, is used to
+ * warm up the caches, the warmup is a prefix of the trace */
+static bool _is_warmup_req(sim_shared_decode_t *sd) {
+  if (!sd->warmup_done &&
+      !(sd->n_warmup < sd->n_warmup_req ||
+        sd->req->clock_time - sd->start_ts < sd->warmup_sec)) {
+    sd->warmup_done = true;
+  }
+  return !sd->warmup_done;
+}
+
+/* the caches share the batch, so the hash that get_batch uses is computed
+ * here once instead of written by every cache */
+static inline void _copy_batch_req(sim_batch_t *batch, const request_t *req) {
+  request_t *batch_req = &batch->reqs[batch->n_req++];
+  copy_request(batch_req, req);
+  if (batch_req->hv == 0) {
+    batch_req->hv = get_hash_value_int_64(&batch_req->obj_id);
+  }
+}
+
+/* decode the next batch, return false at the end of the trace */
+static bool _decode_batch(sim_shared_decode_t *sd, sim_batch_t *batch) {
+  batch->n_req = 0;
+
+  /* the warmup reader is consumed before the trace */
+  if (sd->warmup_reader != NULL) {
+    batch->warmup = true;
+    while (batch->n_req < SHARED_DECODE_BATCH_SIZE) {
+      read_one_req(sd->warmup_reader, sd->req);
+      if (!sd->req->valid) {
+        close_reader(sd->warmup_reader);
+        sd->warmup_reader = NULL;
+        break;
+      }
+      _copy_batch_req(batch, sd->req);
+    }
+    if (batch->n_req > 0) return true;
+  }
+
+  if (!sd->started) {
+    read_one_req_from_batch(sd->reader, sd->decode_batch, sd->req);
+    sd->start_ts = (int64_t)sd->req->clock_time;
+    sd->started = true;
+  }
+
+  batch->warmup = _is_warmup_req(sd);
+  while (sd->req->valid && batch->n_req < SHARED_DECODE_BATCH_SIZE &&
+         _is_warmup_req(sd) == batch->warmup) {
+    if (batch->warmup) sd->n_warmup += 1;
+    sd->req->clock_time -= sd->start_ts;
+    _copy_batch_req(batch, sd->req);
+    read_one_req_from_batch(sd->reader, sd->decode_batch, sd->req);
+  }
+
+  return batch->n_req > 0;
+}
+
+/* wait until the cache has run k batches */
+static void _wait_cache_batch(sim_shared_decode_t *sd, int idx, int64_t k) {
+  if (__atomic_load_n(&sd->cache_n_batch[idx], __ATOMIC_ACQUIRE) >= k) return;
+  g_mutex_lock(&sd->mtx);
+  while (__atomic_load_n(&sd->cache_n_batch[idx], __ATOMIC_ACQUIRE) < k) {
+    g_cond_wait(&sd->cache_cond, &sd->mtx);
+  }
+  g_mutex_unlock(&sd->mtx);
+}
+
+/* run the requests of batch on the cache idx */
+static void _simulate_shared_decode_batch(sim_shared_decode_t *sd, int idx,
+                                          const sim_batch_t *batch) {
+  cache_t *cache = sd->caches[idx];
+  cache_stat_t *result = &sd->result[idx];
+  bool hits[SIM_BATCH_SIZE];
+
+  /* each cache keeps its own stream as if it had a thread */
+  set_rand_state(&cache->rand_state);
+  if (batch->warmup) {
+    for (int i = 0; i < batch->n_req; i++) {
+      cache->get(cache, &batch->reqs[i]);
+    }
+    result->n_warmup_req += batch->n_req;
+    set_rand_state(NULL);
+    return;
+  }
+
+  for (int start = 0; start < batch->n_req;) {
+    int n = MIN(SIM_BATCH_SIZE, batch->n_req - start);
+    if (sd->intervals != NULL) {
+      /* a get_batch does not cross the end of an interval */
+      sim_interval_t *interval = &sd->intervals[idx];
+      int64_t ts = (int64_t)batch->reqs[start].clock_time;
+      if (ts >= interval->end_ts) {
+        _sim_interval_close(interval, result, cache);
+        _sim_interval_start(interval, result, cache, ts);
+      }
+      int n_in = 1;
+      while (n_in < n && (int64_t)batch->reqs[start + n_in].clock_time <
+                             interval->end_ts) {
+        n_in++;
+      }
+      n = n_in;
+    }
+    cache->get_batch(cache, &batch->reqs[start], n, hits);
+    for (int i = 0; i < n; i++) {
+      result->n_req++;
+      result->n_req_byte += batch->reqs[start + i].obj_size;
+      if (!hits[i]) {
+        result->n_miss++;
+        result->n_miss_byte += batch->reqs[start + i].obj_size;
+      }
+    }
+    start += n;
+  }
+  set_rand_state(NULL);
+}
+
+static gpointer _simulate_shared_decode_worker(gpointer data) {
+  sim_worker_params_t *wp = (sim_worker_params_t *)data;
+  sim_shared_decode_t *sd = wp->sd;
+  cache_stat_t *result = sd->result;
+  int64_t last_rtime = 0;
+  if (sd->worker_core != NULL) {
+    set_thread_affinity_to_core(pthread_self(), sd->worker_core[wp->worker_id]);
+  }
+
+  int64_t n_batch;
+  for (n_batch = 0;; n_batch++) {
+    g_mutex_lock(&sd->mtx);
+    while (n_batch >= sd->n_filled && !sd->done) {
+      g_cond_wait(&sd->filled_cond, &sd->mtx);
+    }
+    bool has_batch = n_batch < sd->n_filled;
+    g_mutex_unlock(&sd->mtx);
+    if (!has_batch) break;
+
+    /* the batch is read-only until all workers have consumed it */
+    sim_batch_t *batch = &sd->ring[n_batch % SHARED_DECODE_N_BATCH];
+    for (;;) {
+      int idx = __atomic_fetch_add(&batch->next_cache, 1, __ATOMIC_RELAXED);
+      if (idx >= sd->n_caches) break;
+      _wait_cache_batch(sd, idx, n_batch);
+      _simulate_shared_decode_batch(sd, idx, batch);
+      g_mutex_lock(&sd->mtx);
+      __atomic_store_n(&sd->cache_n_batch[idx], n_batch + 1, __ATOMIC_RELEASE);
+      g_cond_broadcast(&sd->cache_cond);
+      g_mutex_unlock(&sd->mtx);
+    }
+    if (batch->n_req > 0) {
+      last_rtime = (int64_t)batch->reqs[batch->n_req - 1].clock_time;
+    }
+
+    g_mutex_lock(&sd->mtx);
+    if (--batch->n_pending == 0) {
+      g_cond_signal(&sd->consumed_cond);
+    }
+    g_mutex_unlock(&sd->mtx);
+  }
+
+  /* every worker has seen all n_batch batches, a cache is finished once it
+   * has run all of them */
+  for (;;) {
+    int idx = __atomic_fetch_add(&sd->next_finish, 1, __ATOMIC_RELAXED);
+    if (idx >= sd->n_caches) break;
+    _wait_cache_batch(sd, idx, n_batch);
+    cache_t *cache = sd->caches[idx];
+    if (sd->intervals != NULL) {
+      _sim_interval_close(&sd->intervals[idx], &result[idx], cache);
+    }
+    result[idx].curr_rtime = last_rtime;
+    result[idx].n_obj = cache->get_n_obj(cache);
+    result[idx].occupied_byte = cache->get_occupied_byte(cache);
+    strncpy(result[idx].cache_name, cache->cache_name, CACHE_NAME_ARRAY_LEN);
+    if (sd->free_cache_when_finish) {
+      cache->cache_free(cache);
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief run multiple simulations decoding the trace only once
+ *
+ * the results are the same as simulate_with_multi_caches, the trace is
+ * decoded by the calling thread and shared by the num_of_threads workers,
+ * the workers take the caches of each batch one at a time, each cache has
+ * its own next_rand state (cache->rand_state) starting from seed 0 like a
+ * cache simulated on its own thread, algorithms using the libc rand are not
+ * deterministic in either path,
+ * this is faster when decoding (e.g., zstd decompression) is a large part of
+ * the simulation, the workers progress at the pace of the slowest cache
+ *
+ * @param reader
+ * @param caches
+ * @param num_of_caches
+ * @param warmup_reader
+ * @param warmup_frac
+ * @param warmup_sec
+ * @param num_of_threads
+ * @param sim_params the options of the run, NULL for the default
+ * @return cache_stat_t*
+ */
+cache_stat_t *simulate_with_multi_caches_shared_decode(
+    reader_t *reader, cache_t *caches[], int num_of_caches,
+    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+    int num_of_threads, bool free_cache_when_finish,
+    const sim_params_t *sim_params) {
+  assert(num_of_caches > 0);
+
+  cache_stat_t *result = my_malloc_n(cache_stat_t, num_of_caches);
+  memset(result, 0, sizeof(cache_stat_t) * num_of_caches);
+  for (int i = 0; i < num_of_caches; i++) {
+    result[i].cache_size = caches[i]->cache_size;
+  }
+
+  sim_shared_decode_t *sd = my_malloc(sim_shared_decode_t);
+  memset(sd, 0, sizeof(sim_shared_decode_t));
+  for (int i = 0; i < SHARED_DECODE_N_BATCH; i++) {
+    sd->ring[i].reqs = my_malloc_n(request_t, SHARED_DECODE_BATCH_SIZE);
+  }
+  g_mutex_init(&sd->mtx);
+  g_cond_init(&sd->filled_cond);
+  g_cond_init(&sd->consumed_cond);
+  g_cond_init(&sd->cache_cond);
+  sd->reader = clone_reader(reader);
+  sd->warmup_reader =
+      warmup_reader == NULL ? NULL : clone_reader(warmup_reader);
+  sd->req = new_request();
+  if (reader_batch_has_all_fields(sd->reader)) {
+    sd->decode_batch = new_req_batch(SIM_DECODE_BATCH_SIZE);
+  }
+  sd->warmup_sec = warmup_sec;
+  if (warmup_frac > 1e-6) {
+    sd->n_warmup_req = (uint64_t)((double)get_num_of_req(reader) * warmup_frac);
+  }
+  sd->caches = caches;
+  sd->n_caches = num_of_caches;
+  sd->n_workers = MAX(1, MIN(num_of_threads, num_of_caches));
+  sd->result = result;
+  sd->cache_n_batch = my_malloc_n(int64_t, num_of_caches);
+  memset(sd->cache_n_batch, 0, sizeof(int64_t) * num_of_caches);
+  sd->free_cache_when_finish = free_cache_when_finish;
+  sd->sim_params = _sim_params(sim_params);
+  sd->worker_core =
+      _sim_slot_cores(sd->sim_params.thread_placement, sd->n_workers);
+  sd->series = _sim_series_new(&sd->sim_params, num_of_caches);
+  if (sd->series != NULL) {
+    /* each interval starts at the first measured request of the cache */
+    sd->intervals = my_malloc_n(sim_interval_t, num_of_caches);
+    memset(sd->intervals, 0, sizeof(sim_interval_t) * num_of_caches);
+    for (int i = 0; i < num_of_caches; i++) {
+      sd->intervals[i].series = &sd->series[i];
+      sd->intervals[i].interval_sec = sd->sim_params.interval_sec;
+      sd->intervals[i].end_ts = INT64_MIN;
+    }
+  }
+
+  INFO(
+      "%s starts computation, num_warmup_req %lld, %d caches, %d threads, "
+      "please wait\n",
+      __func__, (long long)sd->n_warmup_req, num_of_caches, sd->n_workers);
+
+  sim_worker_params_t *worker_params =
+      my_malloc_n(sim_worker_params_t, sd->n_workers);
+  GThread **workers = my_malloc_n(GThread *, sd->n_workers);
+  for (int i = 0; i < sd->n_workers; i++) {
+    worker_params[i].sd = sd;
+    worker_params[i].worker_id = i;
+    workers[i] = g_thread_new("sim-worker", _simulate_shared_decode_worker,
+                              &worker_params[i]);
+  }
+
+  /* decode into the ring, wait for a slot when all are in use */
+  for (int64_t k = 0;; k++) {
+    sim_batch_t *batch = &sd->ring[k % SHARED_DECODE_N_BATCH];
+    g_mutex_lock(&sd->mtx);
+    while (batch->n_pending > 0) {
+      g_cond_wait(&sd->consumed_cond, &sd->mtx);
+    }
+    g_mutex_unlock(&sd->mtx);
+
+    bool has_batch = _decode_batch(sd, batch);
+
+    g_mutex_lock(&sd->mtx);
+    if (has_batch) {
+      batch->next_cache = 0;
+      batch->n_pending = sd->n_workers;
+      sd->n_filled += 1;
+    } else {
+      sd->done = true;
+    }
+    g_cond_broadcast(&sd->filled_cond);
+    g_mutex_unlock(&sd->mtx);
+    if (!has_batch) break;
+  }
+
+  for (int i = 0; i < sd->n_workers; i++) {
+    g_thread_join(workers[i]);
+  }
+  _sim_series_finish(sd->series, &sd->sim_params, result, num_of_caches);
+  if (sd->intervals != NULL) {
+    my_free(sizeof(sim_interval_t) * num_of_caches, sd->intervals);
+  }
+
+  // clean up
+  my_free(sizeof(GThread *) * sd->n_workers, workers);
+  my_free(sizeof(sim_worker_params_t) * sd->n_workers, worker_params);
+  if (sd->worker_core != NULL) {
+    my_free(sizeof(int) * sd->n_workers, sd->worker_core);
+  }
+  my_free(sizeof(int64_t) * sd->n_caches, sd->cache_n_batch);
+  for (int i = 0; i < SHARED_DECODE_N_BATCH; i++) {
+    my_free(sizeof(request_t) * SHARED_DECODE_BATCH_SIZE, sd->ring[i].reqs);
+  }
+  if (sd->warmup_reader != NULL) close_reader(sd->warmup_reader);
+  close_reader(sd->reader);
+  free_request(sd->req);
+  if (sd->decode_batch != NULL) free_req_batch(sd->decode_batch);
+  g_cond_clear(&sd->filled_cond);
+  g_cond_clear(&sd->consumed_cond);
+  g_cond_clear(&sd->cache_cond);
+  g_mutex_clear(&sd->mtx);
+  my_free(sizeof(sim_shared_decode_t), sd);
+
+  // user is responsible for free-ing the result
+  return result;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -88,8 +88,12 @@ void traceAnalyzer::TraceAnalyzer::cleanup() {
 void traceAnalyzer::TraceAnalyzer::run() {
   if (has_run_) return;
 
-  request_t *req = new_request();
-  read_one_req(reader_, req);
+  request_t *req = new_request_with_info();
+  /* decode the trace with read_n_req if the batch has all the fields */
+  req_batch_t *batch = reader_batch_has_all_fields(reader_)
+                           ? new_req_batch(ANALYZER_DECODE_BATCH_SIZE)
+                           : nullptr;
+  read_one_req_from_batch(reader_, batch, req);
   start_ts_ = req->clock_time;
   int32_t curr_time_window_idx = 0;
   int next_time_window_ts = time_window_;
@@ -123,16 +127,16 @@ void traceAnalyzer::TraceAnalyzer::run() {
     auto it = obj_map_.find(req->obj_id);
     if (it == obj_map_.end()) {
       /* the first request to the object */
-      req->compulsory_miss =
+      req->info->compulsory_miss =
           true; /* whether the object is seen for the first time */
-      req->overwrite = false;
-      req->first_seen_in_window = true;
-      req->create_rtime = (int32_t)req->clock_time;
-      req->prev_size = -1;
+      req->info->overwrite = false;
+      req->info->first_seen_in_window = true;
+      req->info->create_rtime = (int32_t)req->clock_time;
+      req->info->prev_size = -1;
       //      req->last_seen_window_idx = curr_time_window_idx;
 
-      req->vtime_since_last_access = -1;
-      req->rtime_since_last_access = -1;
+      req->info->vtime_since_last_access = -1;
+      req->info->rtime_since_last_access = -1;
 
       struct obj_info obj_info;
       obj_info.create_rtime = (int32_t)req->clock_time;
@@ -145,25 +149,25 @@ void traceAnalyzer::TraceAnalyzer::run() {
       sum_obj_size_obj += req->obj_size;
 
     } else {
-      req->compulsory_miss = false;
-      req->first_seen_in_window =
+      req->info->compulsory_miss = false;
+      req->info->first_seen_in_window =
           (time_to_window_idx(it->second.last_access_rtime) !=
            curr_time_window_idx);
-      req->create_rtime = it->second.create_rtime;
+      req->info->create_rtime = it->second.create_rtime;
       if (req->op == OP_SET || req->op == OP_REPLACE || req->op == OP_CAS) {
-        req->overwrite = true;
+        req->info->overwrite = true;
       } else {
-        req->overwrite = false;
+        req->info->overwrite = false;
       }
-      req->vtime_since_last_access =
+      req->info->vtime_since_last_access =
           (int64_t)n_req_ - it->second.last_access_vtime;
-      req->rtime_since_last_access =
+      req->info->rtime_since_last_access =
           (int64_t)(req->clock_time) - it->second.last_access_rtime;
 
-      assert(req->vtime_since_last_access > 0);
-      assert(req->rtime_since_last_access >= 0);
+      assert(req->info->vtime_since_last_access > 0);
+      assert(req->info->rtime_since_last_access >= 0);
 
-      req->prev_size = it->second.obj_size;
+      req->info->prev_size = it->second.obj_size;
       it->second.obj_size = req->obj_size;
       it->second.freq += 1;
       it->second.last_access_vtime = n_req_;
@@ -215,7 +219,7 @@ void traceAnalyzer::TraceAnalyzer::run() {
       scan_detector_->add_req(req);
     }
 
-    read_one_req(reader_, req);
+    read_one_req_from_batch(reader_, batch, req);
   } while (req->valid);
   end_ts_ = req->clock_time + start_ts_;
 
@@ -223,6 +227,9 @@ void traceAnalyzer::TraceAnalyzer::run() {
   post_processing();
 
   free_request(req);
+  if (batch != nullptr) {
+    free_req_batch(batch);
+  }
 
   ofstream ofs("stat", ios::out | ios::app);
   ofs << gen_stat_str() << endl;
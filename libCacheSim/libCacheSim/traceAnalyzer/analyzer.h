@@ -98,6 +98,8 @@ static struct analysis_option default_option() {
 };
 
 #define DEFAULT_PREALLOC_N_OBJ 1e8
+/* the number of requests decoded by read_n_req at a time */
+#define ANALYZER_DECODE_BATCH_SIZE 512
 
 class TraceAnalyzer {
  public:
@@ -18,12 +18,14 @@
 namespace traceAnalyzer {
 using namespace std;
 void ProbAtAge::add_req(request_t *req) {
-  if (req->clock_time < warmup_rtime_ || req->create_rtime < warmup_rtime_) {
+  if (req->clock_time < warmup_rtime_ ||
+      req->info->create_rtime < warmup_rtime_) {
     return;
   }
 
-  int pos_access = (int)(req->rtime_since_last_access / time_window_);
-  int pos_create = (int)((req->clock_time - req->create_rtime) / time_window_);
+  int pos_access = (int)(req->info->rtime_since_last_access / time_window_);
+  int pos_create =
+      (int)((req->clock_time - req->info->create_rtime) / time_window_);
 
   auto p = pair<int32_t, int32_t>(pos_access, pos_create);
   ac_age_req_cnt_[p] += 1;
@@ -47,10 +47,10 @@ int SizeChangeDistribution::absolute_change_to_array_pos(int absolute_change) {
 
 void SizeChangeDistribution::add_req(request_t *req) {
   n_req_total_ += 1;
-  if (req->overwrite) {
-    int absolute_size_change = (int)req->obj_size - (int)req->prev_size;
+  if (req->info->overwrite) {
+    int absolute_size_change = (int)req->obj_size - (int)req->info->prev_size;
     double relative_size_change =
-        (double)absolute_size_change / (double)req->prev_size;
+        (double)absolute_size_change / (double)req->info->prev_size;
     absolute_size_change_cnt_[absolute_change_to_array_pos(
         absolute_size_change)]++;
     relative_size_change_cnt_[relative_change_to_array_pos(
@@ -59,7 +59,7 @@ void SizeChangeDistribution::add_req(request_t *req) {
     //      if (absolute_size_change > 4096) {
     //        print_request(req);
     //        printf("%lf\n", relative_size_change);
-    //        printf("%ld %ld %d %ld\n", req->prev_size, req->obj_size,
+    //        printf("%ld %ld %d %ld\n", req->info->prev_size, req->obj_size,
     //               relative_change_to_array_pos(relative_size_change),
     //               relative_size_change_cnt_[relative_change_to_array_pos(relative_size_change)]);
     //      }
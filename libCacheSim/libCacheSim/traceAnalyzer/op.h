@@ -23,7 +23,7 @@ class OpStat {
 
   inline void add_req(request_t* req) {
     op_cnt_[req->op] += 1;
-    if (req->overwrite) overwrite_cnt_ += 1;
+    if (req->info->overwrite) overwrite_cnt_ += 1;
   }
 
   friend ostream& operator<<(ostream& os, const OpStat& op) {
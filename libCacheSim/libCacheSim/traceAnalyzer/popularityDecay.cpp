@@ -41,7 +41,7 @@ void PopularityDecay::add_req(const request_t *req) {
     return;
   }
 
-  int create_time_window_idx = time_to_window_idx(req->create_rtime);
+  int create_time_window_idx = time_to_window_idx(req->info->create_rtime);
   if (create_time_window_idx < idx_shift) {
     // the object is created during warm up
     return;
@@ -64,7 +64,7 @@ void PopularityDecay::add_req(const request_t *req) {
   assert(create_time_window_idx - idx_shift < n_req_per_window.size());
 
   n_req_per_window.at(create_time_window_idx - idx_shift) += 1;
-  if (req->first_seen_in_window) {
+  if (req->info->first_seen_in_window) {
     n_obj_per_window.at(create_time_window_idx - idx_shift) += 1;
   }
 }
@@ -14,13 +14,13 @@ void ReqRate::add_req(request_t *req) {
 
   window_n_req_ += 1;
   window_n_byte_ += req->obj_size;
-  if (req->first_seen_in_window) window_n_obj_ += 1;
+  if (req->info->first_seen_in_window) window_n_obj_ += 1;
 
   //    if (window_seen_obj_.find(req->obj_id) == window_seen_obj_.end()) {
   //      window_seen_obj_.insert(req->obj_id);
   //    }
 
-  if (req->compulsory_miss) {
+  if (req->info->compulsory_miss) {
     window_compulsory_miss_obj_ += 1;
   }
 
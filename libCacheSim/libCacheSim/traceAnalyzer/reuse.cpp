@@ -19,15 +19,16 @@ void ReuseDistribution::add_req(request_t *req) {
     next_window_ts_ = (int64_t)req->clock_time + time_window_;
   }
 
-  if (req->rtime_since_last_access < 0) {
+  if (req->info->rtime_since_last_access < 0) {
     reuse_rtime_req_cnt_[-1] += 1;
     reuse_vtime_req_cnt_[-1] += 1;
 
     return;
   }
 
-  int pos_rt = (int)(req->rtime_since_last_access / rtime_granularity_);
-  int pos_vt = (int)(log(double(req->vtime_since_last_access)) / log_log_base_);
+  int pos_rt = (int)(req->info->rtime_since_last_access / rtime_granularity_);
+  int pos_vt =
+      (int)(log(double(req->info->vtime_since_last_access)) / log_log_base_);
 
   reuse_rtime_req_cnt_[pos_rt] += 1;
   reuse_vtime_req_cnt_[pos_vt] += 1;
@@ -18,7 +18,7 @@ void SizeDistribution::add_req(request_t *req) {
   obj_size_req_cnt_[req->obj_size] += 1;
 
   /* object count */
-  if (req->compulsory_miss) {
+  if (req->info->compulsory_miss) {
     obj_size_obj_cnt_[req->obj_size] += 1;
   }
 
@@ -43,7 +43,7 @@ void SizeDistribution::add_req(request_t *req) {
   //      window_seen_obj.insert(req->obj_id);
   //    }
 
-  if (req->first_seen_in_window) {
+  if (req->info->first_seen_in_window) {
     window_obj_size_obj_cnt_[pos] += 1;
   }
 
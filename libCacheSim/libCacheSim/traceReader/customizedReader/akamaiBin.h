@@ -68,9 +68,11 @@ static inline int akamai_read_one_req(reader_t *reader, request_t *req) {
   req->clock_time = *(uint32_t *)record;
   req->obj_id = *(uint64_t *)(record + 4);
   req->obj_size = *(uint32_t *)(record + 12);
-  req->tenant_id = *(uint16_t *)(record + 16);
-  req->bucket_id = *(uint16_t *)(record + 18);
-  req->content_type = *(uint16_t *)(record + 20);
+  if (req->info != NULL) {
+    req->info->tenant_id = *(uint16_t *)(record + 16);
+    req->info->bucket_id = *(uint16_t *)(record + 18);
+    req->info->content_type = *(uint16_t *)(record + 20);
+  }
 
   /* if we read a request of size 0 and the trace is reading forward,
      read the next request */
@@ -51,14 +51,16 @@ static int cf1_read_one_req(reader_t *reader, request_t *req) {
   req->obj_id = *(uint64_t *)(record + 4);
   req->obj_size = *(uint64_t *)(record + 12);
   req->ttl = *(int32_t *)(record + 20);
-  req->age = *(uint32_t *)(record + 24);
-  req->hostname = *(uint32_t *)(record + 28);
-  req->content_type = *(uint16_t *)(record + 32);
-  req->extension = *(uint16_t *)(record + 34);
-  req->n_level = *(uint16_t *)(record + 36);
-  req->n_param = *(uint8_t *)(record + 38);
-  req->method = *(uint8_t *)(record + 39);
-  req->colo = *(uint8_t *)(record + 40);
+  if (req->info != NULL) {
+    req->info->age = *(uint32_t *)(record + 24);
+    req->info->hostname = *(uint32_t *)(record + 28);
+    req->info->content_type = *(uint16_t *)(record + 32);
+    req->info->extension = *(uint16_t *)(record + 34);
+    req->info->n_level = *(uint16_t *)(record + 36);
+    req->info->n_param = *(uint8_t *)(record + 38);
+    req->info->method = *(uint8_t *)(record + 39);
+    req->info->colo = *(uint8_t *)(record + 40);
+  }
 
   if (req->obj_size == 0 && reader->ignore_size_zero_req &&
       reader->read_direction == READ_FORWARD)
@@ -37,9 +37,11 @@ static inline int oracleAkamai_read_one_req(reader_t *reader, request_t *req) {
   req->clock_time = *(uint32_t *)record;
   req->obj_id = *(uint64_t *)(record + 4);
   req->obj_size = *(uint32_t *)(record + 12);
-  req->tenant_id = *(int16_t *)(record + 16) - 1;
-  req->bucket_id = *(int16_t *)(record + 18) - 1;
-  req->content_type = *(int16_t *)(record + 20) - 1;
+  if (req->info != NULL) {
+    req->info->tenant_id = *(int16_t *)(record + 16) - 1;
+    req->info->bucket_id = *(int16_t *)(record + 18) - 1;
+    req->info->content_type = *(int16_t *)(record + 20) - 1;
+  }
   req->next_access_vtime = *(int64_t *)(record + 22);
 
   if (req->obj_size == 0 && reader->ignore_size_zero_req &&
@@ -56,15 +56,17 @@ static int oracleCF1_read_one_req(reader_t *reader, request_t *req) {
   }
 
   req->ttl = *(int32_t *)(record + 20);
-  req->age = *(uint32_t *)(record + 24);
-  req->hostname = *(uint32_t *)(record + 28);
   req->next_access_vtime = *(int64_t *)(record + 32);
-  req->content_type = *(uint16_t *)(record + 40);
-  req->extension = *(uint16_t *)(record + 42);
-  req->n_level = *(uint16_t *)(record + 44);
-  req->n_param = *(uint8_t *)(record + 46);
-  req->method = *(uint8_t *)(record + 47);
-  req->colo = *(uint8_t *)(record + 48);
+  if (req->info != NULL) {
+    req->info->age = *(uint32_t *)(record + 24);
+    req->info->hostname = *(uint32_t *)(record + 28);
+    req->info->content_type = *(uint16_t *)(record + 40);
+    req->info->extension = *(uint16_t *)(record + 42);
+    req->info->n_level = *(uint16_t *)(record + 44);
+    req->info->n_param = *(uint8_t *)(record + 46);
+    req->info->method = *(uint8_t *)(record + 47);
+    req->info->colo = *(uint8_t *)(record + 48);
+  }
 
   if (req->obj_size == 0 && reader->ignore_size_zero_req &&
       reader->read_direction == READ_FORWARD)
@@ -51,6 +51,36 @@ static inline int oracleGeneralBin_read_one_req(reader_t *reader,
   return 0;
 }
 
+/* decode at most n requests of an uncompressed trace to the end of batch,
+ * the requests of size zero are not removed, return the number decoded */
+static inline int oracleGeneralBin_read_n_req(reader_t *reader,
+                                              req_batch_t *batch, int n) {
+  size_t n_left = (reader->file_size - reader->mmap_offset) / 24;
+  if ((size_t)n > n_left) n = (int)n_left;
+
+  const char *record = reader->mapped_file + reader->mmap_offset;
+  int64_t *clock_time = batch->clock_time + batch->n_req;
+  obj_id_t *obj_id = batch->obj_id + batch->n_req;
+  int64_t *obj_size = batch->obj_size + batch->n_req;
+  int64_t *next_access_vtime = batch->next_access_vtime + batch->n_req;
+  for (int i = 0; i < n; i++, record += 24) {
+    uint32_t t, sz;
+    uint64_t id;
+    int64_t next;
+    memcpy(&t, record, sizeof(t));
+    memcpy(&id, record + 4, sizeof(id));
+    memcpy(&sz, record + 12, sizeof(sz));
+    memcpy(&next, record + 16, sizeof(next));
+    clock_time[i] = t;
+    obj_id[i] = id;
+    obj_size[i] = sz;
+    next_access_vtime[i] = next == -1 ? INT64_MAX : next;
+  }
+  reader->mmap_offset += (size_t)n * 24;
+
+  return n;
+}
+
 static inline int oracleGeneralOpNS_setup(reader_t *reader) {
   reader->trace_type = ORACLE_GENERALOPNS_TRACE;
   reader->trace_format = BINARY_TRACE_FORMAT;
@@ -73,7 +103,9 @@ static inline int oracleGeneralOpNS_read_one_req(reader_t *reader,
   req->obj_id = *(uint64_t *)(record + 4);
   req->obj_size = *(uint32_t *)(record + 12);
   req->op = *(uint8_t *)(record + 16);
-  req->ns = *(uint16_t *)(record + 17);
+  if (req->info != NULL) {
+    req->info->ns = *(uint16_t *)(record + 17);
+  }
   req->next_access_vtime = *(int64_t *)(record + 19);
   if (req->next_access_vtime == -1) {
     req->next_access_vtime = INT64_MAX;
@@ -62,7 +62,7 @@ static inline int oracleSimTwrBin_read_one_req(reader_t *reader,
     req->next_access_vtime = INT64_MAX;
   }
 
-  if (req->val_size == 0 && reader->ignore_size_zero_req &&
+  if (req->obj_size == 0 && reader->ignore_size_zero_req &&
       (req->op == OP_GET || req->op == OP_GETS) &&
       reader->read_direction == READ_FORWARD)
     return oracleSimTwrBin_read_one_req(reader, req);
@@ -93,18 +93,22 @@ static inline int oracleSysTwrBin_read_one_req(reader_t *reader,
 
   req->clock_time = *(uint32_t *)record;
   req->obj_id = *(uint64_t *)(record + 4);
-  req->key_size = *(uint16_t *)(record + 12);
-  req->val_size = *(uint32_t *)(record + 14);
-  req->obj_size = req->key_size + req->val_size;
+  uint16_t key_size = *(uint16_t *)(record + 12);
+  uint32_t val_size = *(uint32_t *)(record + 14);
+  req->obj_size = key_size + val_size;
   req->op = (req_op_e)(*(uint16_t *)(record + 18));
-  req->ns = *(uint16_t *)(record + 20);
+  if (req->info != NULL) {
+    req->info->key_size = key_size;
+    req->info->val_size = val_size;
+    req->info->ns = *(uint16_t *)(record + 20);
+  }
   req->ttl = *(int32_t *)(record + 22);
   req->next_access_vtime = *(int64_t *)(record + 26);
   if (req->next_access_vtime == -1) {
     req->next_access_vtime = INT64_MAX;
   }
 
-  if (req->val_size == 0 && reader->ignore_size_zero_req &&
+  if (val_size == 0 && reader->ignore_size_zero_req &&
       (req->op == OP_GET || req->op == OP_GETS) &&
       reader->read_direction == READ_FORWARD)
     return oracleSimTwrBin_read_one_req(reader, req);
@@ -57,7 +57,9 @@ static inline int oracleWiki2016u_read_one_req(reader_t *reader,
   req->clock_time = 0;
   req->obj_id = *(uint64_t *)(record);
   req->obj_size = *(uint32_t *)(record + 8);
-  req->content_type = *(uint16_t *)(record + 12);
+  if (req->info != NULL) {
+    req->info->content_type = *(uint16_t *)(record + 12);
+  }
   req->next_access_vtime = *(uint64_t *)(record + 14);
 
   if (req->obj_size == 0 && reader->ignore_size_zero_req &&
@@ -88,7 +90,9 @@ static inline int oracleWiki2019u_read_one_req(reader_t *reader,
   req->clock_time = *(uint32_t *)record;
   req->obj_id = *(uint64_t *)(record + 4);
   req->obj_size = *(uint32_t *)(record + 12);
-  req->content_type = *(uint16_t *)(record + 16);
+  if (req->info != NULL) {
+    req->info->content_type = *(uint16_t *)(record + 16);
+  }
   req->next_access_vtime = *(uint64_t *)(record + 18);
 
   if (req->obj_size == 0 && reader->ignore_size_zero_req &&
@@ -123,7 +123,9 @@ static inline int standardBinIQIBH_read_one_req(reader_t *reader,
   req->obj_id = *(uint64_t *)(record + 4);
   req->obj_size = *(uint32_t *)(record + 12);
   req->op = *(uint8_t *)(record + 16);
-  req->ns = *(uint16_t *)(record + 17);
+  if (req->info != NULL) {
+    req->info->ns = *(uint16_t *)(record + 17);
+  }
 
   DEBUG_ASSERT(req->op != 0 && req->op < OP_INVALID);
 
@@ -43,7 +43,9 @@ static inline int twrNS_read_one_req(reader_t *reader, request_t *req) {
   req->obj_id = *(uint64_t *)(record + 4);
   uint32_t kv_size = *(uint32_t *)(record + 12);
   uint32_t op_ttl = *(uint32_t *)(record + 16);
-  req->ns = *(uint16_t *)(record + 20);
+  if (req->info != NULL) {
+    req->info->ns = *(uint16_t *)(record + 20);
+  }
 
   uint32_t key_size = (kv_size >> 22) & (0x00000400 - 1);
   uint32_t val_size = kv_size & (0x00400000 - 1);
@@ -51,13 +53,15 @@ static inline int twrNS_read_one_req(reader_t *reader, request_t *req) {
   uint32_t op = ((op_ttl >> 24) & (0x00000100 - 1));
   uint32_t ttl = op_ttl & (0x01000000 - 1);
 
-  req->key_size = key_size;
-  req->val_size = val_size;
+  if (req->info != NULL) {
+    req->info->key_size = key_size;
+    req->info->val_size = val_size;
+  }
   req->obj_size = key_size + val_size;
   req->op = (req_op_e)(op);
   req->ttl = (int32_t)ttl;
 
-  if (req->val_size == 0 && reader->ignore_size_zero_req &&
+  if (val_size == 0 && reader->ignore_size_zero_req &&
       (req->op == OP_GET || req->op == OP_GETS) &&
       reader->read_direction == READ_FORWARD)
     return twrNS_read_one_req(reader, req);
@@ -54,7 +54,9 @@ static inline int wiki2016u_read_one_req(reader_t *reader, request_t *req) {
   req->clock_time = 0;
   req->obj_id = *(uint64_t *)(record);
   req->obj_size = *(uint32_t *)(record + 8);
-  req->content_type = *(uint16_t *)(record + 12);
+  if (req->info != NULL) {
+    req->info->content_type = *(uint16_t *)(record + 12);
+  }
 
   if (req->obj_size == 0 && reader->ignore_size_zero_req)
     return wiki2016u_read_one_req(reader, req);
@@ -82,7 +84,9 @@ static inline int wiki2019u_read_one_req(reader_t *reader, request_t *req) {
   req->clock_time = *(uint32_t *)record;
   req->obj_id = *(uint64_t *)(record + 4);
   req->obj_size = *(uint32_t *)(record + 12);
-  req->content_type = *(uint16_t *)(record + 16);
+  if (req->info != NULL) {
+    req->info->content_type = *(uint16_t *)(record + 16);
+  }
 
   if (req->obj_size == 0 && reader->ignore_size_zero_req)
     return wiki2019u_read_one_req(reader, req);
@@ -251,6 +251,91 @@ int binary_read_one_req(reader_t *reader, request_t *req) {
   return 0;
 }
 
+#define READ_COL(type)                                           \
+  for (int i = 0; i < n; i++) {                                  \
+    type v;                                                      \
+    memcpy(&v, start + (size_t)i * item_size, sizeof(type));     \
+    out[i] = (int64_t)v;                                         \
+  }                                                              \
+  break
+
+/**
+ * @brief read one field of n records to out, the same as read_data, the
+ * format is checked once so that each loop is a strided load
+ */
+static void read_col(const char *start, size_t item_size, int n, char format,
+                     int64_t *out) {
+  switch (format) {
+    case 'b':
+    case 'B':
+    case 'c':
+      READ_COL(int8_t);
+    case 'h':
+    case 'H':
+      READ_COL(int16_t);
+    case 'i':
+    case 'l':
+    case 'I':
+    case 'L':
+      READ_COL(int32_t);
+    case 'q':
+    case 'Q':
+      READ_COL(int64_t);
+    case 'f':
+      READ_COL(float);
+    case 'd':
+      READ_COL(double);
+    default:
+      ERROR("DO NOT recognize given format character: %c\n", format);
+      break;
+  }
+}
+
+#undef READ_COL
+
+/* the fields that are not in the trace have the value of a new request */
+static void fill_col(int64_t *out, int n, int64_t v) {
+  for (int i = 0; i < n; i++) {
+    out[i] = v;
+  }
+}
+
+int binary_read_n_req(reader_t *reader, req_batch_t *batch, int n) {
+  binary_params_t *params = (binary_params_t *)reader->reader_params;
+
+  size_t n_left = (reader->file_size - reader->mmap_offset) / reader->item_size;
+  if ((size_t)n > n_left) n = (int)n_left;
+
+  const char *start = reader->mapped_file + reader->mmap_offset;
+  int b = batch->n_req;
+  read_col(start + params->obj_id_offset, reader->item_size, n,
+           params->obj_id_format, (int64_t *)(batch->obj_id + b));
+
+  if (params->time_field_idx > 0) {
+    read_col(start + params->time_offset, reader->item_size, n,
+             params->time_format, batch->clock_time + b);
+  } else {
+    fill_col(batch->clock_time + b, n, 0);
+  }
+
+  if (params->obj_size_field_idx > 0) {
+    read_col(start + params->obj_size_offset, reader->item_size, n,
+             params->obj_size_format, batch->obj_size + b);
+  } else {
+    fill_col(batch->obj_size + b, n, 1);
+  }
+
+  if (params->next_access_vtime_field_idx > 0) {
+    read_col(start + params->next_access_vtime_offset, reader->item_size, n,
+             params->next_access_vtime_format, batch->next_access_vtime + b);
+  } else {
+    fill_col(batch->next_access_vtime + b, n, -2);
+  }
+
+  reader->mmap_offset += (size_t)n * reader->item_size;
+  return n;
+}
+
 #ifdef __cplusplus
 }
 #endif
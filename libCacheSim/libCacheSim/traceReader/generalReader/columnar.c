@@ -0,0 +1,682 @@
+#include "columnar.h"
+
+#include <assert.h>
+#include <sys/mman.h>
+
+#include "../../include/libCacheSim/macro.h"
+#include "readerInternal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the largest dictionary of object sizes in a block */
+#define COLUMNAR_MAX_DICT_SIZE 65536
+
+static inline uint64_t _zigzag(int64_t v) {
+  return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t _unzigzag(uint64_t v) {
+  return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/**************** stream varint ****************/
+/* a value is stored in 1, 2, 4 or 8 bytes, the 2-bit length codes of four
+ * values share a control byte and the control bytes of a column are stored
+ * before the data, so the offset of a value only depends on the control bytes
+ * and the values can be decoded without the byte-by-byte dependency of LEB128
+ *
+ * a decoder loads 8 bytes for every value, which may read past the end of the
+ * column, this is safe because a block is always followed by the block index
+ * and the end magic */
+static const uint64_t svb_mask[4] = {0xffULL, 0xffffULL, 0xffffffffULL,
+                                     UINT64_MAX};
+
+static inline int _svb_code(uint64_t v) {
+  return v < (1ULL << 8) ? 0 : v < (1ULL << 16) ? 1 : v < (1ULL << 32) ? 2 : 3;
+}
+
+static inline size_t _svb_size(const uint64_t *v, uint32_t n) {
+  size_t size = (n + 3) / 4;
+  for (uint32_t k = 0; k < n; k++) {
+    size += 1 << _svb_code(v[k]);
+  }
+  return size;
+}
+
+static uint8_t *_svb_encode(uint8_t *p, const uint64_t *v, uint32_t n) {
+  uint8_t *ctrl = p;
+  uint8_t *data = p + (n + 3) / 4;
+  memset(ctrl, 0, (n + 3) / 4);
+  for (uint32_t k = 0; k < n; k++) {
+    int code = _svb_code(v[k]);
+    ctrl[k >> 2] |= code << ((k & 3) * 2);
+    /* little-endian */
+    memcpy(data, &v[k], 1 << code);
+    data += 1 << code;
+  }
+  return data;
+}
+
+static inline const uint8_t *_svb_decode(const uint8_t *p,
+                                         uint64_t *restrict out, uint32_t n) {
+  const uint8_t *ctrl = p;
+  const uint8_t *data = p + (n + 3) / 4;
+  for (uint32_t k = 0; k < n; k++) {
+    int code = (ctrl[k >> 2] >> ((k & 3) * 2)) & 3;
+    uint64_t w;
+    memcpy(&w, data, sizeof(w));
+    out[k] = w & svb_mask[code];
+    data += 1 << code;
+  }
+  return data;
+}
+
+/* LEB128, only used by the size patches, which are rare */
+static inline uint8_t *_varint_encode(uint8_t *p, uint64_t v) {
+  while (v >= 0x80) {
+    *p++ = (uint8_t)v | 0x80;
+    v >>= 7;
+  }
+  *p++ = (uint8_t)v;
+  return p;
+}
+
+static inline uint64_t _varint_decode(const uint8_t **pp) {
+  const uint8_t *p = *pp;
+  uint64_t x = 0;
+  int shift = 0;
+  do {
+    x |= (uint64_t)(*p & 0x7f) << shift;
+    shift += 7;
+  } while ((*p++ & 0x80) && shift < 64);
+  *pp = p;
+  return x;
+}
+
+/**************** reader ****************/
+int columnar_setup(reader_t *const reader) {
+  if (reader->is_zstd_file) {
+    ERROR("%s: columnar trace cannot be read from a zstd file\n",
+          reader->trace_path);
+  }
+
+  const columnar_trace_header_t *header =
+      (const columnar_trace_header_t *)reader->mapped_file;
+  if (reader->file_size < sizeof(columnar_trace_header_t) + sizeof(uint64_t) ||
+      header->magic != COLUMNAR_TRACE_MAGIC) {
+    ERROR("%s is not a columnar trace\n", reader->trace_path);
+  }
+  if (header->version != COLUMNAR_TRACE_VERSION) {
+    ERROR("%s: unsupported columnar trace version %u\n", reader->trace_path,
+          header->version);
+  }
+  if (header->block_n_req == 0 || header->n_req < 0 ||
+      header->index_offset % sizeof(uint64_t) != 0 ||
+      header->n_block != ((uint64_t)header->n_req + header->block_n_req - 1) /
+                             header->block_n_req ||
+      header->index_offset + (header->n_block + 1) * sizeof(uint64_t) >
+          reader->file_size) {
+    ERROR("%s: columnar trace header is corrupted\n", reader->trace_path);
+  }
+  uint64_t end_magic;
+  memcpy(&end_magic,
+         reader->mapped_file + header->index_offset +
+             header->n_block * sizeof(uint64_t),
+         sizeof(uint64_t));
+  if (end_magic != COLUMNAR_TRACE_MAGIC) {
+    ERROR("%s: columnar trace is truncated\n", reader->trace_path);
+  }
+
+  columnar_params_t *params = malloc(sizeof(columnar_params_t));
+  uint32_t cap = header->block_n_req;
+  params->mapped_file = reader->mapped_file;
+  params->mapped_size = reader->file_size;
+  params->header = header;
+  params->block_offset =
+      (const uint64_t *)(reader->mapped_file + header->index_offset);
+  params->curr_block = -1;
+  params->curr_block_start = 0;
+  params->curr_block_n_req = 0;
+  params->clock_time = malloc(sizeof(int64_t) * cap);
+  /* one spare slot used when decoding */
+  params->obj_id = malloc(sizeof(uint64_t) * (cap + 1));
+  params->obj_size = malloc(sizeof(int64_t) * (cap + 1));
+  params->next_access_vtime = malloc(sizeof(int64_t) * cap);
+  params->stored_id = malloc(sizeof(uint64_t) * cap);
+  params->stored_size = malloc(sizeof(int64_t) * cap);
+  params->size_dict = malloc(sizeof(int64_t) * COLUMNAR_MAX_DICT_SIZE);
+
+  /* the mapping is owned by the params, each clone maps the file itself */
+  reader->mapped_file = NULL;
+  reader->reader_params = params;
+  reader->trace_format = BINARY_TRACE_FORMAT;
+  reader->obj_id_is_num = true;
+  reader->item_size = 1;
+  reader->file_size = header->n_req;
+  reader->trace_start_offset = 0;
+  reader->mmap_offset = 0;
+  reader->n_total_req = header->n_req;
+
+  VERBOSE("columnar trace %s: %ld requests in %lu blocks\n",
+          reader->trace_path, (long)header->n_req,
+          (unsigned long)header->n_block);
+
+  return 0;
+}
+
+/* decode all the columns of a block into the arrays in params */
+static void _columnar_decode_block(columnar_params_t *params, int64_t block) {
+  const columnar_trace_header_t *header = params->header;
+  /* the block and its columns must be between the header and the index,
+   * which columnar_setup checked is in the mapped file */
+  uint64_t offset = params->block_offset[block];
+  if (offset < sizeof(columnar_trace_header_t) ||
+      offset >= params->mapped_size ||
+      offset + sizeof(columnar_block_header_t) > header->index_offset) {
+    ERROR("columnar trace block %ld has a corrupted offset %lu\n", (long)block,
+          (unsigned long)offset);
+  }
+  const uint8_t *p = (const uint8_t *)params->mapped_file + offset;
+  columnar_block_header_t bh;
+  memcpy(&bh, p, sizeof(bh));
+  p += sizeof(bh);
+
+  uint64_t block_end = offset + sizeof(bh);
+  const uint8_t *col[COLUMNAR_N_COL];
+  for (int c = 0; c < COLUMNAR_N_COL; c++) {
+    col[c] = p;
+    p += bh.col_size[c];
+    block_end += bh.col_size[c];
+  }
+  if (bh.n_req > header->block_n_req || bh.n_stored > bh.n_req ||
+      block_end > header->index_offset) {
+    ERROR("columnar trace block %ld is corrupted\n", (long)block);
+  }
+
+  const uint32_t n = bh.n_req;
+  const uint64_t start = (uint64_t)block * header->block_n_req;
+  int64_t *restrict clock_time = params->clock_time;
+  uint64_t *restrict obj_id = params->obj_id;
+  int64_t *restrict obj_size = params->obj_size;
+  int64_t *restrict next_access_vtime = params->next_access_vtime;
+  uint64_t *restrict stored_id = params->stored_id;
+  int64_t *restrict stored_size = params->stored_size;
+
+  /* clock_time and next_access_vtime are decoded in place */
+  _svb_decode(col[COLUMNAR_COL_TIME], (uint64_t *)clock_time, n);
+  int64_t t = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    t += _unzigzag((uint64_t)clock_time[k]);
+    clock_time[k] = t;
+  }
+
+  _svb_decode(col[COLUMNAR_COL_NEXT], (uint64_t *)next_access_vtime, n);
+  for (uint32_t k = 0; k < n; k++) {
+    uint64_t v = (uint64_t)next_access_vtime[k];
+    int64_t vtime = (int64_t)(start + k + 1);
+    next_access_vtime[k] = v == 0 ? INT64_MAX : vtime + _unzigzag(v - 1);
+  }
+
+  const uint8_t *q = col[COLUMNAR_COL_OBJ_ID];
+  switch (bh.id_codec) {
+    case COLUMNAR_ID_RAW:
+      memcpy(stored_id, q, sizeof(uint64_t) * bh.n_stored);
+      break;
+    case COLUMNAR_ID_VARINT:
+      _svb_decode(q, stored_id, bh.n_stored);
+      break;
+    case COLUMNAR_ID_DELTA:;
+      _svb_decode(q, stored_id, bh.n_stored);
+      uint64_t id = 0;
+      for (uint32_t s = 0; s < bh.n_stored; s++) {
+        id += (uint64_t)_unzigzag(stored_id[s]);
+        stored_id[s] = id;
+      }
+      break;
+    default:
+      ERROR("columnar trace block %ld has unknown obj_id codec %d\n",
+            (long)block, bh.id_codec);
+  }
+
+  q = col[COLUMNAR_COL_OBJ_SIZE];
+  if (bh.size_codec == COLUMNAR_SIZE_VARINT) {
+    _svb_decode(q, (uint64_t *)stored_size, bh.n_stored);
+  } else {
+    int64_t *restrict dict = params->size_dict;
+    uint32_t n_dict;
+    memcpy(&n_dict, q, sizeof(n_dict));
+    if (n_dict > COLUMNAR_MAX_DICT_SIZE ||
+        (bh.size_codec == COLUMNAR_SIZE_DICT8 && n_dict > 256)) {
+      ERROR("columnar trace block %ld has a corrupted size dictionary\n",
+            (long)block);
+    }
+    q = _svb_decode(q + sizeof(n_dict), (uint64_t *)dict, n_dict);
+    for (uint32_t d = 1; d < n_dict; d++) {
+      dict[d] += dict[d - 1];
+    }
+    size_t code_size = bh.size_codec == COLUMNAR_SIZE_DICT8 ? 1 : 2;
+    if ((size_t)(q - col[COLUMNAR_COL_OBJ_SIZE]) + code_size * bh.n_stored >
+        bh.col_size[COLUMNAR_COL_OBJ_SIZE]) {
+      ERROR("columnar trace block %ld has a corrupted size column\n",
+            (long)block);
+    }
+    if (bh.size_codec == COLUMNAR_SIZE_DICT8) {
+      for (uint32_t s = 0; s < bh.n_stored; s++) {
+        stored_size[s] = dict[q[s]];
+      }
+    } else {
+      /* the codes follow the varint dictionary, so they are not aligned */
+      for (uint32_t s = 0; s < bh.n_stored; s++) {
+        uint16_t code;
+        memcpy(&code, q + (size_t)s * sizeof(code), sizeof(code));
+        stored_size[s] = dict[code];
+      }
+    }
+  }
+
+  /* fill in the requests in order, a request passes its obj_id and obj_size
+   * to its next access in the block, the selections use masks because the
+   * link bits are random and branches on them are mispredicted half of the
+   * time: a request that is not linked takes the next stored value, and a
+   * request whose next access is not in the block writes to the spare slot n,
+   * only the rare size patches branch */
+  const uint8_t *link = col[COLUMNAR_COL_LINK];
+  q = col[COLUMNAR_COL_SIZE_PATCH];
+  uint32_t n_patch_left = bh.n_size_patch;
+  uint64_t patch_idx = n_patch_left > 0 ? _varint_decode(&q) : UINT64_MAX;
+  uint32_t s = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    uint64_t linked = (link[k >> 3] >> (k & 7)) & 1;
+    uint64_t mask = -linked;
+    uint64_t id = (obj_id[k] & mask) | (stored_id[s] & ~mask);
+    int64_t size = (int64_t)(((uint64_t)obj_size[k] & mask) |
+                             ((uint64_t)stored_size[s] & ~mask));
+    s += linked ^ 1;
+    if (unlikely(k == patch_idx)) {
+      size = (int64_t)_varint_decode(&q);
+      patch_idx = --n_patch_left > 0 ? patch_idx + _varint_decode(&q)
+                                     : UINT64_MAX;
+    }
+    obj_id[k] = id;
+    obj_size[k] = size;
+
+    uint64_t j = (uint64_t)next_access_vtime[k] - 1 - start;
+    uint64_t in_block = (j < n) & (j > k);
+    j = n + ((j - n) & -in_block);
+    obj_id[j] = id;
+    obj_size[j] = size;
+  }
+
+  params->curr_block = block;
+  params->curr_block_start = start;
+  params->curr_block_n_req = n;
+}
+
+int columnar_read_one_req(reader_t *const reader, request_t *const req) {
+  columnar_params_t *params = reader->reader_params;
+
+  while (true) {
+    uint64_t i = reader->mmap_offset;
+    if (i >= (uint64_t)params->header->n_req) {
+      req->valid = false;
+      return 1;
+    }
+
+    if (i - params->curr_block_start >= params->curr_block_n_req) {
+      _columnar_decode_block(params, i / params->header->block_n_req);
+    }
+
+    uint64_t k = i - params->curr_block_start;
+    req->clock_time = params->clock_time[k];
+    req->obj_id = params->obj_id[k];
+    req->obj_size = params->obj_size[k];
+    req->next_access_vtime = params->next_access_vtime[k];
+    reader->mmap_offset = i + 1;
+
+    if (!(req->obj_size == 0 && reader->ignore_size_zero_req &&
+          reader->read_direction == READ_FORWARD)) {
+      return 0;
+    }
+  }
+}
+
+/* copy at most n requests from the decoded blocks to the end of batch, the
+ * requests of size zero are not removed, return the number copied */
+int columnar_read_n_req(reader_t *const reader, req_batch_t *const batch,
+                        const int n) {
+  columnar_params_t *params = reader->reader_params;
+
+  int n_read = 0;
+  while (n_read < n) {
+    uint64_t i = reader->mmap_offset;
+    if (i >= (uint64_t)params->header->n_req) break;
+
+    if (i - params->curr_block_start >= params->curr_block_n_req) {
+      _columnar_decode_block(params, i / params->header->block_n_req);
+    }
+
+    uint64_t k = i - params->curr_block_start;
+    uint64_t m = params->curr_block_n_req - k;
+    if (m > (uint64_t)(n - n_read)) m = n - n_read;
+    int b = batch->n_req + n_read;
+    memcpy(batch->clock_time + b, params->clock_time + k, sizeof(int64_t) * m);
+    memcpy(batch->obj_id + b, params->obj_id + k, sizeof(uint64_t) * m);
+    memcpy(batch->obj_size + b, params->obj_size + k, sizeof(int64_t) * m);
+    memcpy(batch->next_access_vtime + b, params->next_access_vtime + k,
+           sizeof(int64_t) * m);
+    n_read += (int)m;
+    reader->mmap_offset = i + m;
+  }
+
+  return n_read;
+}
+
+void columnar_close(reader_t *const reader) {
+  columnar_params_t *params = reader->reader_params;
+  if (params == NULL) return;
+
+  munmap(params->mapped_file, params->mapped_size);
+  free(params->clock_time);
+  free(params->obj_id);
+  free(params->obj_size);
+  free(params->next_access_vtime);
+  free(params->stored_id);
+  free(params->stored_size);
+  free(params->size_dict);
+}
+
+/**************** writer ****************/
+struct columnar_writer {
+  FILE *ofile;
+  char *ofilepath;
+  columnar_trace_header_t header;
+  uint64_t offset;
+
+  uint64_t *block_offset;
+  uint64_t n_block_alloc;
+
+  /* the requests of the current block */
+  uint32_t n_buffered;
+  int64_t *clock_time;
+  uint64_t *obj_id;
+  int64_t *obj_size;
+  int64_t *next_access_vtime;
+
+  /* used during encoding */
+  int64_t *link_src;
+  uint64_t *stored_id;
+  int64_t *stored_size;
+  uint64_t *val;
+  uint8_t *patch_buf;
+  uint8_t *buf;
+};
+
+/* the worst case of all the columns of a block */
+static inline size_t _columnar_max_block_size(uint32_t block_n_req) {
+  return sizeof(columnar_block_header_t) + (size_t)block_n_req * 64 + 64;
+}
+
+columnar_writer_t *open_columnar_writer(const char *ofilepath,
+                                        uint32_t block_n_req) {
+  if (block_n_req == 0) block_n_req = COLUMNAR_DEFAULT_BLOCK_N_REQ;
+
+  columnar_writer_t *writer = calloc(1, sizeof(columnar_writer_t));
+  writer->ofile = fopen(ofilepath, "wb");
+  if (writer->ofile == NULL) {
+    ERROR("cannot open %s: %s\n", ofilepath, strerror(errno));
+  }
+  writer->ofilepath = strdup(ofilepath);
+
+  writer->header.magic = COLUMNAR_TRACE_MAGIC;
+  writer->header.version = COLUMNAR_TRACE_VERSION;
+  writer->header.block_n_req = block_n_req;
+  /* the header is written again when the writer is closed */
+  fwrite(&writer->header, sizeof(columnar_trace_header_t), 1, writer->ofile);
+  writer->offset = sizeof(columnar_trace_header_t);
+
+  writer->n_block_alloc = 1024;
+  writer->block_offset = malloc(sizeof(uint64_t) * writer->n_block_alloc);
+
+  writer->clock_time = malloc(sizeof(int64_t) * block_n_req);
+  writer->obj_id = malloc(sizeof(uint64_t) * block_n_req);
+  writer->obj_size = malloc(sizeof(int64_t) * block_n_req);
+  writer->next_access_vtime = malloc(sizeof(int64_t) * block_n_req);
+  writer->link_src = malloc(sizeof(int64_t) * block_n_req);
+  writer->stored_id = malloc(sizeof(uint64_t) * block_n_req);
+  writer->stored_size = malloc(sizeof(int64_t) * block_n_req);
+  writer->val = malloc(sizeof(uint64_t) * block_n_req);
+  writer->patch_buf = malloc((size_t)block_n_req * 20);
+  writer->buf = malloc(_columnar_max_block_size(block_n_req));
+
+  return writer;
+}
+
+static int _cmp_int64(const void *a, const void *b) {
+  int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static uint8_t *_encode_obj_id(columnar_writer_t *writer, uint32_t n_stored,
+                               uint8_t *p, columnar_block_header_t *bh) {
+  const uint64_t *stored_id = writer->stored_id;
+  uint64_t *delta = writer->val;
+  for (uint32_t s = 0; s < n_stored; s++) {
+    uint64_t prev = s > 0 ? stored_id[s - 1] : 0;
+    delta[s] = _zigzag((int64_t)(stored_id[s] - prev));
+  }
+
+  size_t raw_size = (size_t)n_stored * sizeof(uint64_t);
+  size_t varint_size = _svb_size(stored_id, n_stored);
+  size_t delta_size = _svb_size(delta, n_stored);
+  if (raw_size <= varint_size && raw_size <= delta_size) {
+    bh->id_codec = COLUMNAR_ID_RAW;
+    memcpy(p, stored_id, raw_size);
+    return p + raw_size;
+  } else if (varint_size <= delta_size) {
+    bh->id_codec = COLUMNAR_ID_VARINT;
+    return _svb_encode(p, stored_id, n_stored);
+  } else {
+    bh->id_codec = COLUMNAR_ID_DELTA;
+    return _svb_encode(p, delta, n_stored);
+  }
+}
+
+static uint8_t *_encode_obj_size(columnar_writer_t *writer, uint32_t n_stored,
+                                 uint8_t *p, columnar_block_header_t *bh) {
+  const int64_t *stored_size = writer->stored_size;
+  size_t varint_size = _svb_size((const uint64_t *)stored_size, n_stored);
+
+  int64_t *dict = (int64_t *)writer->val;
+  memcpy(dict, stored_size, sizeof(int64_t) * n_stored);
+  qsort(dict, n_stored, sizeof(int64_t), _cmp_int64);
+  uint32_t n_dict = 0;
+  for (uint32_t s = 0; s < n_stored; s++) {
+    if (n_dict == 0 || dict[n_dict - 1] != dict[s]) dict[n_dict++] = dict[s];
+  }
+
+  int code_size = n_dict <= 256 ? 1 : 2;
+  /* an upper bound of the size of the dictionary */
+  size_t dict_size = sizeof(n_dict) + (size_t)n_dict * 9;
+  if (n_dict > COLUMNAR_MAX_DICT_SIZE ||
+      dict_size + (size_t)code_size * n_stored >= varint_size) {
+    bh->size_codec = COLUMNAR_SIZE_VARINT;
+    return _svb_encode(p, (const uint64_t *)stored_size, n_stored);
+  }
+
+  bh->size_codec = code_size == 1 ? COLUMNAR_SIZE_DICT8 : COLUMNAR_SIZE_DICT16;
+  memcpy(p, &n_dict, sizeof(n_dict));
+  p += sizeof(n_dict);
+  /* the dictionary is sorted and stored as deltas, the codes are found before
+   * the dictionary is overwritten */
+  uint8_t *code = p + (n_dict + 3) / 4 + (size_t)n_dict * 8;
+  for (uint32_t s = 0; s < n_stored; s++) {
+    const int64_t *found = bsearch(&stored_size[s], dict, n_dict,
+                                   sizeof(int64_t), _cmp_int64);
+    uint16_t c = (uint16_t)(found - dict);
+    memcpy(code + (size_t)s * code_size, &c, code_size);
+  }
+  for (uint32_t d = n_dict - 1; d > 0; d--) {
+    dict[d] -= dict[d - 1];
+  }
+  uint8_t *dict_end = _svb_encode(p, (const uint64_t *)dict, n_dict);
+  memmove(dict_end, code, (size_t)code_size * n_stored);
+  return dict_end + (size_t)code_size * n_stored;
+}
+
+static void _columnar_write_block(columnar_writer_t *writer) {
+  const uint32_t n = writer->n_buffered;
+  const uint64_t start = (uint64_t)writer->header.n_req;
+  if (n == 0) return;
+
+  columnar_block_header_t bh;
+  memset(&bh, 0, sizeof(bh));
+  bh.n_req = n;
+
+  /* find the links the same way as the decoder: the last request in the
+   * block whose next access is request j passes its obj_id to j */
+  for (uint32_t k = 0; k < n; k++) writer->link_src[k] = -1;
+  for (uint32_t k = 0; k < n; k++) {
+    uint64_t j = (uint64_t)writer->next_access_vtime[k] - 1 - start;
+    if (j < n && j > k) writer->link_src[j] = k;
+  }
+
+  uint8_t *const col_start = writer->buf + sizeof(columnar_block_header_t);
+  uint8_t *p = col_start, *col_end = col_start;
+#define COL_DONE(c)                  \
+  do {                               \
+    bh.col_size[c] = p - col_end;    \
+    col_end = p;                     \
+  } while (0)
+
+  for (uint32_t k = 0; k < n; k++) {
+    int64_t prev_time = k > 0 ? writer->clock_time[k - 1] : 0;
+    writer->val[k] = _zigzag(writer->clock_time[k] - prev_time);
+  }
+  p = _svb_encode(p, writer->val, n);
+  COL_DONE(COLUMNAR_COL_TIME);
+
+  uint8_t *link = p;
+  memset(link, 0, (n + 7) / 8);
+  p += (n + 7) / 8;
+  COL_DONE(COLUMNAR_COL_LINK);
+
+  uint8_t *patch = writer->patch_buf;
+  uint64_t prev_patch_idx = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    int64_t src = writer->link_src[k];
+    if (src >= 0 && writer->obj_id[src] == writer->obj_id[k]) {
+      link[k >> 3] |= 1 << (k & 7);
+      if (writer->obj_size[src] != writer->obj_size[k]) {
+        patch = _varint_encode(patch, k - prev_patch_idx);
+        patch = _varint_encode(patch, (uint64_t)writer->obj_size[k]);
+        prev_patch_idx = k;
+        bh.n_size_patch++;
+      }
+    } else {
+      writer->stored_id[bh.n_stored] = writer->obj_id[k];
+      writer->stored_size[bh.n_stored] = writer->obj_size[k];
+      bh.n_stored++;
+    }
+  }
+
+  p = _encode_obj_id(writer, bh.n_stored, p, &bh);
+  COL_DONE(COLUMNAR_COL_OBJ_ID);
+
+  p = _encode_obj_size(writer, bh.n_stored, p, &bh);
+  COL_DONE(COLUMNAR_COL_OBJ_SIZE);
+
+  memcpy(p, writer->patch_buf, patch - writer->patch_buf);
+  p += patch - writer->patch_buf;
+  COL_DONE(COLUMNAR_COL_SIZE_PATCH);
+
+  for (uint32_t k = 0; k < n; k++) {
+    int64_t next = writer->next_access_vtime[k];
+    int64_t vtime = (int64_t)(start + k + 1);
+    writer->val[k] = next == INT64_MAX ? 0 : _zigzag(next - vtime) + 1;
+  }
+  p = _svb_encode(p, writer->val, n);
+  COL_DONE(COLUMNAR_COL_NEXT);
+#undef COL_DONE
+
+  assert((size_t)(p - writer->buf) <=
+         _columnar_max_block_size(writer->header.block_n_req));
+  memcpy(writer->buf, &bh, sizeof(bh));
+  size_t block_size = p - writer->buf;
+  if (fwrite(writer->buf, 1, block_size, writer->ofile) != block_size) {
+    ERROR("cannot write %s: %s\n", writer->ofilepath, strerror(errno));
+  }
+
+  if (writer->header.n_block == writer->n_block_alloc) {
+    writer->n_block_alloc *= 2;
+    writer->block_offset = realloc(writer->block_offset,
+                                   sizeof(uint64_t) * writer->n_block_alloc);
+  }
+  writer->block_offset[writer->header.n_block++] = writer->offset;
+  writer->offset += block_size;
+  writer->header.n_req += n;
+  writer->n_buffered = 0;
+}
+
+void columnar_writer_append(columnar_writer_t *writer, int64_t clock_time,
+                            uint64_t obj_id, int64_t obj_size,
+                            int64_t next_access_vtime) {
+  uint32_t k = writer->n_buffered++;
+  writer->clock_time[k] = clock_time;
+  writer->obj_id[k] = obj_id;
+  writer->obj_size[k] = obj_size;
+  writer->next_access_vtime[k] =
+      next_access_vtime == -1 ? INT64_MAX : next_access_vtime;
+
+  if (writer->n_buffered == writer->header.block_n_req) {
+    _columnar_write_block(writer);
+  }
+}
+
+uint64_t close_columnar_writer(columnar_writer_t *writer, int64_t n_obj,
+                               int64_t n_req_byte, int64_t n_obj_byte) {
+  _columnar_write_block(writer);
+
+  /* the block index is 8-byte aligned */
+  uint64_t end_magic = COLUMNAR_TRACE_MAGIC, zero = 0;
+  size_t padding = (8 - writer->offset % 8) % 8;
+  fwrite(&zero, 1, padding, writer->ofile);
+  writer->offset += padding;
+  writer->header.index_offset = writer->offset;
+  writer->header.n_obj = n_obj;
+  writer->header.n_req_byte = n_req_byte;
+  writer->header.n_obj_byte = n_obj_byte;
+  if (fwrite(writer->block_offset, sizeof(uint64_t), writer->header.n_block,
+             writer->ofile) != writer->header.n_block ||
+      fwrite(&end_magic, sizeof(uint64_t), 1, writer->ofile) != 1 ||
+      fseek(writer->ofile, 0, SEEK_SET) != 0 ||
+      fwrite(&writer->header, sizeof(columnar_trace_header_t), 1,
+             writer->ofile) != 1) {
+    ERROR("cannot write %s: %s\n", writer->ofilepath, strerror(errno));
+  }
+  fclose(writer->ofile);
+
+  uint64_t trace_size =
+      writer->offset + (writer->header.n_block + 1) * sizeof(uint64_t);
+
+  free(writer->block_offset);
+  free(writer->clock_time);
+  free(writer->obj_id);
+  free(writer->obj_size);
+  free(writer->next_access_vtime);
+  free(writer->link_src);
+  free(writer->stored_id);
+  free(writer->stored_size);
+  free(writer->val);
+  free(writer->patch_buf);
+  free(writer->buf);
+  free(writer->ofilepath);
+  free(writer);
+
+  return trace_size;
+}
+
+#ifdef __cplusplus
+}
+#endif
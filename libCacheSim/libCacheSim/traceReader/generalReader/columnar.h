@@ -0,0 +1,172 @@
+#pragma once
+/**
+ * columnar trace, a compressed form of the oracleGeneral trace
+ *
+ * the requests are stored in blocks of block_n_req requests, each block
+ * stores the fields in columns and every column uses an encoding that suits
+ * the field, so the trace is several times smaller than oracleGeneral and a
+ * whole block is decoded at a time with tight loops
+ *
+ *    header (128 bytes)
+ *    block 0, block 1, ... block n_block - 1
+ *    block index, the offset of each block (uint64_t * n_block)
+ *    end magic (uint64_t)
+ *
+ * every block except the last one has block_n_req requests, so request i is
+ * in block i / block_n_req and the reader can move to any request by
+ * decoding one block
+ *
+ * a block has a 40-byte block header followed by the columns, "varint" in a
+ * column is a stream varint: a value takes 1, 2, 4 or 8 bytes, the 2-bit
+ * length codes of all values are packed in control bytes stored before the
+ * data, so the decoder does not have a byte-by-byte dependency
+ *    time      zigzag varint of the delta from the previous request
+ *    link      a bitmap, bit k is set if request k has the same obj_id as the
+ *              last request in the block whose next_access_vtime points to k,
+ *              the obj_id and obj_size of these requests are not stored
+ *    obj_id    the obj_id of the requests that are not linked, raw, varint,
+ *              or zigzag varint of the delta from the previous stored obj_id,
+ *              whichever is smallest
+ *    obj_size  the obj_size of the requests that are not linked, coded using
+ *              a per-block dictionary (uint32_t count and the varint deltas
+ *              of the sorted sizes) followed by 8- or 16-bit codes, or varint
+ *              if it is smaller or there are too many distinct sizes
+ *    size patch  (index delta, size) LEB128 pairs for the linked requests
+ *              whose size differs from the request that links to them
+ *    next      0 if the object is not requested again, otherwise zigzag
+ *              varint of next_access_vtime - vtime plus 1, vtime is the
+ *              reference count of the request (starts with 1)
+ *
+ * the reader uses BINARY_TRACE_FORMAT with a one-byte item per request and
+ * mmap_offset as the index of the next request (like the synthetic reader),
+ * the file is mapped by the reader params
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "../../include/libCacheSim/reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* "columnar" in ASCII */
+#define COLUMNAR_TRACE_MAGIC 0x636f6c756d6e6172ULL
+#define COLUMNAR_TRACE_VERSION 1
+#define COLUMNAR_DEFAULT_BLOCK_N_REQ (1 << 16)
+
+typedef enum {
+  COLUMNAR_COL_TIME,
+  COLUMNAR_COL_LINK,
+  COLUMNAR_COL_OBJ_ID,
+  COLUMNAR_COL_OBJ_SIZE,
+  COLUMNAR_COL_SIZE_PATCH,
+  COLUMNAR_COL_NEXT,
+
+  COLUMNAR_N_COL
+} columnar_col_e;
+
+typedef enum {
+  COLUMNAR_ID_RAW,
+  COLUMNAR_ID_VARINT,
+  COLUMNAR_ID_DELTA,
+} columnar_id_codec_e;
+
+typedef enum {
+  COLUMNAR_SIZE_DICT8,
+  COLUMNAR_SIZE_DICT16,
+  COLUMNAR_SIZE_VARINT,
+} columnar_size_codec_e;
+
+// 128 bytes
+typedef struct columnar_trace_header {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t block_n_req;
+  uint64_t n_block;
+  /* the offset of the block index */
+  uint64_t index_offset;
+
+  /* trace stat */
+  int64_t n_req;
+  int64_t n_obj;
+  int64_t n_req_byte;
+  int64_t n_obj_byte;
+
+  uint64_t reserved[8];
+} columnar_trace_header_t;
+
+// 40 bytes
+typedef struct columnar_block_header {
+  uint32_t n_req;
+  /* the number of requests that are not linked */
+  uint32_t n_stored;
+  uint32_t n_size_patch;
+  uint8_t id_codec;
+  uint8_t size_codec;
+  uint16_t reserved;
+  /* the number of bytes of each column */
+  uint32_t col_size[COLUMNAR_N_COL];
+} columnar_block_header_t;
+
+typedef struct {
+  char *mapped_file;
+  size_t mapped_size;
+  const columnar_trace_header_t *header;
+  const uint64_t *block_offset;
+
+  /* the decoded block, -1 if no block is decoded */
+  int64_t curr_block;
+  uint64_t curr_block_start;
+  uint32_t curr_block_n_req;
+
+  int64_t *clock_time;
+  uint64_t *obj_id;
+  int64_t *obj_size;
+  int64_t *next_access_vtime;
+
+  /* used during decoding */
+  uint64_t *stored_id;
+  int64_t *stored_size;
+  int64_t *size_dict;
+} columnar_params_t;
+
+int columnar_setup(reader_t *reader);
+
+int columnar_read_one_req(reader_t *reader, request_t *req);
+
+int columnar_read_n_req(reader_t *reader, req_batch_t *batch, int n);
+
+void columnar_close(reader_t *reader);
+
+/**************** writer ****************/
+typedef struct columnar_writer columnar_writer_t;
+
+/**
+ * @brief create a columnar trace at ofilepath, the requests are appended in
+ * trace order, next_access_vtime is -1 or INT64_MAX if the object is not
+ * requested again
+ *
+ * @param block_n_req the number of requests in each block, 0 uses the default
+ */
+columnar_writer_t *open_columnar_writer(const char *ofilepath,
+                                        uint32_t block_n_req);
+
+void columnar_writer_append(columnar_writer_t *writer, int64_t clock_time,
+                            uint64_t obj_id, int64_t obj_size,
+                            int64_t next_access_vtime);
+
+/**
+ * @brief write the last block, the index and the header with the trace stat,
+ * and free the writer
+ *
+ * @return the size of the trace in bytes
+ */
+uint64_t close_columnar_writer(columnar_writer_t *writer, int64_t n_obj,
+                               int64_t n_req_byte, int64_t n_obj_byte);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,7 +11,6 @@
 #include <stdlib.h>
 
 #include "../../../libCacheSim/include/libCacheSim/macro.h"
-#include "../../dataStructure/hash/hash.h"
 #include "libcsv.h"
 #include "readerInternal.h"
 
@@ -203,8 +202,7 @@ static inline void csv_cb1(void *s, size_t len, void *data) {
         WARN("object id is not numeric %s\n", (char *)s);
       }
     } else {
-      // req->obj_id = (uint64_t)g_quark_from_string(s);
-      req->obj_id = (uint64_t)get_hash_value_str((char *)s, len);
+      req->obj_id = str_to_obj_id(reader, (char *)s, len);
     }
   } else if (csv_params->curr_field_idx == csv_params->time_field_idx) {
     // this does not work, because s is not null terminated
@@ -15,6 +15,14 @@ extern "C" {
 /**************** common ****************/
 bool is_str_num(const char *str);
 
+/**
+ * hash a string object id of len bytes (not null terminated) into obj_id
+ * with xxh3, the obj_id only depends on the string, so readers in different
+ * threads do not share any state, the strings are recorded and checked for
+ * collisions if the reader is opened with audit_str_obj_id
+ */
+obj_id_t str_to_obj_id(reader_t *reader, const char *str, size_t len);
+
 /**************** csv ****************/
 typedef struct {
   struct csv_parser *csv_parser;
@@ -113,6 +121,10 @@ int binaryReader_setup(reader_t *const reader);
 
 int binary_read_one_req(reader_t *reader, request_t *req);
 
+/* decode at most n requests of an uncompressed trace to the end of batch,
+ * return the number decoded */
+int binary_read_n_req(reader_t *reader, req_batch_t *batch, int n);
+
 #ifdef __cplusplus
 }
 #endif
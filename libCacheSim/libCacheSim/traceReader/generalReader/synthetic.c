@@ -0,0 +1,270 @@
+#include "synthetic.h"
+
+#include <math.h>
+#include <strings.h>
+
+#include "readerInternal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the obj_id of the objects in scans, each scan request has a new object */
+#define SYN_SCAN_ID_BASE (1ULL << 62)
+
+/* independent random streams */
+#define SYN_STREAM_REQ 0
+#define SYN_STREAM_SCAN 1
+#define SYN_STREAM_PHASE 2
+
+static const char *pattern_names[N_SYN_PATTERN] = {"zipf", "uniform", "scan",
+                                                   "loop", "mixed"};
+
+/**************** counter-based random numbers ****************/
+static inline uint64_t _syn_mix(uint64_t x) {
+  /* the finalizer of splitmix64 */
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/* the k-th random number of item i in a stream */
+static inline uint64_t _syn_rand(const synthetic_params_t *params, int stream,
+                                 uint64_t i, uint64_t k) {
+  uint64_t x = _syn_mix(params->seed ^ ((uint64_t)stream << 56) ^ i);
+  return _syn_mix(x + (k + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+/* uniform in [0, 1) */
+static inline double _syn_rand_double(const synthetic_params_t *params,
+                                      int stream, uint64_t i, uint64_t k) {
+  return (double)(_syn_rand(params, stream, i, k) >> 11) * 0x1.0p-53;
+}
+
+/* uniform in [0, n) */
+static inline uint64_t _syn_rand_below(const synthetic_params_t *params,
+                                       int stream, uint64_t i, uint64_t k,
+                                       uint64_t n) {
+  return (uint64_t)(((unsigned __int128)_syn_rand(params, stream, i, k) * n) >>
+                    64);
+}
+
+/**************** rejection-inversion Zipf sampling ****************/
+/* log1p(x) / x and expm1(x) / x, accurate near 0 */
+static inline double _zipf_helper1(double x) {
+  if (fabs(x) > 1e-8) return log1p(x) / x;
+  return 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+static inline double _zipf_helper2(double x) {
+  if (fabs(x) > 1e-8) return expm1(x) / x;
+  return 1 + x * 0.5 * (1 + x * 1.0 / 3 * (1 + 0.25 * x));
+}
+
+static inline double _zipf_h(double alpha, double x) {
+  return exp(-alpha * log(x));
+}
+
+/* the integral of h, well-defined for alpha == 1 */
+static inline double _zipf_h_integral(double alpha, double x) {
+  double log_x = log(x);
+  return _zipf_helper2((1 - alpha) * log_x) * log_x;
+}
+
+static inline double _zipf_h_integral_inverse(double alpha, double x) {
+  double t = x * (1 - alpha);
+  if (t < -1) t = -1;
+  return exp(_zipf_helper1(t) * x);
+}
+
+static void _zipf_init(synthetic_params_t *params) {
+  double alpha = params->alpha;
+  params->zipf_h_integral_x1 = _zipf_h_integral(alpha, 1.5) - 1;
+  params->zipf_h_integral_n =
+      _zipf_h_integral(alpha, (double)params->n_obj + 0.5);
+  params->zipf_s = 2 - _zipf_h_integral_inverse(
+                           alpha, _zipf_h_integral(alpha, 2.5) -
+                                      _zipf_h(alpha, 2));
+}
+
+/* the rank (starting from 0) of the object requested by request i */
+static inline uint64_t _syn_zipf(const synthetic_params_t *params,
+                                 uint64_t i) {
+  if (params->alpha <= 0)
+    return _syn_rand_below(params, SYN_STREAM_REQ, i, 0, params->n_obj);
+
+  double alpha = params->alpha;
+  for (uint64_t k = 0;; k++) {
+    double u = params->zipf_h_integral_n +
+               _syn_rand_double(params, SYN_STREAM_REQ, i, k) *
+                   (params->zipf_h_integral_x1 - params->zipf_h_integral_n);
+    double x = _zipf_h_integral_inverse(alpha, u);
+    uint64_t rank = (uint64_t)(x + 0.5);
+    if (rank < 1) {
+      rank = 1;
+    } else if (rank > params->n_obj) {
+      rank = params->n_obj;
+    }
+    if ((double)rank - x <= params->zipf_s ||
+        u >= _zipf_h_integral(alpha, (double)rank + 0.5) -
+                 _zipf_h(alpha, (double)rank)) {
+      return rank - 1;
+    }
+  }
+}
+
+/**************** patterns ****************/
+static inline uint64_t _syn_obj_id(const synthetic_params_t *params,
+                                   synthetic_pattern_e pattern, uint64_t base,
+                                   uint64_t i) {
+  switch (pattern) {
+    case SYN_ZIPF:
+      return base + _syn_zipf(params, i);
+    case SYN_UNIFORM:
+      return base +
+             _syn_rand_below(params, SYN_STREAM_REQ, i, 0, params->n_obj);
+    case SYN_LOOP:
+      return base + i % params->n_obj;
+    case SYN_SCAN:
+      if (_syn_rand_double(params, SYN_STREAM_SCAN, i / params->scan_len, 0) <
+          params->scan_frac) {
+        return SYN_SCAN_ID_BASE + i;
+      }
+      return base + _syn_zipf(params, i);
+    default:
+      ERROR("unknown synthetic pattern %d\n", pattern);
+      abort();
+  }
+}
+
+uint64_t synthetic_obj_id(const synthetic_params_t *params, uint64_t i) {
+  if (params->pattern != SYN_MIXED) {
+    return _syn_obj_id(params, params->pattern, 0, i);
+  }
+
+  uint64_t phase = i / params->phase_len;
+  synthetic_pattern_e pattern = (synthetic_pattern_e)_syn_rand_below(
+      params, SYN_STREAM_PHASE, phase, 0, SYN_MIXED);
+  return _syn_obj_id(params, pattern, phase * (params->n_obj / 2), i);
+}
+
+/**************** reader ****************/
+static void _synthetic_parse_spec(const char *spec,
+                                  synthetic_params_t *params) {
+  params->pattern = N_SYN_PATTERN;
+  params->n_obj = 1000000;
+  params->n_req = 10000000;
+  params->alpha = 1.0;
+  params->seed = 0;
+  params->obj_size = 1;
+  params->req_rate = 1000;
+  params->scan_frac = 0.2;
+  params->scan_len = 10000;
+  params->phase_len = 0;
+
+  char *spec_str = strdup(spec);
+  char *params_str = spec_str;
+  char *pattern_str = strsep(&params_str, ":");
+  for (int p = 0; p < N_SYN_PATTERN; p++) {
+    if (strcasecmp(pattern_str, pattern_names[p]) == 0) {
+      params->pattern = (synthetic_pattern_e)p;
+    }
+  }
+  if (params->pattern == N_SYN_PATTERN) {
+    ERROR(
+        "unknown synthetic trace pattern \"%s\", "
+        "supported: zipf, uniform, scan, loop, mixed\n",
+        pattern_str);
+  }
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    char *key = strsep(&params_str, "=");
+    char *value = strsep(&params_str, ",");
+    char *end;
+    if (value == NULL) {
+      ERROR("synthetic trace parameter %s has no value\n", key);
+    }
+    for (char *c = key; *c != '\0'; c++) {
+      if (*c == '-') *c = '_';
+    }
+
+    if (strcasecmp(key, "n_obj") == 0) {
+      params->n_obj = strtoull(value, &end, 0);
+    } else if (strcasecmp(key, "n_req") == 0) {
+      params->n_req = strtoull(value, &end, 0);
+    } else if (strcasecmp(key, "alpha") == 0) {
+      params->alpha = strtod(value, &end);
+    } else if (strcasecmp(key, "seed") == 0) {
+      params->seed = strtoull(value, &end, 0);
+    } else if (strcasecmp(key, "obj_size") == 0) {
+      params->obj_size = strtoll(value, &end, 0);
+    } else if (strcasecmp(key, "req_rate") == 0) {
+      params->req_rate = strtod(value, &end);
+    } else if (strcasecmp(key, "scan_frac") == 0) {
+      params->scan_frac = strtod(value, &end);
+    } else if (strcasecmp(key, "scan_len") == 0) {
+      params->scan_len = strtoull(value, &end, 0);
+    } else if (strcasecmp(key, "phase_len") == 0) {
+      params->phase_len = strtoull(value, &end, 0);
+    } else {
+      ERROR("synthetic trace does not support parameter %s\n", key);
+    }
+    if (*end != '\0') {
+      ERROR("synthetic trace parameter parsing error, \"%s\" after number\n",
+            end);
+    }
+  }
+  free(spec_str);
+
+  if (params->n_obj == 0 || params->n_req == 0 || params->scan_len == 0 ||
+      params->obj_size <= 0 || params->req_rate <= 0) {
+    ERROR("synthetic trace: n_obj, n_req, scan_len, obj_size and req_rate "
+          "must be positive\n");
+  }
+  if (params->phase_len == 0) {
+    params->phase_len = params->n_req / 10 > 0 ? params->n_req / 10 : 1;
+  }
+}
+
+int synthetic_setup(reader_t *const reader) {
+  synthetic_params_t *params = malloc(sizeof(synthetic_params_t));
+  _synthetic_parse_spec(reader->trace_path, params);
+  _zipf_init(params);
+
+  reader->reader_params = params;
+  reader->trace_format = BINARY_TRACE_FORMAT;
+  reader->obj_id_is_num = true;
+  reader->item_size = 1;
+  reader->file_size = params->n_req;
+  reader->trace_start_offset = 0;
+  reader->mmap_offset = 0;
+  reader->n_total_req = params->n_req;
+
+  VERBOSE("synthetic trace %s: %lu objects, %lu requests, seed %lu\n",
+          pattern_names[params->pattern], (unsigned long)params->n_obj,
+          (unsigned long)params->n_req, (unsigned long)params->seed);
+
+  return 0;
+}
+
+int synthetic_read_one_req(reader_t *const reader, request_t *const req) {
+  const synthetic_params_t *params = reader->reader_params;
+  uint64_t i = reader->mmap_offset;
+  if (i >= params->n_req) {
+    req->valid = false;
+    return 1;
+  }
+
+  req->obj_id = synthetic_obj_id(params, i);
+  req->obj_size = params->obj_size;
+  req->clock_time = (int64_t)((double)i / params->req_rate);
+  req->op = OP_GET;
+  req->next_access_vtime = -2;
+  reader->mmap_offset = i + 1;
+
+  return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
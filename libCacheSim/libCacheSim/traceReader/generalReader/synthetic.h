@@ -0,0 +1,86 @@
+#pragma once
+/**
+ * a reader that generates the requests on the fly instead of reading a file,
+ * the trace path is the spec of the workload
+ *    <pattern>[:key=value,key=value...]
+ * e.g., "zipf:n_obj=1000000,alpha=0.8,n_req=100000000,seed=42"
+ *
+ * pattern
+ *    zipf      obj_id follows a Zipf(alpha) distribution over [0, n_obj)
+ *    uniform   obj_id is uniform over [0, n_obj)
+ *    scan      zipf requests mixed with sequential scans of scan_len objects
+ *              that are never requested again, scan_frac of the requests are
+ *              in scans
+ *    loop      obj_id loops over [0, n_obj)
+ *    mixed     the pattern changes every phase_len requests, each phase uses
+ *              one of the patterns above on an object range that shares half
+ *              of the objects with the previous phase
+ *
+ * keys (- and _ are interchangeable)
+ *    n_obj (1000000), n_req (10000000), alpha (1.0), seed (0), obj_size (1),
+ *    req_rate (1000, requests per second of trace time),
+ *    scan_frac (0.2), scan_len (10000), phase_len (n_req / 10)
+ *
+ * request i is a pure function of (seed, i): the random numbers come from a
+ * counter-based generator and Zipf samples use rejection-inversion (Hormann
+ * and Derflinger), which needs no table, so the same seed always generates
+ * the same trace, and a reader can be cloned or moved to any request in O(1)
+ * using clone_reader, skip_n_req, reader_set_read_pos or reader_set_pos
+ *
+ * the reader uses BINARY_TRACE_FORMAT with a one-byte item per request and
+ * mmap_offset as the index of the next request, there is no mapped file
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "../../include/libCacheSim/reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  SYN_ZIPF,
+  SYN_UNIFORM,
+  SYN_SCAN,
+  SYN_LOOP,
+  SYN_MIXED,
+
+  N_SYN_PATTERN
+} synthetic_pattern_e;
+
+typedef struct {
+  synthetic_pattern_e pattern;
+  uint64_t n_obj;
+  uint64_t n_req;
+  double alpha;
+  uint64_t seed;
+  int64_t obj_size;
+  double req_rate;
+  double scan_frac;
+  uint64_t scan_len;
+  uint64_t phase_len;
+
+  /* precomputed for rejection-inversion sampling */
+  double zipf_h_integral_x1;
+  double zipf_h_integral_n;
+  double zipf_s;
+} synthetic_params_t;
+
+/**
+ * @brief parse the spec, fill in the params of the reader and set it up as a
+ * seekable trace of n_req requests
+ */
+int synthetic_setup(reader_t *reader);
+
+int synthetic_read_one_req(reader_t *reader, request_t *req);
+
+/**
+ * @brief the obj_id of request i, this does not touch the reader
+ */
+uint64_t synthetic_obj_id(const synthetic_params_t *params, uint64_t i);
+
+#ifdef __cplusplus
+}
+#endif
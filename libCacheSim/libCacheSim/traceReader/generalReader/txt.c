@@ -30,10 +30,11 @@ int txt_read_one_req(reader_t *const reader, request_t *const req) {
             read_size);
     }
   } else {
-    if (reader->line_buf[read_size - 1] == '\n') {
-      reader->line_buf[read_size - 1] = 0;
+    size_t len = (size_t)read_size;
+    if (reader->line_buf[len - 1] == '\n') {
+      reader->line_buf[--len] = 0;
     }
-    req->obj_id = (uint64_t)g_quark_from_string(reader->line_buf);
+    req->obj_id = str_to_obj_id(reader, reader->line_buf, len);
   }
   
   // Set a default object size of 4KB if not specified in the trace
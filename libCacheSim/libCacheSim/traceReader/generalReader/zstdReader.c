@@ -8,13 +8,425 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>  // strerror
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <zstd.h>
 
 #include "../../include/libCacheSim/logging.h"
 
 #define LINE_DELIM '\n'
 
+/* the number of decoder threads of a trace with multiple frames, every
+ * reader (including clones) has its own threads and 2 * n_thread frame
+ * buffers, so they are opt-in */
+static int zstd_reader_n_thread = 0;
+
+void set_zstd_reader_n_thread(int n_thread) {
+  zstd_reader_n_thread = n_thread < 0 ? 0 : n_thread;
+}
+
+/**************** frame index ****************/
+static void _free_frame_index(zstd_frame_index_t *index) {
+  if (index == NULL) return;
+  free(index->comp_offset);
+  free(index->comp_size);
+  free(index->decomp_size);
+  free(index->decomp_offset);
+  free(index);
+}
+
+static zstd_frame_index_t *_new_frame_index(uint64_t n_frame) {
+  zstd_frame_index_t *index = calloc(1, sizeof(zstd_frame_index_t));
+  uint64_t capacity = n_frame > 0 ? n_frame : 1;
+  index->comp_offset = malloc(sizeof(uint64_t) * capacity);
+  index->comp_size = malloc(sizeof(uint64_t) * capacity);
+  index->decomp_size = malloc(sizeof(uint64_t) * capacity);
+  index->n_frame = n_frame;
+  return index;
+}
+
+/* compute the offset of the frames in the decompressed data once all the
+ * sizes are known */
+static void _finish_frame_index(zstd_frame_index_t *index) {
+  index->complete = true;
+  index->max_decomp_size = 0;
+  for (uint64_t i = 0; i < index->n_frame; i++) {
+    if (index->decomp_size[i] == UINT64_MAX) {
+      index->complete = false;
+      return;
+    }
+    if (index->decomp_size[i] > index->max_decomp_size)
+      index->max_decomp_size = index->decomp_size[i];
+  }
+
+  free(index->decomp_offset);
+  index->decomp_offset = malloc(sizeof(uint64_t) * (index->n_frame + 1));
+  index->decomp_offset[0] = 0;
+  for (uint64_t i = 0; i < index->n_frame; i++) {
+    index->decomp_offset[i + 1] =
+        index->decomp_offset[i] + index->decomp_size[i];
+  }
+}
+
+/* walk the frame headers of the mapped trace */
+static zstd_frame_index_t *_scan_frames(const zstd_reader *reader) {
+  uint64_t capacity = 64;
+  zstd_frame_index_t *index = _new_frame_index(capacity);
+  index->n_frame = 0;
+
+  size_t offset = 0;
+  while (offset < reader->file_size) {
+    const char *src = reader->mapped_file + offset;
+    size_t comp_size =
+        ZSTD_findFrameCompressedSize(src, reader->file_size - offset);
+    if (ZSTD_isError(comp_size)) {
+      WARN("cannot index zstd trace %s at offset %zu: %s\n",
+           reader->trace_path, offset, ZSTD_getErrorName(comp_size));
+      _free_frame_index(index);
+      return NULL;
+    }
+    unsigned long long content_size = ZSTD_getFrameContentSize(src, comp_size);
+    if (content_size == ZSTD_CONTENTSIZE_ERROR) {
+      WARN("cannot index zstd trace %s at offset %zu\n", reader->trace_path,
+           offset);
+      _free_frame_index(index);
+      return NULL;
+    }
+
+    /* skippable frames (e.g., the seek table of the seekable format) and
+     * empty frames have no data */
+    if (content_size != 0) {
+      if (index->n_frame == capacity) {
+        capacity *= 2;
+        index->comp_offset =
+            realloc(index->comp_offset, sizeof(uint64_t) * capacity);
+        index->comp_size = realloc(index->comp_size, sizeof(uint64_t) * capacity);
+        index->decomp_size =
+            realloc(index->decomp_size, sizeof(uint64_t) * capacity);
+      }
+      index->comp_offset[index->n_frame] = offset;
+      index->comp_size[index->n_frame] = comp_size;
+      index->decomp_size[index->n_frame] =
+          content_size == ZSTD_CONTENTSIZE_UNKNOWN ? UINT64_MAX : content_size;
+      index->n_frame++;
+    }
+    offset += comp_size;
+  }
+
+  _finish_frame_index(index);
+  return index;
+}
+
+static char *_frame_index_path(const char *trace_path) {
+  size_t len = strlen(trace_path) + 6;
+  char *path = malloc(len);
+  snprintf(path, len, "%s.fidx", trace_path);
+  return path;
+}
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t file_size;
+  int64_t file_mtime;
+  uint64_t n_frame;
+} zstd_frame_index_header_t;
+
+/* load the sidecar if it is of the trace */
+static zstd_frame_index_t *_load_frame_index(const zstd_reader *reader) {
+  char *path = _frame_index_path(reader->trace_path);
+  FILE *ifile = fopen(path, "rb");
+  free(path);
+  if (ifile == NULL) return NULL;
+
+  zstd_frame_index_header_t header;
+  if (fread(&header, sizeof(header), 1, ifile) != 1 ||
+      memcmp(header.magic, ZSTD_FRAME_INDEX_MAGIC, 8) != 0 ||
+      header.version != ZSTD_FRAME_INDEX_VERSION ||
+      header.file_size != reader->file_size ||
+      header.file_mtime != reader->file_mtime) {
+    VERBOSE("ignore the stale frame index of %s\n", reader->trace_path);
+    fclose(ifile);
+    return NULL;
+  }
+
+  zstd_frame_index_t *index = _new_frame_index(header.n_frame);
+  bool ok = true;
+  for (uint64_t i = 0; i < header.n_frame && ok; i++) {
+    uint64_t entry[3];
+    ok = fread(entry, sizeof(entry), 1, ifile) == 1;
+    index->comp_offset[i] = entry[0];
+    index->comp_size[i] = entry[1];
+    index->decomp_size[i] = entry[2];
+  }
+  fclose(ifile);
+
+  if (ok) _finish_frame_index(index);
+  if (!ok || !index->complete) {
+    WARN("frame index of %s is corrupted\n", reader->trace_path);
+    _free_frame_index(index);
+    return NULL;
+  }
+  return index;
+}
+
+/* write to a temporary file and rename, so that readers of the same trace
+ * opened at the same time do not see a partial index */
+static void _save_frame_index(const zstd_reader *reader) {
+  const zstd_frame_index_t *index = reader->index;
+  char *path = _frame_index_path(reader->trace_path);
+  size_t tmp_len = strlen(path) + 64;
+  char *tmp_path = malloc(tmp_len);
+  snprintf(tmp_path, tmp_len, "%s.%d.%lu", path, (int)getpid(),
+           (unsigned long)pthread_self());
+
+  zstd_frame_index_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, ZSTD_FRAME_INDEX_MAGIC, 8);
+  header.version = ZSTD_FRAME_INDEX_VERSION;
+  header.file_size = reader->file_size;
+  header.file_mtime = reader->file_mtime;
+  header.n_frame = index->n_frame;
+
+  FILE *ofile = fopen(tmp_path, "wb");
+  bool ok = ofile != NULL && fwrite(&header, sizeof(header), 1, ofile) == 1;
+  for (uint64_t i = 0; i < index->n_frame && ok; i++) {
+    uint64_t entry[3] = {index->comp_offset[i], index->comp_size[i],
+                         index->decomp_size[i]};
+    ok = fwrite(entry, sizeof(entry), 1, ofile) == 1;
+  }
+  if (ofile != NULL && fclose(ofile) != 0) ok = false;
+  if (ok && rename(tmp_path, path) == 0) {
+    VERBOSE("write the frame index of %lu frames to %s\n",
+            (unsigned long)index->n_frame, path);
+  } else {
+    /* e.g., the directory of the trace is read-only */
+    VERBOSE("cannot write the frame index %s\n", path);
+    unlink(tmp_path);
+  }
+
+  free(tmp_path);
+  free(path);
+}
+
+/* the frame that has the byte at offset in the decompressed data */
+static uint64_t _find_frame(const zstd_frame_index_t *index, uint64_t offset) {
+  uint64_t lo = 0, hi = index->n_frame;
+  while (hi - lo > 1) {
+    uint64_t mid = (lo + hi) / 2;
+    if (index->decomp_offset[mid] <= offset) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**************** decoder threads ****************/
+/* frame i is decompressed into slot i % n_slot, which is free once the
+ * reading thread has moved past frame i - n_slot, so at most n_slot frames
+ * are decompressed ahead of the reading thread */
+typedef struct {
+  char *buf;
+  size_t size;
+  uint64_t frame;
+  bool ready;
+} zstd_mt_slot_t;
+
+typedef struct zstd_mt_decoder {
+  zstd_reader *reader;
+  int n_thread;
+  pthread_t *threads;
+  bool running;
+
+  pthread_mutex_t mtx;
+  pthread_cond_t cond;
+  int n_slot;
+  zstd_mt_slot_t *slots;
+  /* the next frame to decompress */
+  uint64_t next_frame;
+  /* the frame being read and the read position in it */
+  uint64_t cur_frame;
+  size_t cur_pos;
+  bool stop;
+  bool error;
+
+  /* a request that crosses two frames is copied here */
+  char *stitch_buf;
+  size_t stitch_buf_size;
+} zstd_mt_decoder_t;
+
+static void *_zstd_mt_worker(void *arg) {
+  zstd_mt_decoder_t *mt = arg;
+  const zstd_frame_index_t *index = mt->reader->index;
+  ZSTD_DCtx *dctx = ZSTD_createDCtx();
+
+  pthread_mutex_lock(&mt->mtx);
+  while (true) {
+    while (!mt->stop && mt->next_frame < index->n_frame &&
+           mt->next_frame >= mt->cur_frame + mt->n_slot) {
+      pthread_cond_wait(&mt->cond, &mt->mtx);
+    }
+    if (mt->stop || mt->next_frame >= index->n_frame) break;
+
+    uint64_t frame = mt->next_frame++;
+    zstd_mt_slot_t *slot = &mt->slots[frame % mt->n_slot];
+    pthread_mutex_unlock(&mt->mtx);
+
+    size_t ret = ZSTD_decompressDCtx(
+        dctx, slot->buf, index->max_decomp_size,
+        mt->reader->mapped_file + index->comp_offset[frame],
+        index->comp_size[frame]);
+
+    pthread_mutex_lock(&mt->mtx);
+    if (ZSTD_isError(ret) || ret != index->decomp_size[frame]) {
+      WARN("zstd decompression error at frame %lu: %s\n",
+           (unsigned long)frame,
+           ZSTD_isError(ret) ? ZSTD_getErrorName(ret) : "wrong size");
+      mt->error = true;
+    }
+    slot->size = ZSTD_isError(ret) ? 0 : ret;
+    slot->frame = frame;
+    slot->ready = true;
+    pthread_cond_broadcast(&mt->cond);
+  }
+  pthread_mutex_unlock(&mt->mtx);
+
+  ZSTD_freeDCtx(dctx);
+  return NULL;
+}
+
+static void _zstd_mt_stop(zstd_mt_decoder_t *mt) {
+  if (!mt->running) return;
+
+  pthread_mutex_lock(&mt->mtx);
+  mt->stop = true;
+  pthread_cond_broadcast(&mt->cond);
+  pthread_mutex_unlock(&mt->mtx);
+  for (int i = 0; i < mt->n_thread; i++) {
+    pthread_join(mt->threads[i], NULL);
+  }
+  mt->running = false;
+}
+
+/* start decompressing from the frame that has reader->decomp_pos */
+static void _zstd_mt_start(zstd_mt_decoder_t *mt) {
+  const zstd_frame_index_t *index = mt->reader->index;
+  uint64_t frame = _find_frame(index, mt->reader->decomp_pos);
+
+  /* the buffers are allocated on the first read, so a reader that is opened
+   * but not read (e.g., a clone) does not hold them */
+  for (int i = 0; i < mt->n_slot; i++) {
+    if (mt->slots[i].buf == NULL) {
+      mt->slots[i].buf = malloc(mt->reader->index->max_decomp_size);
+    }
+    mt->slots[i].ready = false;
+  }
+  mt->next_frame = frame;
+  mt->cur_frame = frame;
+  mt->cur_pos = mt->reader->decomp_pos - index->decomp_offset[frame];
+  mt->stop = false;
+  mt->error = false;
+  for (int i = 0; i < mt->n_thread; i++) {
+    if (pthread_create(&mt->threads[i], NULL, _zstd_mt_worker, mt) != 0) {
+      ERROR("cannot create zstd decoder thread %s\n", strerror(errno));
+    }
+  }
+  mt->running = true;
+}
+
+static zstd_mt_decoder_t *_zstd_mt_create(zstd_reader *reader) {
+  zstd_mt_decoder_t *mt = calloc(1, sizeof(zstd_mt_decoder_t));
+  mt->reader = reader;
+  mt->n_thread = zstd_reader_n_thread;
+  mt->threads = malloc(sizeof(pthread_t) * mt->n_thread);
+  mt->n_slot = mt->n_thread * 2;
+  mt->slots = calloc(mt->n_slot, sizeof(zstd_mt_slot_t));
+  pthread_mutex_init(&mt->mtx, NULL);
+  pthread_cond_init(&mt->cond, NULL);
+  return mt;
+}
+
+static void _zstd_mt_free(zstd_mt_decoder_t *mt) {
+  _zstd_mt_stop(mt);
+  for (int i = 0; i < mt->n_slot; i++) free(mt->slots[i].buf);
+  free(mt->slots);
+  free(mt->threads);
+  free(mt->stitch_buf);
+  pthread_mutex_destroy(&mt->mtx);
+  pthread_cond_destroy(&mt->cond);
+  free(mt);
+}
+
+/* wait for the frame being read, NULL on error */
+static zstd_mt_slot_t *_zstd_mt_wait(zstd_mt_decoder_t *mt) {
+  zstd_mt_slot_t *slot = &mt->slots[mt->cur_frame % mt->n_slot];
+  pthread_mutex_lock(&mt->mtx);
+  while (!(slot->ready && slot->frame == mt->cur_frame) && !mt->error) {
+    pthread_cond_wait(&mt->cond, &mt->mtx);
+  }
+  bool error = mt->error;
+  pthread_mutex_unlock(&mt->mtx);
+  return error ? NULL : slot;
+}
+
+/* release the slot of the frame being read */
+static void _zstd_mt_next_frame(zstd_mt_decoder_t *mt) {
+  pthread_mutex_lock(&mt->mtx);
+  mt->slots[mt->cur_frame % mt->n_slot].ready = false;
+  mt->cur_frame++;
+  mt->cur_pos = 0;
+  pthread_cond_broadcast(&mt->cond);
+  pthread_mutex_unlock(&mt->mtx);
+}
+
+static size_t _zstd_mt_read_bytes(zstd_reader *reader, size_t n_byte,
+                                  char **data_start) {
+  zstd_mt_decoder_t *mt = reader->mt;
+  if (!mt->running) _zstd_mt_start(mt);
+
+  size_t n_copied = 0;
+  while (true) {
+    if (mt->cur_frame >= reader->index->n_frame) {
+      reader->status = MY_EOF;
+      return 0;
+    }
+    zstd_mt_slot_t *slot = _zstd_mt_wait(mt);
+    if (slot == NULL) {
+      reader->status = ERR;
+      return 0;
+    }
+
+    size_t n_left = slot->size - mt->cur_pos;
+    if (n_copied == 0 && n_left >= n_byte) {
+      *data_start = slot->buf + mt->cur_pos;
+      mt->cur_pos += n_byte;
+      reader->decomp_pos += n_byte;
+      return n_byte;
+    }
+
+    if (mt->stitch_buf_size < n_byte) {
+      mt->stitch_buf = realloc(mt->stitch_buf, n_byte);
+      mt->stitch_buf_size = n_byte;
+    }
+    size_t n = n_left < n_byte - n_copied ? n_left : n_byte - n_copied;
+    memcpy(mt->stitch_buf + n_copied, slot->buf + mt->cur_pos, n);
+    n_copied += n;
+    mt->cur_pos += n;
+    if (n_copied == n_byte) {
+      *data_start = mt->stitch_buf;
+      reader->decomp_pos += n_byte;
+      return n_byte;
+    }
+    _zstd_mt_next_frame(mt);
+  }
+}
+
+/**************** reader ****************/
+
 zstd_reader *create_zstd_reader(const char *trace_path) {
   zstd_reader *reader = malloc(sizeof(zstd_reader));
 
@@ -24,6 +436,40 @@ zstd_reader *create_zstd_reader(const char *trace_path) {
     exit(1);
   }
 
+  struct stat st;
+  if (fstat(fileno(reader->ifile), &st) != 0) {
+    ERROR("Unable to fstat '%s', %s\n", trace_path, strerror(errno));
+  }
+  reader->trace_path = strdup(trace_path);
+  reader->file_size = st.st_size;
+  reader->file_mtime = st.st_mtime;
+  reader->mapped_file = NULL;
+  if (reader->file_size > 0) {
+    reader->mapped_file = mmap(NULL, reader->file_size, PROT_READ, MAP_SHARED,
+                               fileno(reader->ifile), 0);
+    if (reader->mapped_file == MAP_FAILED) {
+      ERROR("Unable to mmap '%s', %s\n", trace_path, strerror(errno));
+    }
+  }
+  reader->decomp_pos = 0;
+  reader->mt = NULL;
+
+  /* the index from the sidecar, or from the frame headers, which is cheap
+   * because it only reads the block headers */
+  reader->index = _load_frame_index(reader);
+  if (reader->index == NULL && reader->mapped_file != NULL) {
+    reader->index = _scan_frames(reader);
+    if (reader->index != NULL && reader->index->complete &&
+        reader->index->n_frame > 1) {
+      _save_frame_index(reader);
+    }
+  }
+  if (reader->index != NULL) {
+    VERBOSE("zstd trace %s has %lu frames, decompressed size %ld\n",
+            trace_path, (unsigned long)reader->index->n_frame,
+            (long)zstd_reader_decompressed_size(reader));
+  }
+
   reader->buff_in_sz = ZSTD_DStreamInSize();
   reader->buff_in = malloc(reader->buff_in_sz);
   reader->input.src = reader->buff_in;
@@ -37,17 +483,30 @@ zstd_reader *create_zstd_reader(const char *trace_path) {
   reader->output.pos = 0;
 
   reader->buff_out_read_pos = 0;
-  reader->status = 0;
+  reader->status = OK;
 
   reader->zds = ZSTD_createDStream();
 
+  /* decompress frames in parallel only if they are small enough to be
+   * buffered */
+  if (zstd_reader_n_thread > 0 && reader->index != NULL &&
+      reader->index->complete && reader->index->n_frame > 1 &&
+      reader->index->max_decomp_size <= ZSTD_MT_MAX_FRAME_SIZE) {
+    reader->mt = _zstd_mt_create(reader);
+  }
+
   return reader;
 }
 
 void free_zstd_reader(zstd_reader *reader) {
+  if (reader->mt != NULL) _zstd_mt_free(reader->mt);
+  _free_frame_index(reader->index);
+  if (reader->mapped_file != NULL) munmap(reader->mapped_file, reader->file_size);
+  fclose(reader->ifile);
   ZSTD_freeDStream(reader->zds);
   free(reader->buff_in);
   free(reader->buff_out);
+  free(reader->trace_path);
   free(reader);
 }
 
@@ -172,6 +631,10 @@ size_t zstd_reader_read_line(zstd_reader *reader, char **line_start,
  */
 size_t zstd_reader_read_bytes(zstd_reader *reader, size_t n_byte,
                               char **data_start) {
+  if (reader->mt != NULL) {
+    return _zstd_mt_read_bytes(reader, n_byte, data_start);
+  }
+
   size_t sz = 0;
   while (reader->buff_out_read_pos + n_byte > reader->output.pos) {
     rstatus status = _decompress_from_buff(reader);
@@ -191,6 +654,7 @@ size_t zstd_reader_read_bytes(zstd_reader *reader, size_t n_byte,
     sz = n_byte;
     *data_start = ((char *)reader->buff_out) + reader->buff_out_read_pos;
     reader->buff_out_read_pos += n_byte;
+    reader->decomp_pos += n_byte;
 
     return sz;
   } else {
@@ -199,4 +663,100 @@ size_t zstd_reader_read_bytes(zstd_reader *reader, size_t n_byte,
 
     return sz;
   }
-}
\ No newline at end of file
+}
+
+bool zstd_reader_build_index(zstd_reader *reader) {
+  if (reader->index == NULL) return false;
+  if (reader->index->complete) return true;
+
+  zstd_frame_index_t *index = reader->index;
+  ZSTD_DCtx *dctx = ZSTD_createDCtx();
+  size_t out_sz = ZSTD_DStreamOutSize();
+  void *out = malloc(out_sz);
+  bool ok = true;
+  for (uint64_t i = 0; i < index->n_frame && ok; i++) {
+    if (index->decomp_size[i] != UINT64_MAX) continue;
+
+    ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+    ZSTD_inBuffer input = {reader->mapped_file + index->comp_offset[i],
+                           index->comp_size[i], 0};
+    uint64_t size = 0;
+    size_t ret = 1;
+    while (ret != 0) {
+      ZSTD_outBuffer output = {out, out_sz, 0};
+      ret = ZSTD_decompressStream(dctx, &output, &input);
+      if (ZSTD_isError(ret)) {
+        WARN("zstd decompression error: %s\n", ZSTD_getErrorName(ret));
+        ok = false;
+        break;
+      }
+      size += output.pos;
+      if (input.pos == input.size && output.pos < out_sz) break;
+    }
+    index->decomp_size[i] = size;
+  }
+  free(out);
+  ZSTD_freeDCtx(dctx);
+
+  if (!ok) return false;
+  _finish_frame_index(index);
+  _save_frame_index(reader);
+  return index->complete;
+}
+
+int64_t zstd_reader_decompressed_size(const zstd_reader *reader) {
+  if (reader->index == NULL || !reader->index->complete) return -1;
+  return (int64_t)reader->index->decomp_offset[reader->index->n_frame];
+}
+
+bool zstd_reader_seek(zstd_reader *reader, uint64_t offset) {
+  const zstd_frame_index_t *index = reader->index;
+  bool has_index = index != NULL && index->complete;
+  if (has_index && offset > index->decomp_offset[index->n_frame]) {
+    WARN("offset %lu is beyond the end of %s\n", (unsigned long)offset,
+         reader->trace_path);
+    return false;
+  }
+
+  if (reader->mt != NULL) {
+    /* the decoder threads restart from the frame at the next read */
+    _zstd_mt_stop(reader->mt);
+    reader->decomp_pos = offset;
+    reader->status = OK;
+    return true;
+  }
+
+  /* decompress from the start of the frame that has offset, unless the
+   * reader is already in the frame before offset */
+  uint64_t frame_start = 0, comp_start = 0;
+  if (has_index && index->n_frame > 0) {
+    uint64_t frame = _find_frame(index, offset);
+    frame_start = index->decomp_offset[frame];
+    comp_start = index->comp_offset[frame];
+  }
+  if (offset < reader->decomp_pos || frame_start > reader->decomp_pos) {
+    if (fseek(reader->ifile, (long)comp_start, SEEK_SET) != 0) {
+      WARN("cannot seek in %s, %s\n", reader->trace_path, strerror(errno));
+      return false;
+    }
+    ZSTD_DCtx_reset(reader->zds, ZSTD_reset_session_only);
+    reader->input.size = 0;
+    reader->input.pos = 0;
+    reader->output.pos = 0;
+    reader->buff_out_read_pos = 0;
+    reader->status = OK;
+    reader->decomp_pos = frame_start;
+  }
+
+  char *data;
+  while (reader->decomp_pos < offset) {
+    uint64_t n = offset - reader->decomp_pos;
+    if (n > 4096) n = 4096;
+    if (zstd_reader_read_bytes(reader, n, &data) != n) {
+      WARN("cannot seek to %lu in %s\n", (unsigned long)offset,
+           reader->trace_path);
+      return false;
+    }
+  }
+  return true;
+}
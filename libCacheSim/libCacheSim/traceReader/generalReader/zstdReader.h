@@ -1,5 +1,8 @@
 #pragma once
 
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <zstd.h>
 
@@ -9,6 +12,31 @@
 extern "C" {
 #endif
 
+/* a frame larger than this is not decompressed by the decoder threads */
+#define ZSTD_MT_MAX_FRAME_SIZE (64 * 1024 * 1024)
+#define ZSTD_FRAME_INDEX_MAGIC "ZSTDFIDX"
+#define ZSTD_FRAME_INDEX_VERSION 1
+
+/* the frames of a zstd trace, built by walking the frame headers or loaded
+ * from the sidecar <trace>.fidx, skippable and empty frames are not included
+ * (so traces in the zstd seekable format can also be indexed) */
+typedef struct zstd_frame_index {
+  uint64_t n_frame;
+  /* the offset and size of each frame in the compressed file */
+  uint64_t *comp_offset;
+  uint64_t *comp_size;
+  /* UINT64_MAX if the frame header does not have the content size */
+  uint64_t *decomp_size;
+  /* the offset of each frame in the decompressed data, n_frame + 1 entries,
+   * only valid if complete */
+  uint64_t *decomp_offset;
+  uint64_t max_decomp_size;
+  /* whether the decompressed size of every frame is known */
+  bool complete;
+} zstd_frame_index_t;
+
+struct zstd_mt_decoder;
+
 typedef struct zstd_reader {
   FILE *ifile;
   ZSTD_DStream *zds;
@@ -24,6 +52,19 @@ typedef struct zstd_reader {
   ZSTD_outBuffer output;
 
   rstatus status;
+
+  char *trace_path;
+  /* the compressed file, used by the index and the decoder threads */
+  char *mapped_file;
+  size_t file_size;
+  int64_t file_mtime;
+  zstd_frame_index_t *index;
+  /* the number of decompressed bytes returned by zstd_reader_read_bytes */
+  uint64_t decomp_pos;
+
+  /* the frames are decompressed by decoder threads if the trace has multiple
+   * frames of known size, NULL otherwise */
+  struct zstd_mt_decoder *mt;
 } zstd_reader;
 
 zstd_reader *create_zstd_reader(const char *trace_path);
@@ -38,6 +79,32 @@ size_t zstd_reader_read_line(zstd_reader *reader, char **line_start,
 size_t zstd_reader_read_bytes(zstd_reader *reader, size_t n_byte,
                               char **data_start);
 
+/**
+ * @brief find the decompressed size of the frames whose header does not have
+ * it by decompressing them, and save the index in the sidecar, this is done
+ * once per trace
+ *
+ * @return whether the index is complete
+ */
+bool zstd_reader_build_index(zstd_reader *reader);
+
+/* the size of the decompressed data, -1 if the index is not complete */
+int64_t zstd_reader_decompressed_size(const zstd_reader *reader);
+
+/* the offset of the next byte in the decompressed data */
+static inline uint64_t zstd_reader_tell(const zstd_reader *reader) {
+  return reader->decomp_pos;
+}
+
+/**
+ * @brief move to an offset in the decompressed data, with a complete index
+ * only the frame that has the offset is decompressed, otherwise the trace is
+ * decompressed from the current position or the beginning
+ *
+ * @return whether the reader is at offset
+ */
+bool zstd_reader_seek(zstd_reader *reader, uint64_t offset);
+
 #ifdef __cplusplus
 }
 #endif
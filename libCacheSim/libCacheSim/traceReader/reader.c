@@ -23,9 +23,14 @@
 #include "customizedReader/twrNSBin.h"
 #include "customizedReader/vscsi.h"
 #include "customizedReader/wikiBin.h"
+#include "generalReader/columnar.h"
 #include "generalReader/lcs.h"
 #include "generalReader/libcsv.h"
 #include "generalReader/readerInternal.h"
+#include "generalReader/synthetic.h"
+
+#define XXH_INLINE_ALL
+#include "../dataStructure/hash/xxh3.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,8 +59,8 @@ reader_t *setup_reader(const char *const trace_path,
   reader->zstd_reader_p = NULL;
 #ifdef SUPPORT_ZSTD_TRACE
   size_t slen = strlen(trace_path);
-  if (strncmp(trace_path + (slen - 4), ".zst", 4) == 0 ||
-      strncmp(trace_path + (slen - 7), ".zst.22", 7) == 0) {
+  if ((slen >= 4 && strncmp(trace_path + (slen - 4), ".zst", 4) == 0) ||
+      (slen >= 7 && strncmp(trace_path + (slen - 7), ".zst.22", 7) == 0)) {
     reader->is_zstd_file = true;
     reader->zstd_reader_p = create_zstd_reader(trace_path);
     if (!_info_printed) {
@@ -73,6 +78,8 @@ reader_t *setup_reader(const char *const trace_path,
   reader->cloned = false;
   reader->item_size = 0;
   reader->obj_id_is_num = false;
+  reader->str_obj_id_table = NULL;
+  reader->n_str_obj_id_collision = 0;
   reader->mapped_file = NULL;
   reader->mmap_offset = 0;
   reader->sampler = NULL;
@@ -80,6 +87,7 @@ reader_t *setup_reader(const char *const trace_path,
   reader->read_direction = READ_FORWARD;
   reader->n_req_left = 0;
   reader->last_req_clock_time = -1;
+  reader->cap_at_n_req = -1;
 
   if (init_params != NULL) {
     memcpy(&reader->init_params, init_params, sizeof(reader_init_param_t));
@@ -92,6 +100,9 @@ reader_t *setup_reader(const char *const trace_path,
     reader->trace_start_offset = init_params->trace_start_offset;
     reader->mmap_offset = init_params->trace_start_offset;
     reader->cap_at_n_req = init_params->cap_at_n_req;
+    if (init_params->audit_str_obj_id)
+      reader->str_obj_id_table =
+          g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
     if (init_params->sampler != NULL)
       reader->sampler = init_params->sampler->clone(init_params->sampler);
   } else {
@@ -101,6 +112,12 @@ reader_t *setup_reader(const char *const trace_path,
   assert(trace_path != NULL);
   reader->trace_path = strdup(trace_path);
 
+  if (trace_type == SYNTHETIC_TRACE) {
+    /* the requests are generated, there is no file to open */
+    synthetic_setup(reader);
+    return reader;
+  }
+
   if ((fd = open(trace_path, O_RDONLY)) < 0) {
     ERROR("Unable to open '%s', %s\n", trace_path, strerror(errno));
     exit(1);
@@ -227,6 +244,9 @@ reader_t *setup_reader(const char *const trace_path,
     case VALPIN_TRACE:
       valpinReader_setup(reader);
       break;
+    case COLUMNAR_TRACE:
+      columnar_setup(reader);
+      break;
     default:
       ERROR("cannot recognize trace type: %c\n", reader->trace_type);
       abort();
@@ -255,9 +275,18 @@ reader_t *setup_reader(const char *const trace_path,
   }
 
   if (reader->is_zstd_file) {
-    // we cannot get the total number requests
-    // from compressed trace without reading the tracee
+    // the number of requests is known without decompressing the trace
+    // only if the frame index has the decompressed size
     reader->n_total_req = 0;
+#ifdef SUPPORT_ZSTD_TRACE
+    int64_t decomp_size =
+        zstd_reader_decompressed_size(reader->zstd_reader_p);
+    if (decomp_size >= 0 && reader->item_size > 0) {
+      reader->n_total_req =
+          (uint64_t)(decomp_size - reader->trace_start_offset) /
+          reader->item_size;
+    }
+#endif
   }
 
   close(fd);
@@ -296,7 +325,7 @@ int read_one_req(reader_t *const reader, request_t *const req) {
 
     reader->n_read_req += 1;
     req->hv = 0;
-    req->ttl = -1;
+    req->ttl = 0;
     req->valid = true;
 
     switch (reader->trace_type) {
@@ -377,6 +406,12 @@ int read_one_req(reader_t *const reader, request_t *const req) {
       case VALPIN_TRACE:
         status = valpin_read_one_req(reader, req);
         break;
+      case COLUMNAR_TRACE:
+        status = columnar_read_one_req(reader, req);
+        break;
+      case SYNTHETIC_TRACE:
+        status = synthetic_read_one_req(reader, req);
+        break;
       default:
         ERROR(
             "cannot recognize reader obj_id_type, given reader obj_id_type: "
@@ -417,6 +452,130 @@ int read_one_req(reader_t *const reader, request_t *const req) {
   return status;
 }
 
+req_batch_t *new_req_batch(const int capacity) {
+  req_batch_t *batch = my_malloc(req_batch_t);
+  batch->n_req = 0;
+  batch->capacity = capacity;
+  batch->pos = 0;
+  batch->clock_time = my_malloc_n(int64_t, capacity);
+  batch->obj_id = my_malloc_n(obj_id_t, capacity);
+  batch->obj_size = my_malloc_n(int64_t, capacity);
+  batch->next_access_vtime = my_malloc_n(int64_t, capacity);
+  batch->req = new_request();
+  return batch;
+}
+
+void free_req_batch(req_batch_t *const batch) {
+  my_free(sizeof(int64_t) * batch->capacity, batch->clock_time);
+  my_free(sizeof(obj_id_t) * batch->capacity, batch->obj_id);
+  my_free(sizeof(int64_t) * batch->capacity, batch->obj_size);
+  my_free(sizeof(int64_t) * batch->capacity, batch->next_access_vtime);
+  free_request(batch->req);
+  my_free(sizeof(req_batch_t), batch);
+}
+
+bool reader_batch_has_all_fields(const reader_t *const reader) {
+  switch (reader->trace_type) {
+    case ORACLE_GENERAL_TRACE:
+    case COLUMNAR_TRACE:
+      return true;
+    case BIN_TRACE:;
+      const binary_params_t *params = reader->reader_params;
+      return params->op_field_idx == 0 && params->ttl_field_idx == 0;
+    default:
+      return false;
+  }
+}
+
+/* whether read_n_req can decode the trace without read_one_req */
+static bool _has_batch_decoder(const reader_t *const reader) {
+  if (reader->sampler != NULL || reader->is_zstd_file ||
+      reader->n_req_left > 0 || reader->read_direction != READ_FORWARD) {
+    return false;
+  }
+
+  return reader->trace_type == ORACLE_GENERAL_TRACE ||
+         reader->trace_type == BIN_TRACE ||
+         reader->trace_type == COLUMNAR_TRACE;
+}
+
+/* remove the requests of size zero in [start, batch->n_req) */
+static void _req_batch_remove_size_zero(req_batch_t *const batch,
+                                        const int start) {
+  int i = start;
+  while (i < batch->n_req && batch->obj_size[i] != 0) i++;
+
+  int j = i;
+  for (; i < batch->n_req; i++) {
+    batch->clock_time[j] = batch->clock_time[i];
+    batch->obj_id[j] = batch->obj_id[i];
+    batch->obj_size[j] = batch->obj_size[i];
+    batch->next_access_vtime[j] = batch->next_access_vtime[i];
+    j += batch->obj_size[i] != 0;
+  }
+  batch->n_req = j;
+}
+
+int read_n_req(reader_t *const reader, req_batch_t *const batch, int n) {
+  batch->n_req = 0;
+  batch->pos = 0;
+  if (n > batch->capacity) n = batch->capacity;
+
+  if (!_has_batch_decoder(reader)) {
+    while (batch->n_req < n && read_one_req(reader, batch->req) == 0) {
+      int i = batch->n_req++;
+      batch->clock_time[i] = batch->req->clock_time;
+      batch->obj_id[i] = batch->req->obj_id;
+      batch->obj_size[i] = batch->req->obj_size;
+      batch->next_access_vtime[i] = batch->req->next_access_vtime;
+    }
+    return batch->n_req;
+  }
+
+  if (reader->cap_at_n_req > 1) {
+    int64_t n_left = reader->cap_at_n_req - (int64_t)reader->n_read_req;
+    if (n_left < n) n = n_left > 0 ? (int)n_left : 0;
+  }
+
+  /* the trace types that skip the requests of size zero */
+  bool remove_size_zero = reader->ignore_size_zero_req &&
+                          reader->trace_type != BIN_TRACE;
+  while (batch->n_req < n) {
+    int start = batch->n_req;
+    int n_decoded;
+    switch (reader->trace_type) {
+      case ORACLE_GENERAL_TRACE:
+        n_decoded = oracleGeneralBin_read_n_req(reader, batch, n - start);
+        break;
+      case BIN_TRACE:
+        n_decoded = binary_read_n_req(reader, batch, n - start);
+        break;
+      case COLUMNAR_TRACE:
+        n_decoded = columnar_read_n_req(reader, batch, n - start);
+        break;
+      default:
+        ERROR("trace type %s does not have a batch decoder\n",
+              g_trace_type_name[reader->trace_type]);
+        abort();
+    }
+    if (n_decoded == 0) break;
+
+    batch->n_req += n_decoded;
+    if (remove_size_zero) {
+      _req_batch_remove_size_zero(batch, start);
+    }
+  }
+
+  if (reader->ignore_obj_size) {
+    for (int i = 0; i < batch->n_req; i++) {
+      batch->obj_size[i] = 1;
+    }
+  }
+  reader->n_read_req += batch->n_req;
+
+  return batch->n_req;
+}
+
 /**
  * @brief from current line/request, go back one, the next read will
  * get the current request
@@ -573,7 +732,8 @@ void reset_reader(reader_t *const reader) {
 
 #ifdef SUPPORT_ZSTD_TRACE
   if (reader->is_zstd_file) {
-    fseek(reader->zstd_reader_p->ifile, 0, SEEK_SET);
+    zstd_reader_seek(reader->zstd_reader_p, reader->trace_start_offset);
+    curr_offset = reader->trace_start_offset;
   }
 #endif
 
@@ -585,6 +745,20 @@ uint64_t get_num_of_req(reader_t *const reader) {
 
   uint64_t n_req = 0;
 
+#ifdef SUPPORT_ZSTD_TRACE
+  /* decompress the frames once to find their size, the index is saved so
+   * that the next time the count is known when the trace is opened */
+  if (reader->is_zstd_file &&
+      zstd_reader_build_index(reader->zstd_reader_p)) {
+    int64_t decomp_size =
+        zstd_reader_decompressed_size(reader->zstd_reader_p);
+    reader->n_total_req =
+        (uint64_t)(decomp_size - reader->trace_start_offset) /
+        reader->item_size;
+    return reader->n_total_req;
+  }
+#endif
+
   if (reader->trace_format == TXT_TRACE_FORMAT || reader->is_zstd_file) {
     reader_t *reader_copy = clone_reader(reader);
     reader_copy->mmap_offset = 0;
@@ -592,6 +766,8 @@ uint64_t get_num_of_req(reader_t *const reader) {
     while (read_one_req(reader_copy, req) == 0) {
       n_req++;
     }
+    free_request(req);
+    close_reader(reader_copy);
   } else {
     ERROR("should not reach here\n");
     abort();
@@ -605,7 +781,8 @@ reader_t *clone_reader(const reader_t *const reader_in) {
                                   &reader_in->init_params);
   reader->n_total_req = reader_in->n_total_req;
 
-  if (reader->trace_format != TXT_TRACE_FORMAT) {
+  if (reader->trace_format != TXT_TRACE_FORMAT &&
+      reader->mapped_file != NULL) {
     munmap(reader->mapped_file, reader->file_size);
     reader->mapped_file = reader_in->mapped_file;
   }
@@ -638,6 +815,8 @@ int close_reader(reader_t *const reader) {
     if (reader->init_params.binary_fmt_str != NULL) {
       free(reader->init_params.binary_fmt_str);
     }
+  } else if (reader->trace_type == COLUMNAR_TRACE) {
+    columnar_close(reader);
   }
 
 #ifdef SUPPORT_ZSTD_TRACE
@@ -663,6 +842,13 @@ int close_reader(reader_t *const reader) {
     free(reader->sampler);
   }
 
+  if (reader->str_obj_id_table != NULL) {
+    INFO("%s: %u string object ids, %lu obj_id collisions\n",
+         reader->trace_path, g_hash_table_size(reader->str_obj_id_table),
+         (unsigned long)reader->n_str_obj_id_collision);
+    g_hash_table_destroy(reader->str_obj_id_table);
+  }
+
   free(reader->trace_path);
   free(reader);
 
@@ -672,13 +858,30 @@ int close_reader(reader_t *const reader) {
 /**
  * jump to given position in the trace, such as 0.2, 0.5, 1.0, etc.
  * because certain functions require reader to be read sequentially,
- * this function should not be used in the middle of reading the trace
+ * this function should not be used in the middle of reading the trace,
+ * a zstd-compressed trace that cannot be indexed stays where it is
  */
 void reader_set_read_pos(reader_t *const reader, double pos) {
   /* jason (202004): this may not work for CSV
    */
   if (pos > 1) pos = 1;
 
+#ifdef SUPPORT_ZSTD_TRACE
+  if (reader->is_zstd_file) {
+    /* a position in the decompressed data, this needs the frame index */
+    if (!zstd_reader_build_index(reader->zstd_reader_p)) {
+      WARN("cannot seek in %s without the frame index\n",
+           reader->trace_path);
+      return;
+    }
+    uint64_t n_req = get_num_of_req(reader);
+    uint64_t req_idx = (uint64_t)((double)n_req * pos);
+    zstd_reader_seek(reader->zstd_reader_p,
+                     reader->trace_start_offset + req_idx * reader->item_size);
+    return;
+  }
+#endif
+
   size_t offset = (double)reader->file_size * pos;
   if (reader->trace_format == TXT_TRACE_FORMAT) {
     fseek(reader->file, offset, SEEK_SET);
@@ -700,6 +903,50 @@ void reader_set_read_pos(reader_t *const reader, double pos) {
   }
 }
 
+void reader_get_pos(const reader_t *const reader, reader_pos_t *pos) {
+  pos->n_read_req = reader->n_read_req;
+  pos->n_req_left = reader->n_req_left;
+  pos->last_req_clock_time = reader->last_req_clock_time;
+  if (reader->trace_format == TXT_TRACE_FORMAT) {
+    pos->offset = ftell(reader->file);
+#ifdef SUPPORT_ZSTD_TRACE
+  } else if (reader->is_zstd_file) {
+    pos->offset = zstd_reader_tell(reader->zstd_reader_p);
+#endif
+  } else {
+    pos->offset = reader->mmap_offset;
+  }
+}
+
+bool reader_set_pos(reader_t *const reader, const reader_pos_t *pos) {
+  if (reader->is_zstd_file) {
+#ifdef SUPPORT_ZSTD_TRACE
+    /* the offset is in the decompressed data */
+    if (!zstd_reader_seek(reader->zstd_reader_p, pos->offset)) {
+      return false;
+    }
+#endif
+  } else if (reader->trace_format == TXT_TRACE_FORMAT) {
+    if (fseek(reader->file, pos->offset, SEEK_SET) != 0) {
+      WARN("cannot seek to %ld in %s\n", (long)pos->offset,
+           reader->trace_path);
+      return false;
+    }
+  } else {
+    if (pos->offset > (int64_t)reader->file_size) {
+      WARN("offset %ld is beyond the end of %s\n", (long)pos->offset,
+           reader->trace_path);
+      return false;
+    }
+    reader->mmap_offset = pos->offset;
+  }
+
+  reader->n_read_req = pos->n_read_req;
+  reader->n_req_left = pos->n_req_left;
+  reader->last_req_clock_time = pos->last_req_clock_time;
+  return true;
+}
+
 void read_first_req(reader_t *reader, request_t *req) {
   uint64_t offset = reader->mmap_offset;
   reset_reader(reader);
@@ -708,6 +955,21 @@ void read_first_req(reader_t *reader, request_t *req) {
 }
 
 void read_last_req(reader_t *reader, request_t *req) {
+#ifdef SUPPORT_ZSTD_TRACE
+  if (reader->is_zstd_file) {
+    /* go_back_one_req moves mmap_offset, which a zstd trace does not use */
+    reader_pos_t pos;
+    reader_get_pos(reader, &pos);
+    uint64_t n_req = get_num_of_req(reader);
+    zstd_reader_seek(reader->zstd_reader_p,
+                     reader->trace_start_offset +
+                         (n_req - 1) * reader->item_size);
+    read_one_req(reader, req);
+    reader_set_pos(reader, &pos);
+    return;
+  }
+#endif
+
   uint64_t offset = reader->mmap_offset;
   reset_reader(reader);
   reader_set_read_pos(reader, 1.0);
@@ -717,6 +979,34 @@ void read_last_req(reader_t *reader, request_t *req) {
   reader->mmap_offset = offset;
 }
 
+#ifndef SUPPORT_ZSTD_TRACE
+void set_zstd_reader_n_thread(int n_thread) {}
+#endif
+
+static void _audit_str_obj_id(reader_t *const reader, const char *const str,
+                              const size_t len, const obj_id_t obj_id) {
+  gpointer key = GSIZE_TO_POINTER(obj_id);
+  const char *prev = g_hash_table_lookup(reader->str_obj_id_table, key);
+  if (prev == NULL) {
+    g_hash_table_insert(reader->str_obj_id_table, key, g_strndup(str, len));
+  } else if (strlen(prev) != len || memcmp(prev, str, len) != 0) {
+    /* only print the first few, a trace with many collisions prints a lot */
+    if (reader->n_str_obj_id_collision++ < 16) {
+      WARN("obj_id %lu collision: \"%s\" and \"%.*s\"\n",
+           (unsigned long)obj_id, prev, (int)len, str);
+    }
+  }
+}
+
+obj_id_t str_to_obj_id(reader_t *const reader, const char *const str,
+                       const size_t len) {
+  obj_id_t obj_id = (obj_id_t)XXH3_64bits(str, len);
+  if (unlikely(reader->str_obj_id_table != NULL)) {
+    _audit_str_obj_id(reader, str, len, obj_id);
+  }
+  return obj_id;
+}
+
 bool is_str_num(const char *str) {
   for (int i = 0; i < strlen(str); i++) {
     if (!(isdigit(str[i]) || (str[i] >= 'a' && str[i] <= 'f') ||
@@ -16,17 +16,24 @@ extern "C" {
 #endif
 
 extern __thread uint64_t rand_seed;
+/* the state advanced by next_rand, NULL means rand_seed */
+extern __thread uint64_t *rand_state;
 
 void set_rand_seed(uint64_t seed);
 
+/* make next_rand on this thread advance state, e.g., the state of the cache
+ * that the thread runs, NULL goes back to rand_seed */
+void set_rand_state(uint64_t *state);
+
 /**
  * generate pseudo rand number, taken from LHD simulator
  * random number generator from Knuth MMIX
  * @return
  */
 static inline uint64_t next_rand(void) {
-  rand_seed = 6364136223846793005 * rand_seed + 1442695040888963407;
-  return rand_seed;
+  uint64_t *state = rand_state == NULL ? &rand_seed : rand_state;
+  *state = 6364136223846793005 * *state + 1442695040888963407;
+  return *state;
 }
 
 static inline long long next_power_of_2(long long N) {
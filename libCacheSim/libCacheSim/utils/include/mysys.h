@@ -12,8 +12,27 @@
 #include <pthread.h>
 #include <sys/resource.h>
 
+/* pin the thread to the next core, round-robin over all cores */
 int set_thread_affinity(pthread_t tid);
 
+int set_thread_affinity_to_core(pthread_t tid, int core_id);
+
+/* restore the affinity the calling thread had before it was first pinned
+ * by set_thread_affinity_to_core, tid must be the calling thread */
+int reset_thread_affinity(pthread_t tid);
+
+/* the number of online NUMA nodes, 1 if the topology is not available */
+int get_n_numa_nodes(void);
+
+/* fill nodes with the ids of the online NUMA nodes, which may not be
+ * contiguous (e.g., 0 and 2), return the number of ids written, node 0 if
+ * the topology is not available */
+int get_numa_nodes(int *nodes, int max_n_nodes);
+
+/* fill cores with the ids of the cores on the node (a node id) that the
+ * process is allowed to run on, return the number of cores written */
+int get_numa_node_cores(int node, int *cores, int max_n_cores);
+
 int get_n_cores(void);
 
 int n_cores(void);
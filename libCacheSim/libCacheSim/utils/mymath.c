@@ -9,5 +9,8 @@
 #include "../include/libCacheSim/logging.h"
 
 __thread uint64_t rand_seed = 0;
+__thread uint64_t *rand_state = NULL;
 
 void set_rand_seed(uint64_t seed) { rand_seed = seed; }
+
+void set_rand_state(uint64_t *state) { rand_state = state; }
@@ -14,6 +14,7 @@
 #include <pthread.h>
 #include <sched.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/resource.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -32,22 +33,148 @@ int set_thread_affinity(pthread_t tid) {
   static int last_core_id = -1;
   int num_cores = sysconf(_SC_NPROCESSORS_ONLN);
 
-  last_core_id++;
-  last_core_id %= num_cores;
-  DEBUG("assign thread affinity %d/%d\n", last_core_id, num_cores);
+  int core_id =
+      (__atomic_add_fetch(&last_core_id, 1, __ATOMIC_RELAXED)) % num_cores;
+  set_thread_affinity_to_core(tid, core_id);
+#endif
+  return 0;
+}
+
+#ifdef __linux__
+/* the mask of the calling thread before it was first pinned, restored by
+ * reset_thread_affinity */
+static __thread cpu_set_t saved_cpuset;
+static __thread bool has_saved_cpuset = false;
+#endif
+
+int set_thread_affinity_to_core(pthread_t tid, int core_id) {
+#ifdef __linux__
+  DEBUG("assign thread affinity %d/%ld\n", core_id,
+        sysconf(_SC_NPROCESSORS_ONLN));
+
+  if (pthread_equal(tid, pthread_self()) && !has_saved_cpuset) {
+    has_saved_cpuset = pthread_getaffinity_np(tid, sizeof(cpu_set_t),
+                                              &saved_cpuset) == 0;
+  }
 
   cpu_set_t cpuset;
   CPU_ZERO(&cpuset);
-  CPU_SET(last_core_id, &cpuset);
+  CPU_SET(core_id, &cpuset);
 
   int rc = pthread_setaffinity_np(tid, sizeof(cpu_set_t), &cpuset);
   if (rc != 0) {
     WARN("Error calling pthread_setaffinity_np: %d\n", rc);
+    return rc;
+  }
+#endif
+  return 0;
+}
+
+int reset_thread_affinity(pthread_t tid) {
+#ifdef __linux__
+  if (!pthread_equal(tid, pthread_self()) || !has_saved_cpuset) return 0;
+
+  int rc = pthread_setaffinity_np(tid, sizeof(cpu_set_t), &saved_cpuset);
+  if (rc != 0) {
+    WARN("Error calling pthread_setaffinity_np: %d\n", rc);
+    return rc;
   }
+  has_saved_cpuset = false;
 #endif
   return 0;
 }
 
+#ifdef __linux__
+/* read a sysfs list of ids such as 0-7,16-23 from path into ids (NULL to only
+ * count them), the ids not in allowed (if not NULL) are skipped, return the
+ * number of ids, -1 if the file cannot be read */
+static int _read_id_list(const char *path, int *ids, int max_n_ids,
+                         const cpu_set_t *allowed) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) return -1;
+
+  char list[4096];
+  int n_ids = 0;
+  if (fgets(list, sizeof(list), file) != NULL) {
+    char *saveptr = NULL;
+    for (char *range = strtok_r(list, ",\n", &saveptr); range != NULL;
+         range = strtok_r(NULL, ",\n", &saveptr)) {
+      int start, end;
+      int n = sscanf(range, "%d-%d", &start, &end);
+      if (n < 1) continue;
+      if (n == 1) end = start;
+      for (int id = start; id <= end && (ids == NULL || n_ids < max_n_ids);
+           id++) {
+        if (allowed != NULL && (id >= CPU_SETSIZE || !CPU_ISSET(id, allowed)))
+          continue;
+        if (ids != NULL) ids[n_ids] = id;
+        n_ids++;
+      }
+    }
+  }
+  fclose(file);
+  return n_ids;
+}
+#endif
+
+int get_n_numa_nodes(void) {
+  int n_nodes = -1;
+#ifdef __linux__
+  n_nodes = _read_id_list("/sys/devices/system/node/online", NULL, 0, NULL);
+#endif
+  return n_nodes > 0 ? n_nodes : 1;
+}
+
+int get_numa_nodes(int *nodes, int max_n_nodes) {
+  int n_nodes = -1;
+#ifdef __linux__
+  n_nodes =
+      _read_id_list("/sys/devices/system/node/online", nodes, max_n_nodes, NULL);
+#endif
+  if (n_nodes <= 0 && max_n_nodes > 0) {
+    nodes[0] = 0;
+    n_nodes = 1;
+  }
+  return n_nodes;
+}
+
+int get_numa_node_cores(int node, int *cores, int max_n_cores) {
+  int n_cores_found = 0;
+#ifdef __linux__
+  /* skip the cores outside the affinity mask of the process, e.g., set by
+   * taskset or a cgroup cpuset, a pinned thread uses its mask before pinning */
+  cpu_set_t allowed = saved_cpuset;
+  bool has_allowed = has_saved_cpuset ||
+                     sched_getaffinity(0, sizeof(cpu_set_t), &allowed) == 0;
+#define CORE_ALLOWED(c) \
+  (!has_allowed || ((c) < CPU_SETSIZE && CPU_ISSET((c), &allowed)))
+
+  char path[128];
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+           node);
+  n_cores_found =
+      _read_id_list(path, cores, max_n_cores, has_allowed ? &allowed : NULL);
+
+  /* no topology information, all cores are on node 0 */
+  if (n_cores_found < 0) n_cores_found = 0;
+  if (access("/sys/devices/system/node", R_OK) != 0 && node == 0) {
+    int num_cores = sysconf(_SC_NPROCESSORS_CONF);
+    for (int c = 0; c < num_cores && n_cores_found < max_n_cores; c++) {
+      if (CORE_ALLOWED(c)) cores[n_cores_found++] = c;
+    }
+  }
+#undef CORE_ALLOWED
+#else
+  if (node == 0) {
+    int num_cores = get_n_cores();
+    for (int c = 0; c < num_cores && n_cores_found < max_n_cores; c++) {
+      cores[n_cores_found++] = c;
+    }
+  }
+#endif
+  return n_cores_found;
+}
+
 int get_n_cores(void) {
 #ifdef __linux__
 
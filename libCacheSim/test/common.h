@@ -254,6 +254,12 @@ static cache_t *create_test_cache(const char *alg_name,
     cache = S3FIFO_init(cc_params, "move-to-main-threshold=2");
   } else if (strcasecmp(alg_name, "Sieve") == 0) {
     cache = Sieve_init(cc_params, NULL);
+  } else if (strcasecmp(alg_name, "AdaptiveClimb") == 0) {
+    cache = AdaptiveClimb_init(cc_params, params);
+  } else if (strcasecmp(alg_name, "DynamicAdaptiveClimb") == 0) {
+    cache = DynamicAdaptiveClimb_init(cc_params, params);
+  } else if (strcasecmp(alg_name, "AdaptiveClimbSharded") == 0) {
+    cache = AdaptiveClimbSharded_init(cc_params, params);
   } else if (strcasecmp(alg_name, "Mithril") == 0) {
     cache = LRU_init(cc_params, NULL);
     cache->prefetcher =
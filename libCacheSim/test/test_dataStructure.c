@@ -0,0 +1,200 @@
+//
+// the data structures in libCacheSim/dataStructure
+//
+
+#include "../libCacheSim/dataStructure/orderStatTree.h"
+#include "../libCacheSim/dataStructure/slidingWindow.h"
+#include "common.h"
+
+#define OST_N_ELEM 2000
+#define OST_N_OP 20000
+
+// the tree must hold the same sequence as ref, and every node must know its
+// own position
+static void _check_ost(const ost_t *tree, intptr_t *ref, ost_node_t **nodes, int64_t n) {
+  g_assert_true(ost_verify(tree));
+  g_assert_cmpint(ost_size(tree), ==, n);
+  for (int64_t i = 0; i < n; i++) {
+    ost_node_t *node = ost_select(tree, i + 1);
+    g_assert_nonnull(node);
+    g_assert_cmpint((intptr_t)node->data, ==, ref[i]);
+    g_assert_true(node == nodes[ref[i]]);
+    g_assert_cmpint(ost_rank(node), ==, i + 1);
+  }
+  g_assert_null(ost_select(tree, 0));
+  g_assert_null(ost_select(tree, n + 1));
+}
+
+// move the element at index from to index to in ref
+static void _ref_move(intptr_t *ref, int64_t from, int64_t to) {
+  intptr_t v = ref[from];
+  if (from < to) {
+    memmove(&ref[from], &ref[from + 1], sizeof(intptr_t) * (to - from));
+  } else {
+    memmove(&ref[to + 1], &ref[to], sizeof(intptr_t) * (from - to));
+  }
+  ref[to] = v;
+}
+
+static void test_order_stat_tree(gconstpointer user_data) {
+  ost_t *tree = ost_create();
+  // ref is the expected sequence, the element is its own id and nodes[id]
+  // is the node the tree returned for it
+  intptr_t *ref = malloc(sizeof(intptr_t) * OST_N_ELEM);
+  ost_node_t **nodes = calloc(OST_N_ELEM, sizeof(ost_node_t *));
+  int64_t n = 0;
+  intptr_t next_id = 0;
+  uint64_t rand = 42;
+
+  _check_ost(tree, ref, nodes, 0);
+  for (; n < OST_N_ELEM / 2; n++) {
+    nodes[next_id] = n % 2 == 0 ? ost_push_back(tree, (void *)next_id) : ost_push_front(tree, (void *)next_id);
+    if (n % 2 == 0) {
+      ref[n] = next_id;
+    } else {
+      memmove(&ref[1], &ref[0], sizeof(intptr_t) * n);
+      ref[0] = next_id;
+    }
+    next_id++;
+  }
+  _check_ost(tree, ref, nodes, n);
+
+  for (int op = 0; op < OST_N_OP; op++) {
+    rand = rand * 6364136223846793005ULL + 1442695040888963407ULL;
+    int64_t i = (int64_t)((rand >> 33) % n);
+    int64_t j = (int64_t)((rand >> 13) % n);
+    switch ((rand >> 60) % 4) {
+      case 0:
+        ost_move(tree, nodes[ref[i]], j + 1);
+        _ref_move(ref, i, j);
+        break;
+      case 1:
+        if (i == j) break;
+        ost_move_before(tree, nodes[ref[i]], nodes[ref[j]]);
+        _ref_move(ref, i, i < j ? j - 1 : j);
+        break;
+      case 2:
+        // the removed node is reused by the next insert
+        if (n <= 1) break;
+        ost_remove(tree, nodes[ref[i]]);
+        nodes[ref[i]] = NULL;
+        memmove(&ref[i], &ref[i + 1], sizeof(intptr_t) * (n - i - 1));
+        n--;
+        break;
+      case 3:
+        if (n >= OST_N_ELEM) break;
+        // the ids of removed elements are reused
+        while (nodes[next_id] != NULL) next_id = (next_id + 1) % OST_N_ELEM;
+        nodes[next_id] = ost_insert_at(tree, j + 1, (void *)next_id);
+        memmove(&ref[j + 1], &ref[j], sizeof(intptr_t) * (n - j));
+        ref[j] = next_id;
+        n++;
+        break;
+    }
+    if (op % 1000 == 0) _check_ost(tree, ref, nodes, n);
+  }
+  _check_ost(tree, ref, nodes, n);
+
+  while (n > 0) {
+    ost_remove(tree, nodes[ref[n - 1]]);
+    n--;
+  }
+  _check_ost(tree, ref, nodes, 0);
+
+  ost_free(tree);
+  free(ref);
+  free(nodes);
+}
+
+// the window keeps the hits of the last window requests after it wraps
+// around, also when the window does not fill its last word
+static void test_sliding_window(gconstpointer user_data) {
+  int64_t window_sizes[] = {1, 64, 100, 1000};
+  for (int w = 0; w < 4; w++) {
+    int64_t window = window_sizes[w];
+    int64_t n_req = window * 5 + 7;
+    bool *hits = malloc(sizeof(bool) * n_req);
+    sliding_window_t *sw = sliding_window_create(window);
+    uint64_t rand = 42;
+
+    for (int64_t i = 0; i < n_req; i++) {
+      rand = rand * 6364136223846793005ULL + 1442695040888963407ULL;
+      hits[i] = (rand >> 40) % 3 != 0;
+      sliding_window_add(sw, hits[i]);
+
+      int64_t n_hit = 0;
+      for (int64_t j = i + 1 > window ? i + 1 - window : 0; j <= i; j++) n_hit += hits[j];
+      g_assert_cmpint(sliding_window_n_hit(sw), ==, n_hit);
+      g_assert_cmpint(sw->n_recorded, ==, i + 1 < window ? i + 1 : window);
+      g_assert_cmpint(sw->pos, ==, (i + 1) % window);
+    }
+    g_assert_cmpfloat(sliding_window_hit_ratio(sw), ==, (double)sliding_window_n_hit(sw) / window);
+
+    sliding_window_reset(sw);
+    g_assert_cmpint(sliding_window_n_hit(sw), ==, 0);
+    g_assert_cmpint(sw->pos, ==, 0);
+    sliding_window_free(sw);
+    free(hits);
+  }
+}
+
+// write the window and read it back into a window of window_size,
+// field_to_corrupt (if not NULL) is overwritten with val before the write
+static bool _sliding_window_reload(sliding_window_t *sw, int64_t window_size, int64_t *field_to_corrupt,
+                                   int64_t val) {
+  FILE *f = tmpfile();
+  int64_t old_val = field_to_corrupt != NULL ? *field_to_corrupt : 0;
+  if (field_to_corrupt != NULL) *field_to_corrupt = val;
+  g_assert_true(sliding_window_save(sw, f));
+  if (field_to_corrupt != NULL) *field_to_corrupt = old_val;
+  rewind(f);
+
+  sliding_window_t *loaded = sliding_window_create(window_size);
+  sliding_window_add(loaded, true);
+  bool ok = sliding_window_load(loaded, f);
+  if (ok) {
+    g_assert_cmpint(loaded->pos, ==, sw->pos);
+    g_assert_cmpint(loaded->n_recorded, ==, sw->n_recorded);
+    g_assert_cmpint(sliding_window_n_hit(loaded), ==, sliding_window_n_hit(sw));
+    for (int i = 0; i < 10; i++) {
+      sliding_window_add(loaded, i % 2);
+      sliding_window_add(sw, i % 2);
+      g_assert_cmpint(sliding_window_n_hit(loaded), ==, sliding_window_n_hit(sw));
+    }
+  } else {
+    /* a rejected window is not changed */
+    g_assert_cmpint(loaded->pos, ==, 1 % window_size);
+    g_assert_cmpint(sliding_window_n_hit(loaded), ==, 1);
+  }
+  sliding_window_free(loaded);
+  fclose(f);
+  return ok;
+}
+
+static void test_sliding_window_load(gconstpointer user_data) {
+  sliding_window_t *sw = sliding_window_create(100);
+  for (int i = 0; i < 30; i++) sliding_window_add(sw, i % 3 == 0);
+  g_assert_true(_sliding_window_reload(sw, 100, NULL, 0));
+  // before the window wraps around, pos must be the number recorded
+  g_assert_false(_sliding_window_reload(sw, 100, &sw->pos, 29));
+
+  for (int i = 0; i < 250; i++) sliding_window_add(sw, i % 3 == 0);
+  g_assert_true(_sliding_window_reload(sw, 100, NULL, 0));
+  g_assert_false(_sliding_window_reload(sw, 64, NULL, 0));
+  g_assert_false(_sliding_window_reload(sw, 200, NULL, 0));
+  g_assert_false(_sliding_window_reload(sw, 100, &sw->pos, 100));
+  g_assert_false(_sliding_window_reload(sw, 100, &sw->pos, -1));
+  g_assert_false(_sliding_window_reload(sw, 100, &sw->n_recorded, 101));
+  g_assert_false(_sliding_window_reload(sw, 100, &sw->n_hit, sw->n_hit + 1));
+  sliding_window_free(sw);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add_data_func("/libCacheSim/order_stat_tree", NULL, test_order_stat_tree);
+  g_test_add_data_func("/libCacheSim/sliding_window", NULL, test_sliding_window);
+  g_test_add_data_func("/libCacheSim/sliding_window_load", NULL, test_sliding_window_load);
+
+  return g_test_run();
+}
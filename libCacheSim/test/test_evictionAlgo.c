@@ -2,6 +2,8 @@
 // Created by Juncheng Yang on 11/21/19.
 //
 
+#include <math.h>
+
 #include "../libCacheSim/utils/include/mymath.h"
 #include "common.h"
 
@@ -56,7 +58,7 @@ static void test_LRU(gconstpointer user_data) {
   cache_t *cache = create_test_cache("LRU", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -77,7 +79,7 @@ static void test_Clock(gconstpointer user_data) {
   cache_t *cache = create_test_cache("Clock", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -98,7 +100,7 @@ static void test_FIFO(gconstpointer user_data) {
   cache_t *cache = create_test_cache("FIFO", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -123,7 +125,7 @@ static void test_Belady(gconstpointer user_data) {
   cache_t *cache = create_test_cache("Belady", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -148,7 +150,7 @@ static void test_BeladySize(gconstpointer user_data) {
   cache_t *cache = create_test_cache("BeladySize", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -169,7 +171,7 @@ static void test_Random(gconstpointer user_data) {
   cache_t *cache = create_test_cache("Random", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -190,7 +192,7 @@ static void test_LFU(gconstpointer user_data) {
   cache_t *cache = create_test_cache("LFU", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -211,7 +213,7 @@ static void test_LFUCpp(gconstpointer user_data) {
   cache_t *cache = create_test_cache("LFU", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -232,7 +234,7 @@ static void test_GDSF(gconstpointer user_data) {
   cache_t *cache = create_test_cache("GDSF", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -253,7 +255,7 @@ static void test_LHD(gconstpointer user_data) {
   cache_t *cache = create_test_cache("LHD", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -274,7 +276,7 @@ static void test_Hyperbolic(gconstpointer user_data) {
   cache_t *cache = create_test_cache("Hyperbolic", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -295,7 +297,7 @@ static void test_LeCaR(gconstpointer user_data) {
   cache_t *cache = create_test_cache("LeCaR", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -316,7 +318,7 @@ static void test_Cacheus(gconstpointer user_data) {
   cache_t *cache = create_test_cache("Cacheus", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -337,7 +339,7 @@ static void test_SR_LRU(gconstpointer user_data) {
   cache_t *cache = create_test_cache("SR_LRU", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -358,7 +360,7 @@ static void test_CR_LFU(gconstpointer user_data) {
   cache_t *cache = create_test_cache("CR_LFU", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -379,7 +381,7 @@ static void test_LFUDA(gconstpointer user_data) {
   cache_t *cache = create_test_cache("LFUDA", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -400,7 +402,7 @@ static void test_MRU(gconstpointer user_data) {
   cache_t *cache = create_test_cache("MRU", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -421,7 +423,7 @@ static void test_ARC(gconstpointer user_data) {
   cache_t *cache = create_test_cache("ARC", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -442,7 +444,7 @@ static void test_SLRU(gconstpointer user_data) {
   cache_t *cache = create_test_cache("SLRU", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -463,7 +465,7 @@ static void test_QDLP_FIFO(gconstpointer user_data) {
   cache_t *cache = create_test_cache("QDLP-FIFO", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -484,7 +486,7 @@ static void test_S3FIFO(gconstpointer user_data) {
   cache_t *cache = create_test_cache("S3-FIFO", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -505,13 +507,317 @@ static void test_Sieve(gconstpointer user_data) {
   cache_t *cache = create_test_cache("Sieve", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
+
+  print_results(cache, res);
+  _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
+                           miss_cnt_true, g_req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+}
+
+/**
+ * run the trace through one cache on the calling thread, this mirrors the
+ * single-cache simulate() used by cachesim
+ */
+static void _simulate_single_thread(reader_t *reader, cache_t *cache,
+                                    cache_stat_t *stat) {
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+  memset(stat, 0, sizeof(cache_stat_t));
+
+  read_one_req(cloned_reader, req);
+  int64_t start_ts = (int64_t)req->clock_time;
+  while (req->valid) {
+    req->clock_time -= start_ts;
+    stat->n_req++;
+    stat->n_req_byte += req->obj_size;
+    if (cache->get(cache, req) == false) {
+      stat->n_miss++;
+      stat->n_miss_byte += req->obj_size;
+    }
+    read_one_req(cloned_reader, req);
+  }
+
+  free_request(req);
+  close_reader(cloned_reader);
+}
+
+static void test_AdaptiveClimb(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("AdaptiveClimb", cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
+  print_results(cache, res);
+
+  /* the adaptive state is per instance, so the caches simulated concurrently
+   * must produce the same results as simulating them one at a time */
+  cache_stat_t stat;
+  for (uint64_t i = 0; i < CACHE_SIZE / STEP_SIZE; i++) {
+    cache_t *single_cache =
+        create_cache_with_new_size(cache, STEP_SIZE * (i + 1));
+    _simulate_single_thread(reader, single_cache, &stat);
+    g_assert_cmpuint(g_req_cnt_true, ==, res[i].n_req);
+    g_assert_cmpuint(g_req_byte_true, ==, res[i].n_req_byte);
+    g_assert_cmpuint(stat.n_req, ==, res[i].n_req);
+    g_assert_cmpuint(stat.n_miss, ==, res[i].n_miss);
+    g_assert_cmpuint(stat.n_miss_byte, ==, res[i].n_miss_byte);
+    single_cache->cache_free(single_cache);
+  }
+
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+}
+
+static void test_AdaptiveClimb_size_aware(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_stat_t stat, stat_size;
+
+  /* with a single size class, the class controller and the benefit scale
+   * reduce to the original AdaptiveClimb */
+  cache_t *cache = create_test_cache("AdaptiveClimb", cc_params, reader, NULL);
+  cache_t *size_cache = create_test_cache("AdaptiveClimb", cc_params, reader,
+                                          "size-aware=true,n-size-class=1");
+  _simulate_single_thread(reader, cache, &stat);
+  _simulate_single_thread(reader, size_cache, &stat_size);
+  g_assert_cmpuint(stat.n_miss, ==, stat_size.n_miss);
+  g_assert_cmpuint(stat.n_miss_byte, ==, stat_size.n_miss_byte);
+  cache->cache_free(cache);
+  size_cache->cache_free(size_cache);
+
+  /* the size classes partition the requests */
+  size_cache = create_test_cache("AdaptiveClimb", cc_params, reader,
+                                 "size-aware=true");
+  _simulate_single_thread(reader, size_cache, &stat_size);
+  climb_size_class_stat_t class_stats[16];
+  int n_class =
+      AdaptiveClimb_get_size_class_stats(size_cache, class_stats, 16);
+  g_assert_cmpint(n_class, ==, 16);
+  uint64_t n_req = 0, n_miss = 0, n_miss_byte = 0;
+  for (int i = 0; i < n_class; i++) {
+    n_req += class_stats[i].n_req;
+    n_miss += class_stats[i].n_miss;
+    n_miss_byte += class_stats[i].n_miss_byte;
+  }
+  g_assert_cmpuint(n_req, ==, stat_size.n_req);
+  g_assert_cmpuint(n_miss, ==, stat_size.n_miss);
+  g_assert_cmpuint(n_miss_byte, ==, stat_size.n_miss_byte);
+  size_cache->cache_free(size_cache);
+}
+
+static void test_AdaptiveClimbSharded(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_stat_t stat, stat_sharded;
+
+  /* one shard behaves the same as AdaptiveClimb */
+  cache_t *cache = create_test_cache("AdaptiveClimb", cc_params, reader, NULL);
+  cache_t *sharded_cache =
+      create_test_cache("AdaptiveClimbSharded", cc_params, reader, "n-shard=1");
+  _simulate_single_thread(reader, cache, &stat);
+  _simulate_single_thread(reader, sharded_cache, &stat_sharded);
+  g_assert_cmpuint(stat.n_req, ==, stat_sharded.n_req);
+  g_assert_cmpuint(stat.n_miss, ==, stat_sharded.n_miss);
+  g_assert_cmpuint(stat.n_miss_byte, ==, stat_sharded.n_miss_byte);
+  cache->cache_free(cache);
+  sharded_cache->cache_free(sharded_cache);
+
+  /* the global hit ratio combines all shards */
+  sharded_cache =
+      create_test_cache("AdaptiveClimbSharded", cc_params, reader, "n-shard=8");
+  _simulate_single_thread(reader, sharded_cache, &stat_sharded);
+  g_assert_cmpfloat(
+      fabs(AdaptiveClimbSharded_get_hit_ratio(sharded_cache) -
+           (1.0 - (double)stat_sharded.n_miss / stat_sharded.n_req)),
+      <=, 1e-9);
+  g_assert_cmpint(sharded_cache->get_occupied_byte(sharded_cache), <=,
+                  CACHE_SIZE);
+
+  /* find returns a copy, it stays readable after the object is removed */
+  request_t *req = new_request();
+  req->obj_id = 42;
+  req->obj_size = 100;
+  g_assert_true(sharded_cache->can_insert(sharded_cache, req));
+  sharded_cache->get(sharded_cache, req);
+  cache_obj_t *obj = sharded_cache->find(sharded_cache, req, false);
+  g_assert_true(obj != NULL);
+  g_assert_true(sharded_cache->remove(sharded_cache, req->obj_id));
+  g_assert_cmpuint(obj->obj_id, ==, 42);
+  g_assert_cmpuint(obj->obj_size, ==, 100);
+  g_assert_true(sharded_cache->find(sharded_cache, req, false) == NULL);
+  free_request(req);
+  sharded_cache->cache_free(sharded_cache);
+
+  /* each shard writes its own event log */
+  sharded_cache = create_test_cache("AdaptiveClimbSharded", cc_params, reader,
+                                    "n-shard=2,event-log=test_climb_event");
+  _simulate_single_thread(reader, sharded_cache, &stat_sharded);
+  sharded_cache->cache_free(sharded_cache);
+  for (int i = 0; i < 2; i++) {
+    char path[256];
+    snprintf(path, sizeof(path), "test_climb_event.shard%d.AdaptiveClimb.%ld",
+             i, (long)(CACHE_SIZE / 2));
+    g_assert_cmpint(access(path, F_OK), ==, 0);
+    remove(path);
+  }
+}
+
+static void test_DynamicAdaptiveClimb(gconstpointer user_data) {
+  /* a hit moves the object to the head, these are the miss counts of the
+   * promotion before climb-on-hit was added (with its 1.2 size boost) */
+  uint64_t miss_cnt_true[] = {93068, 86964, 82302, 75220,
+                              72104, 71930, 71202, 67729};
+  uint64_t miss_byte_true[] = {4198152704, 3934684672, 3698614784, 3277799936,
+                               3078128640, 3073416704, 3032304128, 2816406016};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("DynamicAdaptiveClimb", cc_params, reader,
+                                     "size-boost=1.2");
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
                            miss_cnt_true, g_req_byte_true, miss_byte_true);
   cache->cache_free(cache);
   my_free(sizeof(cache_stat_t), res);
+
+  /* climbing on hit is opt-in and changes the eviction order */
+  cache = create_test_cache("DynamicAdaptiveClimb", cc_params, reader,
+                            "size-boost=1.2,climb-on-hit=true");
+  g_assert_true(cache != NULL);
+  res = simulate_at_multi_sizes_with_step_size(reader, cache, STEP_SIZE, NULL,
+                                               0, 0, _n_cores(), NULL);
+  print_results(cache, res);
+  g_assert_cmpuint(res[0].n_req, ==, g_req_cnt_true);
+  g_assert_cmpuint(res[0].n_miss, !=, miss_cnt_true[0]);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+
+  /* get does not use cache_get_base, it times its own ops, op_latency is NULL
+   * when the latency is not tracked */
+  cc_params.cache_size = STEP_SIZE;
+  cache = create_test_cache("DynamicAdaptiveClimb", cc_params, reader, NULL);
+#ifdef TRACK_OP_LATENCY
+  cache_stat_t stat;
+  _simulate_single_thread(reader, cache, &stat);
+  const op_latency_t *lat = cache->op_latency;
+  g_assert_cmpuint(lat->n_req, ==, stat.n_req);
+  g_assert_cmpuint(lat->n_sampled[CACHE_OP_FIND], >, 0);
+  g_assert_cmpuint(lat->n_sampled[CACHE_OP_INSERT], >, 0);
+  g_assert_cmpuint(lat->n_sampled[CACHE_OP_EVICT], >, 0);
+  g_assert_cmpuint(lat->n_sampled_insert, ==,
+                   lat->n_sampled[CACHE_OP_INSERT]);
+  g_assert_cmpuint(op_latency_percentile(lat->hist[CACHE_OP_FIND],
+                                         lat->n_sampled[CACHE_OP_FIND], 0.5),
+                   >, 0);
+#else
+  g_assert_null(cache->op_latency);
+#endif
+  cache->cache_free(cache);
+}
+
+/* feed the requests left in reader to cache, return the number of misses */
+static uint64_t _run_to_end(reader_t *reader, cache_t *cache, int64_t n_req) {
+  request_t *req = new_request();
+  uint64_t n_miss = 0;
+  for (int64_t i = 0; n_req < 0 || i < n_req; i++) {
+    if (read_one_req(reader, req) != 0) break;
+    n_miss += cache->get(cache, req) ? 0 : 1;
+  }
+  free_request(req);
+  return n_miss;
+}
+
+/**
+ * a cache restored from a snapshot taken in the middle of the trace must
+ * end with the same misses as the cache that kept running
+ */
+static void test_snapshot(gconstpointer user_data) {
+  const char *algos[] = {"LRU",           "FIFO",
+                         "Sieve",         "S3-FIFO",
+                         "AdaptiveClimb", "DynamicAdaptiveClimb",
+                         "DynamicAdaptiveClimb"};
+  /* the position index of DynamicAdaptiveClimb is rebuilt on restore */
+  const char *params[] = {NULL, NULL, NULL, NULL, NULL, NULL,
+                          "climb-on-hit=true"};
+  const char *path = "test_snapshot.bin";
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE / 4, .hashpower = 20, .default_ttl = 0};
+
+  for (int i = 0; i < 7; i++) {
+    reader_t *cloned_reader = clone_reader(reader);
+    cache_t *cache =
+        create_test_cache(algos[i], cc_params, reader, params[i]);
+    _run_to_end(cloned_reader, cache, g_req_cnt_true / 2);
+    g_assert_true(cache_snapshot_save(cache, cloned_reader, path));
+    uint64_t n_miss = _run_to_end(cloned_reader, cache, -1);
+    close_reader(cloned_reader);
+
+    cloned_reader = clone_reader(reader);
+    cache_t *restored_cache =
+        create_test_cache(algos[i], cc_params, reader, params[i]);
+    g_assert_true(cache_snapshot_load(restored_cache, cloned_reader, path));
+    uint64_t n_miss_restored = _run_to_end(cloned_reader, restored_cache, -1);
+    close_reader(cloned_reader);
+
+    g_assert_cmpuint(n_miss, ==, n_miss_restored);
+    g_assert_cmpint(cache->get_n_obj(cache), ==,
+                    restored_cache->get_n_obj(restored_cache));
+    cache->cache_free(cache);
+    restored_cache->cache_free(restored_cache);
+  }
+  remove(path);
+}
+
+/**
+ * restoring a truncated snapshot must fail instead of aborting
+ */
+static void test_snapshot_truncated(gconstpointer user_data) {
+  const char *algos[] = {"LRU",           "FIFO",
+                         "Sieve",         "S3-FIFO",
+                         "AdaptiveClimb", "DynamicAdaptiveClimb"};
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE / 4, .hashpower = 20, .default_ttl = 0};
+
+  for (int i = 0; i < 6; i++) {
+    reader_t *cloned_reader = clone_reader(reader);
+    cache_t *cache = create_test_cache(algos[i], cc_params, reader, NULL);
+    _run_to_end(cloned_reader, cache, g_req_cnt_true / 2);
+    close_reader(cloned_reader);
+
+    char *buf;
+    size_t size;
+    g_assert_true(cache_snapshot_to_buf(cache, &buf, &size));
+    size_t truncated_size[] = {0, 16, size / 2, size - 1};
+    for (int j = 0; j < 4; j++) {
+      cache_t *restored_cache =
+          create_test_cache(algos[i], cc_params, reader, NULL);
+      g_assert_false(
+          cache_snapshot_from_buf(restored_cache, buf, truncated_size[j]));
+      restored_cache->cache_free(restored_cache);
+    }
+
+    cache_t *restored_cache =
+        create_test_cache(algos[i], cc_params, reader, NULL);
+    g_assert_true(cache_snapshot_from_buf(restored_cache, buf, size));
+    g_assert_cmpint(cache->get_n_obj(cache), ==,
+                    restored_cache->get_n_obj(restored_cache));
+    restored_cache->cache_free(restored_cache);
+    cache->cache_free(cache);
+    free(buf);
+  }
 }
 
 static void test_WTinyLFU(gconstpointer user_data) {
@@ -530,7 +836,7 @@ static void test_LIRS(gconstpointer user_data) {
   cache_t *cache = create_test_cache("LIRS", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true,
@@ -570,6 +876,18 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func("/libCacheSim/cacheAlgo_Hyperbolic", reader,
                        test_Hyperbolic);
   g_test_add_data_func("/libCacheSim/cacheAlgo_LIRS", reader, test_LIRS);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_AdaptiveClimb", reader,
+                       test_AdaptiveClimb);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_AdaptiveClimb_size_aware",
+                       reader, test_AdaptiveClimb_size_aware);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_snapshot", reader,
+                       test_snapshot);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_snapshot_truncated", reader,
+                       test_snapshot_truncated);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_AdaptiveClimbSharded", reader,
+                       test_AdaptiveClimbSharded);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_DynamicAdaptiveClimb", reader,
+                       test_DynamicAdaptiveClimb);
 
   g_test_add_data_func("/libCacheSim/cacheAlgo_Clock", reader, test_Clock);
   g_test_add_data_func("/libCacheSim/cacheAlgo_FIFO", reader, test_FIFO);
@@ -45,7 +45,7 @@ static void test_GLCache_ORACLE_LOG(gconstpointer user_data) {
       create_test_cache("GLCache-OracleLog", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
   print_results(cache, res);
   _verify_profiler_results(res, GLCache_CACHE_SIZE / GLCache_STEP_SIZE,
                            req_cnt_true, miss_cnt_true);
@@ -66,7 +66,7 @@ static void test_GLCache_ORACLE_ITEM(gconstpointer user_data) {
       create_test_cache("GLCache-OracleItem", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, GLCache_CACHE_SIZE / GLCache_STEP_SIZE,
@@ -89,7 +89,7 @@ static void test_GLCache_ORACLE_BOTH(gconstpointer user_data) {
       create_test_cache("GLCache-OracleBoth", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, GLCache_CACHE_SIZE / GLCache_STEP_SIZE,
@@ -111,7 +111,7 @@ static void test_GLCache_LEARNED_TRUE_Y(gconstpointer user_data) {
       create_test_cache("GLCache-LearnedTrueY", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, GLCache_CACHE_SIZE / GLCache_STEP_SIZE,
@@ -134,7 +134,7 @@ static void test_GLCache_LEARNED_ONLINE(gconstpointer user_data) {
       create_test_cache("GLCache-LearnedOnline", cc_params, reader, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, GLCache_STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   print_results(cache, res);
   _verify_profiler_results(res, GLCache_CACHE_SIZE / GLCache_STEP_SIZE,
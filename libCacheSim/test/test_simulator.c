@@ -2,6 +2,12 @@
 // Created by Juncheng Yang on 11/21/19.
 //
 
+#define _GNU_SOURCE
+
+#include <sched.h>
+
+#include "../libCacheSim/profiler/simCheckpoint.h"
+#include "../libCacheSim/utils/include/mysys.h"
 #include "common.h"
 
 /**
@@ -23,7 +29,7 @@ static void test_simulator_no_size(gconstpointer user_data) {
   cache_t *cache = LRU_init(cc_params, NULL);
   g_assert_true(cache != NULL);
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, step_size, NULL, 0, 0, _n_cores());
+      reader, cache, step_size, NULL, 0, 0, _n_cores(), NULL);
 
   //  uint64_t* mc = _get_lru_miss_cnt(reader, get_num_of_req(reader));
 
@@ -68,7 +74,7 @@ static void test_simulator(gconstpointer user_data) {
   g_assert_true(cache != NULL);
 
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
   // for (uint64_t i = 0; i < CACHE_SIZE / STEP_SIZE; i++) {
   //   printf(
   //       "cache size: %lu, n_req: %lu, n_req_byte: %lu, n_miss: %8lu %16lu\n
@@ -88,7 +94,7 @@ static void test_simulator(gconstpointer user_data) {
   uint64_t cache_sizes[] = {STEP_SIZE, STEP_SIZE * 2, STEP_SIZE * 4,
                             STEP_SIZE * 7};
   res = simulate_at_multi_sizes(reader, cache, 4, cache_sizes, NULL, 0, 0,
-                                _n_cores());
+                                _n_cores(), NULL);
   g_assert_cmpuint(res[0].cache_size, ==, STEP_SIZE);
   g_assert_cmpuint(res[1].n_req_byte, ==, req_byte_true);
   g_assert_cmpuint(res[3].n_req, ==, req_cnt_true);
@@ -107,7 +113,7 @@ static void test_simulator(gconstpointer user_data) {
   }
 
   res = simulate_with_multi_caches(reader, caches, 4, NULL, 0, 0, _n_cores(),
-                                   false);
+                                   false, NULL);
   g_assert_cmpuint(res[0].cache_size, ==, STEP_SIZE);
   g_assert_cmpuint(res[1].n_req_byte, ==, req_byte_true);
   g_assert_cmpuint(res[3].n_req, ==, req_cnt_true);
@@ -139,7 +145,7 @@ static void test_simulator_with_warmup1(gconstpointer user_data) {
   g_assert_true(cache != NULL);
 
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, reader, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, reader, 0, 0, _n_cores(), NULL);
 
   for (uint64_t i = 0; i < CACHE_SIZE / STEP_SIZE; i++) {
     // printf("cache size: %lu, n_req: %lu, n_req_byte: %lu, n_miss: %8lu
@@ -171,7 +177,7 @@ static void test_simulator_with_warmup2(gconstpointer user_data) {
   g_assert_true(cache != NULL);
 
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0.2, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0.2, 0, _n_cores(), NULL);
 
   for (uint64_t i = 0; i < CACHE_SIZE / STEP_SIZE; i++) {
     // printf("cache size: %lu, n_req: %lu, n_req_byte: %lu, n_miss: %8lu
@@ -189,6 +195,299 @@ static void test_simulator_with_warmup2(gconstpointer user_data) {
   cache->cache_free(cache);
 }
 
+/**
+ * decoding the trace once must produce the same results as one reader per
+ * cache, with and without warmup, Random checks that the caches sharing a
+ * worker do not share the random stream
+ */
+static void test_simulator_shared_decode(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE,
+                                     .default_ttl = 0};
+  double warmup_fracs[] = {0, 0.2};
+
+  for (int w = 0; w < 4; w++) {
+    bool random = w >= 2;
+    cache_t *caches[8], *shared_caches[8];
+    for (int i = 0; i < 8; i++) {
+      cc_params.cache_size = STEP_SIZE * (i + 1);
+      caches[i] = random ? Random_init(cc_params, NULL)
+                         : LRU_init(cc_params, NULL);
+      shared_caches[i] = random ? Random_init(cc_params, NULL)
+                                : LRU_init(cc_params, NULL);
+    }
+
+    cache_stat_t *res =
+        simulate_with_multi_caches(reader, caches, 8, NULL, warmup_fracs[w % 2],
+                                   0, _n_cores(), true, NULL);
+    cache_stat_t *shared_res = simulate_with_multi_caches_shared_decode(
+        reader, shared_caches, 8, NULL, warmup_fracs[w % 2], 0, 2, true, NULL);
+    for (int i = 0; i < 8; i++) {
+      g_assert_cmpuint(shared_res[i].cache_size, ==, res[i].cache_size);
+      g_assert_cmpuint(shared_res[i].n_warmup_req, ==, res[i].n_warmup_req);
+      g_assert_cmpuint(shared_res[i].n_req, ==, res[i].n_req);
+      g_assert_cmpuint(shared_res[i].n_req_byte, ==, res[i].n_req_byte);
+      g_assert_cmpuint(shared_res[i].n_miss, ==, res[i].n_miss);
+      g_assert_cmpuint(shared_res[i].n_miss_byte, ==, res[i].n_miss_byte);
+    }
+    g_free(res);
+    g_free(shared_res);
+  }
+}
+
+/**
+ * pinning the simulation threads must not change the results
+ */
+static void test_simulator_pinned(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE,
+                                     .default_ttl = 0};
+  cache_t *cache = LRU_init(cc_params, NULL);
+  g_assert_true(cache != NULL);
+
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
+
+  sim_thread_placement_e placements[] = {SIM_THREAD_PIN, SIM_THREAD_NUMA};
+  for (int p = 0; p < 2; p++) {
+    sim_params_t sim_params = {.thread_placement = placements[p]};
+    cache_stat_t *pinned_res = simulate_at_multi_sizes_with_step_size(
+        reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), &sim_params);
+    for (uint64_t i = 0; i < CACHE_SIZE / STEP_SIZE; i++) {
+      g_assert_cmpuint(pinned_res[i].cache_size, ==, res[i].cache_size);
+      g_assert_cmpuint(pinned_res[i].n_req, ==, res[i].n_req);
+      g_assert_cmpuint(pinned_res[i].n_miss, ==, res[i].n_miss);
+      g_assert_cmpuint(pinned_res[i].n_miss_byte, ==, res[i].n_miss_byte);
+    }
+    g_free(pinned_res);
+  }
+  g_free(res);
+
+  cache->cache_free(cache);
+
+  /* the node ids are the online nodes, which may not be contiguous */
+  int n_node = get_n_numa_nodes();
+  int *nodes = g_new(int, n_node);
+  g_assert_cmpint(get_numa_nodes(nodes, n_node), ==, n_node);
+  for (int i = 1; i < n_node; i++) {
+    g_assert_cmpint(nodes[i], >, nodes[i - 1]);
+  }
+  g_free(nodes);
+
+#ifdef __linux__
+  /* the cores are within the affinity mask, and a pinned thread gets its
+   * mask back when it is unpinned */
+  cpu_set_t mask, restored_mask;
+  g_assert_cmpint(sched_getaffinity(0, sizeof(cpu_set_t), &mask), ==, 0);
+  int cores[CPU_SETSIZE];
+  int n_core = get_numa_node_cores(0, cores, CPU_SETSIZE);
+  for (int i = 0; i < n_core; i++) {
+    g_assert_true(CPU_ISSET(cores[i], &mask));
+  }
+  if (n_core > 0) {
+    set_thread_affinity_to_core(pthread_self(), cores[n_core - 1]);
+    reset_thread_affinity(pthread_self());
+    g_assert_cmpint(
+        sched_getaffinity(0, sizeof(cpu_set_t), &restored_mask), ==, 0);
+    g_assert_true(CPU_EQUAL(&mask, &restored_mask));
+  }
+#endif
+}
+
+static void test_simulator_forks(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 2,
+                                     .default_ttl = 0};
+  const char *params[] = {NULL, "max-k=500", "adjustment-interval=100"};
+  cache_t *caches[3], *forks[3];
+  for (int i = 0; i < 3; i++) {
+    caches[i] = AdaptiveClimb_init(cc_params, params[i]);
+    forks[i] = AdaptiveClimb_init(cc_params, params[i]);
+  }
+  cache_t *warm_cache = AdaptiveClimb_init(cc_params, NULL);
+
+  cache_stat_t *res = simulate_with_multi_caches(reader, caches, 3, NULL, 0.5,
+                                                 0, _n_cores(), true, NULL);
+  cache_stat_t *fork_res = simulate_forks_from_warmup(
+      reader, warm_cache, forks, 3, NULL, 0.5, 0, _n_cores(), true, NULL);
+
+  /* the first fork has the same parameters as the warmed-up cache */
+  g_assert_cmpuint(fork_res[0].n_warmup_req, ==, res[0].n_warmup_req);
+  g_assert_cmpuint(fork_res[0].n_miss, ==, res[0].n_miss);
+  g_assert_cmpuint(fork_res[0].n_miss_byte, ==, res[0].n_miss_byte);
+  for (int i = 0; i < 3; i++) {
+    g_assert_cmpuint(fork_res[i].n_req, ==, res[i].n_req);
+    g_assert_cmpuint(fork_res[i].n_req_byte, ==, res[i].n_req_byte);
+  }
+
+  g_free(res);
+  g_free(fork_res);
+  warm_cache->cache_free(warm_cache);
+}
+
+/* the columns of each cache in the interval output add up to its result */
+static void _check_interval_output(const char *path, const cache_stat_t *res,
+                                   uint32_t n_cache_true) {
+  FILE *ifile = fopen(path, "rb");
+  g_assert_true(ifile != NULL);
+  char magic[8];
+  uint32_t version, n_cache;
+  g_assert_cmpint(fread(magic, 8, 1, ifile), ==, 1);
+  g_assert_cmpstr(magic, ==, "LCSSERS");
+  g_assert_cmpint(fread(&version, 4, 1, ifile), ==, 1);
+  g_assert_cmpint(fread(&n_cache, 4, 1, ifile), ==, 1);
+  g_assert_cmpuint(n_cache, ==, n_cache_true);
+  for (uint32_t i = 0; i < n_cache; i++) {
+    char cache_name[CACHE_NAME_ARRAY_LEN];
+    int64_t cache_size, n_interval;
+    g_assert_cmpint(fread(cache_name, CACHE_NAME_ARRAY_LEN, 1, ifile), ==, 1);
+    g_assert_cmpint(fread(&cache_size, 8, 1, ifile), ==, 1);
+    g_assert_cmpint(fread(&n_interval, 8, 1, ifile), ==, 1);
+    g_assert_cmpuint(cache_size, ==, res[i].cache_size);
+    g_assert_cmpint(n_interval, >, 1);
+
+    /* end_ts, n_req, n_miss, n_req_byte, n_miss_byte, n_evict, mqps */
+    int64_t sum[6] = {0};
+    int64_t *column = g_new(int64_t, n_interval);
+    for (int c = 0; c < 6; c++) {
+      g_assert_cmpint(fread(column, 8, n_interval, ifile), ==, n_interval);
+      for (int64_t j = 0; j < n_interval; j++) sum[c] += column[j];
+    }
+    g_assert_cmpint(fread(column, 8, n_interval, ifile), ==, n_interval);
+    g_free(column);
+    g_assert_cmpuint(sum[1], ==, res[i].n_req);
+    g_assert_cmpuint(sum[2], ==, res[i].n_miss);
+    g_assert_cmpuint(sum[3], ==, res[i].n_req_byte);
+    g_assert_cmpuint(sum[4], ==, res[i].n_miss_byte);
+    /* every miss is inserted, the ones not in the cache were evicted */
+    g_assert_cmpint(sum[5], >, 0);
+    g_assert_cmpint(sum[5], ==, (int64_t)res[i].n_miss - res[i].n_obj);
+  }
+  fclose(ifile);
+}
+
+static void test_simulator_interval_output(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE,
+                                     .default_ttl = 0};
+  sim_params_t sim_params = {.interval_sec = 60,
+                             .interval_output_path = "test_interval.bin"};
+  /* DynamicAdaptiveClimb evicts in its own insert and AdaptiveClimbSharded
+   * in its shards, neither goes through cache_get_base */
+  cache_t *caches[3] = {LRU_init(cc_params, NULL),
+                        DynamicAdaptiveClimb_init(cc_params, NULL),
+                        AdaptiveClimbSharded_init(cc_params, "n-shard=4")};
+
+  for (int k = 0; k < 3; k++) {
+    cache_t *cache = caches[k];
+    g_assert_true(cache != NULL);
+
+    cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
+        reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), &sim_params);
+    _check_interval_output("test_interval.bin", res, CACHE_SIZE / STEP_SIZE);
+    remove("test_interval.bin");
+
+    g_free(res);
+    cache->cache_free(cache);
+  }
+
+  /* the shared decode writes the same series */
+  cache_t *shared_caches[4];
+  for (int i = 0; i < 4; i++) {
+    cc_params.cache_size = STEP_SIZE * (i + 1);
+    shared_caches[i] = i % 2 == 0 ? LRU_init(cc_params, NULL)
+                                  : DynamicAdaptiveClimb_init(cc_params, NULL);
+  }
+  cache_stat_t *res = simulate_with_multi_caches_shared_decode(
+      reader, shared_caches, 4, NULL, 0, 0, 2, true, &sim_params);
+  _check_interval_output("test_interval.bin", res, 4);
+  remove("test_interval.bin");
+  g_free(res);
+}
+
+/**
+ * a checkpointed simulation has the same result as one run in one segment,
+ * and a simulation resumes from the checkpoint it finds
+ */
+static void test_simulator_checkpoint(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE,
+                                     .default_ttl = 0};
+  sim_params_t sim_params = {.checkpoint_n_req = 10000,
+                             .checkpoint_dir = "."};
+  char path[SIM_CHECKPOINT_PATH_LEN];
+
+  /* Random does not support snapshots and runs in one segment */
+  cache_t *caches[4] = {LRU_init(cc_params, NULL), S3FIFO_init(cc_params, NULL),
+                        AdaptiveClimb_init(cc_params, NULL),
+                        Random_init(cc_params, NULL)};
+  cache_t *ckpt_caches[4] = {
+      LRU_init(cc_params, NULL), S3FIFO_init(cc_params, NULL),
+      AdaptiveClimb_init(cc_params, NULL), Random_init(cc_params, NULL)};
+  cache_stat_t *res =
+      simulate_with_multi_caches(reader, caches, 4, NULL, 0, 0, 2, true, NULL);
+  for (int i = 0; i < 4; i++) {
+    sim_checkpoint_path(".", i, ckpt_caches[i], path, sizeof(path));
+    remove(path);
+  }
+  cache_stat_t *ckpt_res = simulate_with_multi_caches(
+      reader, ckpt_caches, 4, NULL, 0, 0, 2, false, &sim_params);
+  for (int i = 0; i < 4; i++) {
+    g_assert_cmpuint(ckpt_res[i].n_req, ==, res[i].n_req);
+    g_assert_cmpuint(ckpt_res[i].n_req_byte, ==, res[i].n_req_byte);
+    g_assert_cmpuint(ckpt_res[i].n_miss, ==, res[i].n_miss);
+    g_assert_cmpuint(ckpt_res[i].n_miss_byte, ==, res[i].n_miss_byte);
+    g_assert_cmpint(ckpt_res[i].n_obj, ==, res[i].n_obj);
+    /* the checkpoint is removed when the simulation finishes */
+    sim_checkpoint_path(".", i, ckpt_caches[i], path, sizeof(path));
+    g_assert_true(access(path, F_OK) != 0);
+    ckpt_caches[i]->cache_free(ckpt_caches[i]);
+  }
+  g_free(ckpt_res);
+
+  /* stop an LRU after 30000 requests and save its checkpoint, the marker in
+   * n_warmup_req shows that the simulation below resumes from it */
+  cache_t *cache = LRU_init(cc_params, NULL);
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+  sim_checkpoint_t ckpt;
+  memset(&ckpt, 0, sizeof(ckpt));
+  read_one_req(cloned_reader, req);
+  ckpt.start_ts = (int64_t)req->clock_time;
+  ckpt.result.cache_size = cache->cache_size;
+  ckpt.result.n_warmup_req = 12345;
+  strncpy(ckpt.result.cache_name, cache->cache_name, CACHE_NAME_ARRAY_LEN);
+  while (ckpt.result.n_req < 30000) {
+    req->clock_time -= ckpt.start_ts;
+    if (!cache->get(cache, req)) {
+      ckpt.result.n_miss++;
+      ckpt.result.n_miss_byte += req->obj_size;
+    }
+    ckpt.result.n_req++;
+    ckpt.result.n_req_byte += req->obj_size;
+    read_one_req(cloned_reader, req);
+  }
+  ckpt.next_req = *req;
+  sim_checkpoint_path(".", 0, cache, path, sizeof(path));
+  g_assert_true(sim_checkpoint_save(path, &ckpt, cache, cloned_reader));
+  free_request(req);
+  close_reader(cloned_reader);
+  cache->cache_free(cache);
+
+  cache_t *resumed_cache = LRU_init(cc_params, NULL);
+  cache_stat_t *resumed_res = simulate_with_multi_caches(
+      reader, &resumed_cache, 1, NULL, 0, 0, 1, true, &sim_params);
+  g_assert_cmpuint(resumed_res[0].n_warmup_req, ==, 12345);
+  g_assert_cmpuint(resumed_res[0].n_req, ==, res[0].n_req);
+  g_assert_cmpuint(resumed_res[0].n_req_byte, ==, res[0].n_req_byte);
+  g_assert_cmpuint(resumed_res[0].n_miss, ==, res[0].n_miss);
+  g_assert_cmpuint(resumed_res[0].n_miss_byte, ==, res[0].n_miss_byte);
+  g_assert_cmpint(resumed_res[0].n_obj, ==, res[0].n_obj);
+  g_assert_true(access(path, F_OK) != 0);
+  g_free(resumed_res);
+  g_free(res);
+}
+
 static void test_simulator_with_ttl(gconstpointer user_data) {
   uint64_t req_cnt_true = 113872, req_byte_true = 4205978112;
   uint64_t miss_cnt_true[] = {93240, 87890, 83268, 81743,
@@ -203,7 +502,7 @@ static void test_simulator_with_ttl(gconstpointer user_data) {
   g_assert_true(cache != NULL);
 
   cache_stat_t *res = simulate_at_multi_sizes_with_step_size(
-      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores());
+      reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), NULL);
 
   for (uint64_t i = 0; i < CACHE_SIZE / STEP_SIZE; i++) {
     printf("cache size: %lu, n_req: %ld, n_req_byte: %ld, n_miss: %8ld %16ld\n",
@@ -257,6 +556,30 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func_full("/libCacheSim/simulator_warmup2", reader,
                             test_simulator_with_warmup2, test_teardown);
 
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_shared_decode", reader,
+                            test_simulator_shared_decode, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_pinned", reader,
+                            test_simulator_pinned, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_forks", reader,
+                            test_simulator_forks, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_interval_output", reader,
+                            test_simulator_interval_output, test_teardown);
+
+  reader = setup_vscsi_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_checkpoint_vscsi", reader,
+                            test_simulator_checkpoint, test_teardown);
+
+  reader = setup_oracleGeneralBin_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_checkpoint_oracleGeneral",
+                            reader, test_simulator_checkpoint, test_teardown);
+
 #ifdef SUPPORT_TTL
   reader = setup_vscsi_reader();
   g_test_add_data_func_full("/libCacheSim/simulator_with_ttl", reader,
@@ -4,6 +4,11 @@
 
 #include "common.h"
 
+#include "../libCacheSim/traceReader/generalReader/columnar.h"
+#ifdef SUPPORT_ZSTD_TRACE
+#include <zstd.h>
+#endif
+
 // defined in reader.c file, not in public interface
 int go_back_two_req(reader_t *const reader);
 
@@ -150,6 +155,380 @@ void test_twr(gconstpointer user_data) {
          (unsigned long long)n_obj);
 }
 
+void test_reader_synthetic(gconstpointer user_data) {
+  const char *spec = "zipf:n_obj=1000,n_req=100000,alpha=1.0,seed=42";
+  reader_t *reader = setup_reader(spec, SYNTHETIC_TRACE, NULL);
+  request_t *req = new_request();
+  uint64_t n_req = get_num_of_req(reader);
+  g_assert_true(n_req == 100000);
+
+  uint64_t *obj_ids = g_new(uint64_t, n_req);
+  uint64_t n_top = 0, i = 0;
+  while (read_one_req(reader, req) == 0) {
+    g_assert_true(req->obj_id < 1000);
+    obj_ids[i++] = req->obj_id;
+    n_top += req->obj_id == 0;
+  }
+  g_assert_true(i == n_req);
+  /* the most popular object gets 1 / H(1000) = 13.4% of the requests */
+  g_assert_cmpfloat(fabs((double)n_top / n_req - 0.1336), <, 0.01);
+
+  // the same seed generates the same trace from any position
+  reader_t *cloned_reader = clone_reader(reader);
+  reader_pos_t pos = {.n_read_req = n_req / 2,
+                      .offset = (int64_t)(n_req / 2),
+                      .n_req_left = 0,
+                      .last_req_clock_time = -1};
+  g_assert_true(reader_set_pos(cloned_reader, &pos));
+  for (i = n_req / 2; i < n_req; i++) {
+    read_one_req(cloned_reader, req);
+    g_assert_true(req->obj_id == obj_ids[i]);
+  }
+  g_assert_true(read_one_req(cloned_reader, req) == 1);
+
+  read_last_req(reader, req);
+  g_assert_true(req->obj_id == obj_ids[n_req - 1]);
+  close_reader(cloned_reader);
+  close_reader(reader);
+
+  // scan requests are never repeated
+  reader = setup_reader("scan:n_obj=1000,n_req=100000,scan_len=100",
+                        SYNTHETIC_TRACE, NULL);
+  uint64_t n_scan = 0, last_scan_id = 0;
+  while (read_one_req(reader, req) == 0) {
+    if (req->obj_id < 1000) continue;
+    g_assert_true(n_scan == 0 || req->obj_id > last_scan_id);
+    last_scan_id = req->obj_id;
+    n_scan++;
+  }
+  g_assert_cmpfloat(fabs((double)n_scan / n_req - 0.2), <, 0.05);
+  close_reader(reader);
+
+  g_free(obj_ids);
+  free_request(req);
+}
+
+void test_reader_columnar(gconstpointer user_data) {
+  reader_init_param_t init_params = default_reader_init_params();
+  init_params.ignore_size_zero_req = false;
+  char data_path[1024];
+  _detect_data_path(data_path, "cloudPhysicsIO.oracleGeneral.bin");
+  reader_t *reader =
+      setup_reader(data_path, ORACLE_GENERAL_TRACE, &init_params);
+  request_t *req = new_request();
+  request_t *req_columnar = new_request();
+
+  // small blocks so that the trace has many of them
+  columnar_writer_t *writer = open_columnar_writer("test.columnar", 1000);
+  while (read_one_req(reader, req) == 0) {
+    columnar_writer_append(writer, req->clock_time, req->obj_id, req->obj_size,
+                           req->next_access_vtime);
+  }
+  uint64_t trace_size = close_columnar_writer(writer, 0, 0, 0);
+  g_assert_true(trace_size < get_num_of_req(reader) * 24 / 2);
+
+  reader_t *reader_columnar =
+      setup_reader("test.columnar", COLUMNAR_TRACE, &init_params);
+  g_assert_true(get_num_of_req(reader_columnar) == get_num_of_req(reader));
+  reset_reader(reader);
+  while (read_one_req(reader, req) == 0) {
+    g_assert_true(read_one_req(reader_columnar, req_columnar) == 0);
+    g_assert_true(req->clock_time == req_columnar->clock_time);
+    g_assert_true(req->obj_id == req_columnar->obj_id);
+    g_assert_true(req->obj_size == req_columnar->obj_size);
+    g_assert_true(req->next_access_vtime == req_columnar->next_access_vtime);
+  }
+  g_assert_true(read_one_req(reader_columnar, req_columnar) == 1);
+
+  // the decoded blocks are copied to the batch
+  reset_reader(reader);
+  reset_reader(reader_columnar);
+  req_batch_t *batch = new_req_batch(4096);
+  while (read_n_req(reader_columnar, batch, 4096) > 0) {
+    for (int i = 0; i < batch->n_req; i++) {
+      g_assert_true(read_one_req(reader, req) == 0);
+      g_assert_true(req->clock_time == batch->clock_time[i]);
+      g_assert_true(req->obj_id == batch->obj_id[i]);
+      g_assert_true(req->obj_size == batch->obj_size[i]);
+      g_assert_true(req->next_access_vtime == batch->next_access_vtime[i]);
+    }
+  }
+  g_assert_true(read_one_req(reader, req) == 1);
+  free_req_batch(batch);
+
+  // any request can be read after moving the reader
+  reader_t *cloned_reader = clone_reader(reader_columnar);
+  reader_set_read_pos(reader, 0.5);
+  reader_set_read_pos(cloned_reader, 0.5);
+  read_one_req(reader, req);
+  read_one_req(cloned_reader, req_columnar);
+  g_assert_true(req->obj_id == req_columnar->obj_id);
+  read_last_req(reader, req);
+  read_last_req(cloned_reader, req_columnar);
+  g_assert_true(req->obj_id == req_columnar->obj_id);
+
+  close_reader(cloned_reader);
+  close_reader(reader_columnar);
+  close_reader(reader);
+  free_request(req);
+  free_request(req_columnar);
+  remove("test.columnar");
+}
+
+/* a block with more than 256 distinct sizes uses 16-bit codes of the
+ * dictionary, which follow the varint dictionary and are not aligned */
+void test_reader_columnar_size_dict16(gconstpointer user_data) {
+  const int n_req = 20000;
+  columnar_writer_t *writer = open_columnar_writer("test.columnar", 4096);
+  for (int i = 0; i < n_req; i++) {
+    columnar_writer_append(writer, i, i, 100000 + (i * 7919 % 300) * 4096, -1);
+  }
+  close_columnar_writer(writer, n_req, 0, 0);
+
+  reader_init_param_t init_params = default_reader_init_params();
+  reader_t *reader =
+      setup_reader("test.columnar", COLUMNAR_TRACE, &init_params);
+  columnar_params_t *params = reader->reader_params;
+  request_t *req = new_request();
+  for (int i = 0; i < n_req; i++) {
+    g_assert_true(read_one_req(reader, req) == 0);
+    if (i == 0) {
+      columnar_block_header_t bh;
+      memcpy(&bh, params->mapped_file + params->block_offset[0], sizeof(bh));
+      g_assert_cmpint(bh.size_codec, ==, COLUMNAR_SIZE_DICT16);
+    }
+    g_assert_cmpint(req->obj_id, ==, i);
+    g_assert_cmpint(req->obj_size, ==, 100000 + (i * 7919 % 300) * 4096);
+  }
+  g_assert_true(read_one_req(reader, req) == 1);
+
+  close_reader(reader);
+  free_request(req);
+  remove("test.columnar");
+}
+
+#ifdef SUPPORT_ZSTD_TRACE
+/* compress the trace in frames of frame_size bytes, which does not divide the
+ * 24-byte requests, so some requests span two frames */
+static void _compress_in_frames(const char *src_path, const char *dst_path,
+                                size_t frame_size) {
+  FILE *ifile = fopen(src_path, "rb");
+  FILE *ofile = fopen(dst_path, "wb");
+  g_assert_true(ifile != NULL && ofile != NULL);
+  char *buf = g_malloc(frame_size);
+  size_t comp_buf_size = ZSTD_compressBound(frame_size);
+  char *comp_buf = g_malloc(comp_buf_size);
+  size_t n;
+  while ((n = fread(buf, 1, frame_size, ifile)) > 0) {
+    size_t comp_size = ZSTD_compress(comp_buf, comp_buf_size, buf, n, 3);
+    g_assert_false(ZSTD_isError(comp_size));
+    g_assert_true(fwrite(comp_buf, 1, comp_size, ofile) == comp_size);
+  }
+  g_free(buf);
+  g_free(comp_buf);
+  fclose(ifile);
+  fclose(ofile);
+}
+
+static void _assert_same_req(reader_t *reader, reader_t *reader_zstd,
+                             int64_t n_req) {
+  request_t *req = new_request();
+  request_t *req_zstd = new_request();
+  for (int64_t i = 0; n_req < 0 || i < n_req; i++) {
+    int ret = read_one_req(reader, req);
+    g_assert_true(read_one_req(reader_zstd, req_zstd) == ret);
+    if (ret != 0) break;
+    g_assert_true(req->clock_time == req_zstd->clock_time);
+    g_assert_true(req->obj_id == req_zstd->obj_id);
+    g_assert_true(req->obj_size == req_zstd->obj_size);
+    g_assert_true(req->next_access_vtime == req_zstd->next_access_vtime);
+  }
+  free_request(req);
+  free_request(req_zstd);
+}
+
+/* a zstd trace compressed in frames reads and seeks like the uncompressed
+ * trace, with and without the decoder threads, and with the frame index
+ * scanned from the frame headers or loaded from the .fidx sidecar */
+void test_reader_zstd_frames(gconstpointer user_data) {
+  const char *path = "test.oracleGeneral.bin.zst";
+  const char *index_path = "test.oracleGeneral.bin.zst.fidx";
+  char data_path[1024];
+  _detect_data_path(data_path, "cloudPhysicsIO.oracleGeneral.bin");
+  remove(index_path);
+  _compress_in_frames(data_path, path, 100000);
+
+  int n_threads[] = {0, 2, 0, 2};
+  for (int t = 0; t < 4; t++) {
+    set_zstd_reader_n_thread(n_threads[t]);
+    reader_t *reader = setup_reader(data_path, ORACLE_GENERAL_TRACE, NULL);
+    reader_t *reader_zstd = setup_reader(path, ORACLE_GENERAL_TRACE, NULL);
+    /* the first open scans the frames and saves the index */
+    g_assert_cmpint(access(index_path, F_OK), ==, 0);
+    g_assert_true(get_num_of_req(reader_zstd) == get_num_of_req(reader));
+    _assert_same_req(reader, reader_zstd, -1);
+
+    /* move both readers to a position in the middle of a frame */
+    uint64_t n_req = get_num_of_req(reader);
+    reset_reader(reader);
+    reset_reader(reader_zstd);
+    skip_n_req(reader, (int)(n_req / 3));
+    reader_pos_t pos;
+    reader_get_pos(reader, &pos);
+    reader_t *cloned_reader = clone_reader(reader_zstd);
+    g_assert_true(reader_set_pos(cloned_reader, &pos));
+    _assert_same_req(reader, cloned_reader, 10000);
+
+    /* a position beyond the end fails instead of aborting */
+    reader_pos_t bad_pos = pos;
+    bad_pos.offset = (int64_t)1 << 40;
+    g_assert_false(reader_set_pos(reader, &bad_pos));
+    g_assert_false(reader_set_pos(cloned_reader, &bad_pos));
+
+    /* seek backwards to another frame */
+    reader_set_read_pos(reader, 0.1);
+    reader_set_read_pos(cloned_reader, 0.1);
+    _assert_same_req(reader, cloned_reader, -1);
+
+    request_t *req = new_request();
+    request_t *req_zstd = new_request();
+    read_last_req(reader, req);
+    read_last_req(cloned_reader, req_zstd);
+    g_assert_true(req->obj_id == req_zstd->obj_id);
+    free_request(req);
+    free_request(req_zstd);
+
+    close_reader(cloned_reader);
+    close_reader(reader_zstd);
+    close_reader(reader);
+  }
+  set_zstd_reader_n_thread(0);
+  remove(path);
+  remove(index_path);
+}
+#endif
+
+/* read_n_req returns the same requests as read_one_req */
+static void _test_read_n_req(reader_t *reader, reader_t *reader_batch) {
+  request_t *req = new_request();
+  req_batch_t *batch = new_req_batch(1000);
+  uint64_t n_req = 0;
+  int n;
+  /* a batch size that does not divide the block or the trace */
+  while ((n = read_n_req(reader_batch, batch, 333)) > 0) {
+    g_assert_true(n == batch->n_req && n <= 333);
+    for (int i = 0; i < n; i++) {
+      g_assert_true(read_one_req(reader, req) == 0);
+      g_assert_true(req->clock_time == batch->clock_time[i]);
+      g_assert_true(req->obj_id == batch->obj_id[i]);
+      g_assert_true(req->obj_size == batch->obj_size[i]);
+      g_assert_true(req->next_access_vtime == batch->next_access_vtime[i]);
+    }
+    n_req += n;
+  }
+  g_assert_true(read_one_req(reader, req) == 1);
+  g_assert_true(n_req == get_num_of_req(reader));
+
+  /* read_one_req_from_batch continues from the position of the reader */
+  reset_reader(reader);
+  reset_reader(reader_batch);
+  read_one_req(reader, req);
+  read_one_req(reader_batch, req);
+  request_t *req_batch = new_request();
+  while (read_one_req(reader, req) == 0) {
+    g_assert_true(read_one_req_from_batch(reader_batch, batch, req_batch) == 0);
+    g_assert_true(req->obj_id == req_batch->obj_id);
+    g_assert_true(req->ttl == req_batch->ttl);
+  }
+  g_assert_true(read_one_req_from_batch(reader_batch, batch, req_batch) == 1);
+
+  close_reader(reader);
+  close_reader(reader_batch);
+  free_req_batch(batch);
+  free_request(req);
+  free_request(req_batch);
+}
+
+void test_reader_batch(gconstpointer user_data) {
+  _test_read_n_req(setup_oracleGeneralBin_reader(),
+                   setup_oracleGeneralBin_reader());
+  _test_read_n_req(setup_binary_reader(), setup_binary_reader());
+  /* read with read_one_req */
+  _test_read_n_req(setup_csv_reader_obj_num(), setup_csv_reader_obj_num());
+  _test_read_n_req(setup_vscsi_reader(), setup_vscsi_reader());
+}
+
+#ifdef SUPPORT_TTL
+/* a cache with default_ttl has the same misses whether the requests are
+ * read with read_one_req or through a batch */
+static uint64_t _n_miss_with_ttl(reader_t *reader, req_batch_t *batch) {
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE,
+                                     .default_ttl = 2400};
+  cache_t *cache = LRU_init(cc_params, NULL);
+  request_t *req = new_request();
+  uint64_t n_miss = 0;
+  while (read_one_req_from_batch(reader, batch, req) == 0) {
+    if (!cache->get(cache, req)) n_miss += 1;
+  }
+  cache->cache_free(cache);
+  free_request(req);
+  return n_miss;
+}
+
+void test_reader_batch_ttl(gconstpointer user_data) {
+  reader_t *reader = setup_oracleGeneralBin_reader();
+  reader_t *reader_batch = setup_oracleGeneralBin_reader();
+  g_assert_true(reader_batch_has_all_fields(reader_batch));
+  req_batch_t *batch = new_req_batch(1000);
+
+  uint64_t n_miss = _n_miss_with_ttl(reader, NULL);
+  uint64_t n_miss_batch = _n_miss_with_ttl(reader_batch, batch);
+  g_assert_cmpuint(n_miss, ==, n_miss_batch);
+  /* the objects do not expire at insertion */
+  g_assert_cmpuint(n_miss, <, get_num_of_req(reader));
+
+  close_reader(reader);
+  close_reader(reader_batch);
+  free_req_batch(batch);
+}
+#endif
+
+/* the txt and csv traces have the same object ids, a string object id is
+ * hashed to the same obj_id by both readers and by a cloned reader */
+void test_reader_str_obj_id(gconstpointer user_data) {
+  char data_path[1024];
+  _detect_data_path(data_path, "cloudPhysicsIO.txt");
+  reader_init_param_t init_params = {.obj_id_is_num = false,
+                                     .audit_str_obj_id = true};
+  reader_t *reader_txt =
+      setup_reader(data_path, PLAIN_TXT_TRACE, &init_params);
+  reader_t *reader_csv = setup_csv_reader_obj_str();
+  reader_t *reader_clone = clone_reader(reader_txt);
+  request_t *req = new_request();
+  request_t *req_csv = new_request();
+  request_t *req_clone = new_request();
+
+  uint64_t n_req = 0;
+  while (read_one_req(reader_txt, req) == 0) {
+    g_assert_true(read_one_req(reader_csv, req_csv) == 0);
+    g_assert_true(read_one_req(reader_clone, req_clone) == 0);
+    g_assert_true(req->obj_id == req_csv->obj_id);
+    g_assert_true(req->obj_id == req_clone->obj_id);
+    n_req++;
+  }
+  g_assert_true(n_req == get_num_of_req(reader_csv));
+  g_assert_true(reader_txt->str_obj_id_table != NULL);
+  g_assert_true(reader_txt->n_str_obj_id_collision == 0);
+  g_assert_true(reader_clone->n_str_obj_id_collision == 0);
+
+  close_reader(reader_txt);
+  close_reader(reader_csv);
+  close_reader(reader_clone);
+  free_request(req);
+  free_request(req_csv);
+  free_request(req_clone);
+}
+
 int main(int argc, char *argv[]) {
   g_test_init(&argc, &argv, NULL);
   reader_t *reader;
@@ -210,6 +589,24 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func_full("/libCacheSim/reader_more2_oracleGeneral", reader,
                             test_reader_more2, test_teardown);
 
+  g_test_add_data_func("/libCacheSim/reader_synthetic", NULL,
+                       test_reader_synthetic);
+  g_test_add_data_func("/libCacheSim/reader_columnar", NULL,
+                       test_reader_columnar);
+  g_test_add_data_func("/libCacheSim/reader_columnar_size_dict16", NULL,
+                       test_reader_columnar_size_dict16);
+  g_test_add_data_func("/libCacheSim/reader_batch", NULL, test_reader_batch);
+#ifdef SUPPORT_TTL
+  g_test_add_data_func("/libCacheSim/reader_batch_ttl", NULL,
+                       test_reader_batch_ttl);
+#endif
+#ifdef SUPPORT_ZSTD_TRACE
+  g_test_add_data_func("/libCacheSim/reader_zstd_frames", NULL,
+                       test_reader_zstd_frames);
+#endif
+  g_test_add_data_func("/libCacheSim/reader_str_obj_id", NULL,
+                       test_reader_str_obj_id);
+
   // g_test_add_data_func("/libCacheSim/test_twr", NULL, test_twr);
   return g_test_run();
 }
\ No newline at end of file